@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <perf_counters.hpp>
+
+namespace coal::bench {
+
+enum class output_format
+{
+    table,
+    csv,
+    json
+};
+
+struct options
+{
+    output_format format{output_format::table};
+    std::string filter{};
+    std::string output{};
+    std::size_t operations{20'000};
+    std::size_t repetitions{5};
+    std::uint64_t seed{0xC0A1};
+
+    // read hardware counters around the timed repetitions when perf_event_open allows it
+    bool perf{true};
+
+    // threaded scenarios run with 1, 2, 4... threads up to this count
+    std::size_t threads{std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 8)};
+
+    // measure the memory footprint of objects kept alive instead of the timings
+    bool footprint{false};
+    std::size_t objects{1'000'000};
+};
+
+struct measurement
+{
+    std::string allocator;
+    std::string scenario;
+    std::size_t operations{0};
+    std::size_t failures{0};
+    std::size_t repetitions{0};
+    std::size_t threads{1};
+    double median_ns_per_op{0.0};
+    double min_ns_per_op{0.0};
+    double max_ns_per_op{0.0};
+
+    // median wall time of the operations of one thread
+    double ops_per_second_per_thread{0.0};
+
+    // ops_per_second_per_thread relative to the run of the same scenario with the fewest threads
+    double scaling_efficiency{1.0};
+
+    // summed over the timed repetitions and divided by their operations, single-threaded scenarios only
+    perf_values perf_per_op{};
+};
+
+// scenarios return the number of allocator calls they made and count the calls that failed
+struct scenario_result
+{
+    std::size_t operations{0};
+    std::size_t failures{0};
+};
+
+struct threaded_result
+{
+    std::size_t operations{0};
+    std::size_t failures{0};
+    std::uint64_t elapsed_ns{0};
+};
+
+class runner
+{
+public:
+    explicit runner(const options& options);
+
+    [[nodiscard]] const options& get_options() const;
+    [[nodiscard]] const std::vector<measurement>& get_measurements() const;
+
+    [[nodiscard]] bool is_selected(std::string_view allocator_name, std::string_view scenario_name) const;
+
+    // the allocator instance is kept across repetitions so refills from the parent are amortized as they would be in a long-running process
+    template<typename AllocatorT, typename ScenarioT>
+    void run(std::string_view allocator_name, ScenarioT& scenario);
+
+    // AllocatorT must be thread-safe, a single instance is shared by every thread
+    template<typename AllocatorT, typename ScenarioT>
+    void run_threaded(std::string_view allocator_name, ScenarioT& scenario);
+
+    void report(std::FILE* file) const;
+
+private:
+    void report_table(std::FILE* file) const;
+    void report_csv(std::FILE* file) const;
+    void report_json(std::FILE* file) const;
+
+    options _options;
+    std::vector<measurement> _measurements;
+    perf_counters _perf;
+};
+
+inline runner::runner(const options& options)
+    : _options{options}
+{
+    if (_options.perf && !_perf.open())
+    {
+        std::fprintf(stderr, "hardware counters unavailable, see /proc/sys/kernel/perf_event_paranoid\n");
+    }
+}
+
+inline const options& runner::get_options() const
+{
+    return _options;
+}
+
+inline const std::vector<measurement>& runner::get_measurements() const
+{
+    return _measurements;
+}
+
+inline bool runner::is_selected(std::string_view allocator_name, std::string_view scenario_name) const
+{
+    if (_options.filter.empty())
+    {
+        return true;
+    }
+
+    const std::string name = std::string{allocator_name} + "/" + std::string{scenario_name};
+    return name.find(_options.filter) != std::string::npos;
+}
+
+template<typename AllocatorT, typename ScenarioT>
+void runner::run(std::string_view allocator_name, ScenarioT& scenario)
+{
+    if (!is_selected(allocator_name, ScenarioT::name))
+    {
+        return;
+    }
+
+    auto allocator = std::make_unique<AllocatorT>();
+
+    // warm up caches and let the allocator reach its steady state
+    scenario_result result = scenario.run(*allocator);
+
+    std::vector<double> samples;
+    samples.reserve(_options.repetitions);
+
+    perf_values perf_totals{};
+    std::size_t total_operations = 0;
+
+    for (std::size_t i = 0; i < _options.repetitions; ++i)
+    {
+        _perf.start();
+
+        const auto start = std::chrono::steady_clock::now();
+        result = scenario.run(*allocator);
+        const auto end = std::chrono::steady_clock::now();
+
+        _perf.stop();
+
+        const double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        samples.push_back(result.operations ? elapsed / static_cast<double>(result.operations) : 0.0);
+
+        const perf_values values = _perf.read();
+
+        for (std::size_t c = 0; c < perf_counter_count; ++c)
+        {
+            if (values[c])
+            {
+                perf_totals[c] = perf_totals[c].value_or(0.0) + *values[c];
+            }
+        }
+
+        total_operations += result.operations;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    measurement m;
+    m.allocator = allocator_name;
+    m.scenario = ScenarioT::name;
+    m.operations = result.operations;
+    m.failures = result.failures;
+    m.repetitions = samples.size();
+    m.median_ns_per_op = samples.empty() ? 0.0 : samples[samples.size() / 2];
+    m.min_ns_per_op = samples.empty() ? 0.0 : samples.front();
+    m.max_ns_per_op = samples.empty() ? 0.0 : samples.back();
+    m.ops_per_second_per_thread = m.median_ns_per_op > 0.0 ? 1e9 / m.median_ns_per_op : 0.0;
+
+    for (std::size_t c = 0; c < perf_counter_count; ++c)
+    {
+        if (perf_totals[c] && total_operations > 0)
+        {
+            m.perf_per_op[c] = *perf_totals[c] / static_cast<double>(total_operations);
+        }
+    }
+
+    _measurements.push_back(std::move(m));
+}
+
+template<typename AllocatorT, typename ScenarioT>
+void runner::run_threaded(std::string_view allocator_name, ScenarioT& scenario)
+{
+    if (!is_selected(allocator_name, ScenarioT::name))
+    {
+        return;
+    }
+
+    auto allocator = std::make_unique<AllocatorT>();
+
+    // powers of two, then the requested count rounded down to the thread step of the scenario
+    const std::size_t max_threads = std::max(_options.threads / ScenarioT::thread_step * ScenarioT::thread_step, ScenarioT::thread_step);
+    std::vector<std::size_t> thread_counts;
+
+    for (std::size_t threads = ScenarioT::thread_step; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+
+    thread_counts.push_back(max_threads);
+
+    double base_ops_per_second_per_thread = 0.0;
+
+    for (std::size_t threads : thread_counts)
+    {
+        // warm up
+        threaded_result result = scenario.run(*allocator, threads);
+
+        std::vector<double> samples;
+        samples.reserve(_options.repetitions);
+
+        for (std::size_t i = 0; i < _options.repetitions; ++i)
+        {
+            result = scenario.run(*allocator, threads);
+
+            // wall time of one operation as seen by one thread
+            samples.push_back(result.operations ? static_cast<double>(result.elapsed_ns) * static_cast<double>(threads) / static_cast<double>(result.operations) : 0.0);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        measurement m;
+        m.allocator = allocator_name;
+        m.scenario = ScenarioT::name;
+        m.operations = result.operations;
+        m.failures = result.failures;
+        m.repetitions = samples.size();
+        m.threads = threads;
+        m.median_ns_per_op = samples.empty() ? 0.0 : samples[samples.size() / 2];
+        m.min_ns_per_op = samples.empty() ? 0.0 : samples.front();
+        m.max_ns_per_op = samples.empty() ? 0.0 : samples.back();
+        m.ops_per_second_per_thread = m.median_ns_per_op > 0.0 ? 1e9 / m.median_ns_per_op : 0.0;
+
+        if (base_ops_per_second_per_thread == 0.0)
+        {
+            base_ops_per_second_per_thread = m.ops_per_second_per_thread;
+        }
+
+        m.scaling_efficiency = base_ops_per_second_per_thread > 0.0 ? m.ops_per_second_per_thread / base_ops_per_second_per_thread : 0.0;
+
+        _measurements.push_back(std::move(m));
+    }
+}
+
+inline void runner::report(std::FILE* file) const
+{
+    switch (_options.format)
+    {
+    case output_format::table: report_table(file); break;
+    case output_format::csv: report_csv(file); break;
+    case output_format::json: report_json(file); break;
+    }
+}
+
+inline void runner::report_table(std::FILE* file) const
+{
+    const bool perf = _perf.is_any_available();
+
+    std::fprintf(file, "%-28s %-22s %8s %12s %10s %12s %12s %12s %16s %10s", "allocator", "scenario", "threads", "operations", "failures", "median ns", "min ns", "max ns", "ops/s/thread", "scaling");
+
+    if (perf)
+    {
+        for (std::size_t c = 0; c < perf_counter_count; ++c)
+        {
+            std::fprintf(file, " %14s", perf_counters::get_name(static_cast<perf_counter>(c)));
+        }
+    }
+
+    std::fprintf(file, "\n");
+
+    for (const measurement& m : _measurements)
+    {
+        std::fprintf(file, "%-28s %-22s %8zu %12zu %10zu %12.2f %12.2f %12.2f %16.0f %10.3f", m.allocator.c_str(), m.scenario.c_str(), m.threads, m.operations, m.failures, m.median_ns_per_op, m.min_ns_per_op, m.max_ns_per_op, m.ops_per_second_per_thread, m.scaling_efficiency);
+
+        if (perf)
+        {
+            for (const std::optional<double>& value : m.perf_per_op)
+            {
+                if (value)
+                {
+                    std::fprintf(file, " %14.3f", *value);
+                }
+                else
+                {
+                    std::fprintf(file, " %14s", "-");
+                }
+            }
+        }
+
+        std::fprintf(file, "\n");
+    }
+}
+
+inline void runner::report_csv(std::FILE* file) const
+{
+    std::fprintf(file, "allocator,scenario,threads,operations,failures,repetitions,median_ns_per_op,min_ns_per_op,max_ns_per_op,ops_per_second_per_thread,scaling_efficiency");
+
+    for (std::size_t c = 0; c < perf_counter_count; ++c)
+    {
+        std::fprintf(file, ",%s_per_op", perf_counters::get_name(static_cast<perf_counter>(c)));
+    }
+
+    std::fprintf(file, "\n");
+
+    for (const measurement& m : _measurements)
+    {
+        std::fprintf(file, "%s,%s,%zu,%zu,%zu,%zu,%.3f,%.3f,%.3f,%.0f,%.4f", m.allocator.c_str(), m.scenario.c_str(), m.threads, m.operations, m.failures, m.repetitions, m.median_ns_per_op, m.min_ns_per_op, m.max_ns_per_op, m.ops_per_second_per_thread, m.scaling_efficiency);
+
+        // unavailable counters are left empty
+        for (const std::optional<double>& value : m.perf_per_op)
+        {
+            if (value)
+            {
+                std::fprintf(file, ",%.4f", *value);
+            }
+            else
+            {
+                std::fprintf(file, ",");
+            }
+        }
+
+        std::fprintf(file, "\n");
+    }
+}
+
+inline void runner::report_json(std::FILE* file) const
+{
+    std::fprintf(file, "{\n  \"seed\": %llu,\n  \"results\": [", static_cast<unsigned long long>(_options.seed));
+
+    for (std::size_t i = 0; i < _measurements.size(); ++i)
+    {
+        const measurement& m = _measurements[i];
+
+        std::fprintf(file, "%s\n    {\"allocator\": \"%s\", \"scenario\": \"%s\", \"threads\": %zu, \"operations\": %zu, \"failures\": %zu, \"repetitions\": %zu, \"median_ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"max_ns_per_op\": %.3f, \"ops_per_second_per_thread\": %.0f, \"scaling_efficiency\": %.4f", i ? "," : "", m.allocator.c_str(), m.scenario.c_str(), m.threads, m.operations, m.failures, m.repetitions, m.median_ns_per_op, m.min_ns_per_op, m.max_ns_per_op, m.ops_per_second_per_thread, m.scaling_efficiency);
+
+        for (std::size_t c = 0; c < perf_counter_count; ++c)
+        {
+            const std::optional<double>& value = m.perf_per_op[c];
+
+            if (value)
+            {
+                std::fprintf(file, ", \"%s_per_op\": %.4f", perf_counters::get_name(static_cast<perf_counter>(c)), *value);
+            }
+            else
+            {
+                std::fprintf(file, ", \"%s_per_op\": null", perf_counters::get_name(static_cast<perf_counter>(c)));
+            }
+        }
+
+        std::fprintf(file, "}");
+    }
+
+    std::fprintf(file, "\n  ]\n}\n");
+}
+
+} // namespace coal::bench
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <coal/malloc_allocator.hpp>
+#include <coal/memory_block.hpp>
+#include <coal/stats_allocator.hpp>
+
+#include <bench.hpp>
+#include <scenarios.hpp>
+
+namespace coal::bench {
+
+// every composition of the footprint benchmark gets its memory from this leaf, a composition may hold several
+using footprint_leaf = stats_allocator<malloc_allocator, stats_options::live_bytes | stats_options::peak_live_bytes, 1>;
+
+struct footprint_distribution
+{
+    const char* name;
+    size_range range;
+};
+
+inline constexpr footprint_distribution footprint_distributions[] = {
+    {"small", {8, 64}},
+    {"mixed", {8, 1024}},
+    {"large", {256, 4096}},
+};
+
+struct footprint_measurement
+{
+    std::string allocator;
+    std::string distribution;
+    std::size_t objects{0};
+    std::size_t failures{0};
+
+    std::uint64_t requested_bytes{0};
+
+    // live bytes of every leaf while all the objects are alive
+    std::uint64_t leaf_bytes{0};
+
+    // resident set growth while all the objects are alive, -1 when /proc/self/statm cannot be read
+    std::int64_t rss_bytes{-1};
+
+    [[nodiscard]] double get_leaf_overhead_per_object() const;
+    [[nodiscard]] double get_rss_per_object() const;
+};
+
+inline double footprint_measurement::get_leaf_overhead_per_object() const
+{
+    return objects ? (static_cast<double>(leaf_bytes) - static_cast<double>(requested_bytes)) / static_cast<double>(objects) : 0.0;
+}
+
+inline double footprint_measurement::get_rss_per_object() const
+{
+    return objects && rss_bytes >= 0 ? static_cast<double>(rss_bytes) / static_cast<double>(objects) : 0.0;
+}
+
+// resident set size in bytes, -1 when unavailable
+inline std::int64_t read_rss_bytes()
+{
+#if defined(__linux__)
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+
+    if (file == nullptr)
+    {
+        return -1;
+    }
+
+    unsigned long long size_pages = 0;
+    unsigned long long resident_pages = 0;
+    const int read = std::fscanf(file, "%llu %llu", &size_pages, &resident_pages);
+
+    std::fclose(file);
+
+    return read == 2 ? static_cast<std::int64_t>(resident_pages) * static_cast<std::int64_t>(sysconf(_SC_PAGESIZE)) : -1;
+#else
+    return -1;
+#endif
+}
+
+// Initializer summing the live bytes of every footprint_leaf of a composition.
+struct footprint_collector
+{
+    template<typename AllocatorT>
+    void init(AllocatorT& allocator)
+    {
+        if constexpr (std::is_same_v<AllocatorT, footprint_leaf>)
+        {
+            leaf_bytes += static_cast<std::uint64_t>(allocator.get_stats().live_bytes);
+        }
+    }
+
+    std::uint64_t leaf_bytes{0};
+};
+
+template<typename AllocatorT>
+footprint_measurement measure_footprint(std::size_t object_count, size_range range, std::uint64_t seed)
+{
+    const std::vector<std::size_t> sizes = make_sizes(object_count, range.min_size, range.max_size, seed);
+
+    // resized rather than reserved so the pages of the vector are resident before the first read of the resident set
+    std::vector<memory_block> blocks(sizes.size());
+
+    auto allocator = std::make_unique<AllocatorT>();
+
+    footprint_measurement m;
+    m.objects = sizes.size();
+
+    const std::int64_t rss_before = read_rss_bytes();
+
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        const std::size_t size = sizes[i];
+        memory_block& block = blocks[i];
+
+        block = allocator->allocate(size);
+
+        // touch every page so the resident set reflects the layout
+        for (std::size_t offset = 0; block && offset < block.size; offset += 4096)
+        {
+            block.as<volatile std::uint8_t>()[offset] = 1;
+        }
+
+        m.requested_bytes += size;
+        m.failures += block ? 0 : 1;
+    }
+
+    const std::int64_t rss_after = read_rss_bytes();
+
+    footprint_collector collector;
+    allocator->init(collector);
+
+    m.leaf_bytes = collector.leaf_bytes;
+    m.rss_bytes = rss_before >= 0 && rss_after >= 0 ? rss_after - rss_before : -1;
+
+    for (memory_block& block : blocks)
+    {
+        if (block)
+        {
+            allocator->deallocate(block);
+        }
+    }
+
+    return m;
+}
+
+// On linux each measurement runs in a child process so memory kept by previous compositions does not hide the
+// growth of the resident set.
+template<typename AllocatorT>
+footprint_measurement run_footprint_isolated(std::size_t object_count, size_range range, std::uint64_t seed)
+{
+#if defined(__linux__)
+    int fds[2];
+
+    if (pipe(fds) == 0)
+    {
+        const pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            close(fds[0]);
+
+            const footprint_measurement m = measure_footprint<AllocatorT>(object_count, range, seed);
+            const std::uint64_t values[] = {m.objects, m.failures, m.requested_bytes, m.leaf_bytes, static_cast<std::uint64_t>(m.rss_bytes)};
+
+            const bool written = write(fds[1], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values));
+            _exit(written ? 0 : 1);
+        }
+
+        close(fds[1]);
+
+        std::uint64_t values[5]{};
+        const bool read_all = pid > 0 && read(fds[0], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values));
+
+        close(fds[0]);
+
+        if (pid > 0)
+        {
+            waitpid(pid, nullptr, 0);
+        }
+
+        if (read_all)
+        {
+            footprint_measurement m;
+            m.objects = values[0];
+            m.failures = values[1];
+            m.requested_bytes = values[2];
+            m.leaf_bytes = values[3];
+            m.rss_bytes = static_cast<std::int64_t>(values[4]);
+            return m;
+        }
+    }
+#endif
+
+    return measure_footprint<AllocatorT>(object_count, range, seed);
+}
+
+class footprint_runner
+{
+public:
+    explicit footprint_runner(const options& options);
+
+    template<typename AllocatorT>
+    void run(std::string_view allocator_name, size_range range = {1, ~std::size_t{0}});
+
+    void report(std::FILE* file) const;
+
+private:
+    options _options;
+    std::vector<footprint_measurement> _measurements;
+};
+
+inline footprint_runner::footprint_runner(const options& options)
+    : _options{options}
+{
+}
+
+template<typename AllocatorT>
+void footprint_runner::run(std::string_view allocator_name, size_range range)
+{
+    for (const footprint_distribution& distribution : footprint_distributions)
+    {
+        // skip distributions the composition cannot serve, e.g. sizes above the largest slab
+        if (distribution.range.min_size < range.min_size || distribution.range.max_size > range.max_size)
+        {
+            continue;
+        }
+
+        if (!_options.filter.empty() && (std::string{allocator_name} + "/" + distribution.name).find(_options.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        footprint_measurement m = run_footprint_isolated<AllocatorT>(_options.objects, distribution.range, _options.seed);
+        m.allocator = allocator_name;
+        m.distribution = distribution.name;
+
+        _measurements.push_back(std::move(m));
+    }
+}
+
+inline void footprint_runner::report(std::FILE* file) const
+{
+    switch (_options.format)
+    {
+    case output_format::table:
+        std::fprintf(file, "%-28s %-8s %10s %8s %16s %16s %16s %14s %14s\n", "allocator", "sizes", "objects", "failures", "requested", "leaf granted", "rss growth", "leaf ovh/obj", "rss/obj");
+        break;
+
+    case output_format::csv:
+        std::fprintf(file, "allocator,distribution,objects,failures,requested_bytes,leaf_bytes,rss_bytes,leaf_overhead_per_object,rss_per_object\n");
+        break;
+
+    case output_format::json:
+        std::fprintf(file, "{\n  \"seed\": %llu,\n  \"footprint\": [", static_cast<unsigned long long>(_options.seed));
+        break;
+    }
+
+    for (std::size_t i = 0; i < _measurements.size(); ++i)
+    {
+        const footprint_measurement& m = _measurements[i];
+        const unsigned long long requested = m.requested_bytes;
+        const unsigned long long leaf = m.leaf_bytes;
+        const long long rss = m.rss_bytes;
+
+        switch (_options.format)
+        {
+        case output_format::table:
+            std::fprintf(file, "%-28s %-8s %10zu %8zu %16llu %16llu %16lld %14.2f %14.2f\n", m.allocator.c_str(), m.distribution.c_str(), m.objects, m.failures, requested, leaf, rss, m.get_leaf_overhead_per_object(), m.get_rss_per_object());
+            break;
+
+        case output_format::csv:
+            std::fprintf(file, "%s,%s,%zu,%zu,%llu,%llu,%lld,%.3f,%.3f\n", m.allocator.c_str(), m.distribution.c_str(), m.objects, m.failures, requested, leaf, rss, m.get_leaf_overhead_per_object(), m.get_rss_per_object());
+            break;
+
+        case output_format::json:
+            std::fprintf(file, "%s\n    {\"allocator\": \"%s\", \"distribution\": \"%s\", \"objects\": %zu, \"failures\": %zu, \"requested_bytes\": %llu, \"leaf_bytes\": %llu, \"rss_bytes\": %lld, \"leaf_overhead_per_object\": %.3f, \"rss_per_object\": %.3f}", i ? "," : "", m.allocator.c_str(), m.distribution.c_str(), m.objects, m.failures, requested, leaf, rss, m.get_leaf_overhead_per_object(), m.get_rss_per_object());
+            break;
+        }
+    }
+
+    if (_options.format == output_format::json)
+    {
+        std::fprintf(file, "\n  ]\n}\n");
+    }
+}
+
+} // namespace coal::bench
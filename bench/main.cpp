@@ -0,0 +1,349 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#include <coal/affix/memory_corruption_detector.hpp>
+#include <coal/affix_allocator.hpp>
+#include <coal/allocator_traits.hpp>
+#include <coal/bitmapped_block.hpp>
+#include <coal/bucket_policy/geometric.hpp>
+#include <coal/buddy_allocator.hpp>
+#include <coal/bucketizer.hpp>
+#include <coal/cascading_allocator.hpp>
+#include <coal/coalescing_free_list_allocator.hpp>
+#include <coal/concurrent_slab_allocator.hpp>
+#include <coal/fallback_allocator.hpp>
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/best_fit.hpp>
+#include <coal/free_list_strategy/exact_fit.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/free_list_strategy/limited_size.hpp>
+#include <coal/free_list_strategy/segregated_fit.hpp>
+#include <coal/lock_policy/adaptive_lock.hpp>
+#include <coal/lock_policy/mutex.hpp>
+#include <coal/lock_policy/ticket_lock.hpp>
+#include <coal/lock_policy/ttas_spinlock.hpp>
+#include <coal/locked_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/mmap_allocator.hpp>
+#include <coal/per_cpu_allocator.hpp>
+#include <coal/prefixed_size_allocator.hpp>
+#include <coal/region_allocator.hpp>
+#include <coal/segregator_allocator.hpp>
+#include <coal/slab_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
+#include <coal/thread_cache_allocator.hpp>
+#include <coal/tlsf_allocator.hpp>
+
+#include <bench.hpp>
+#include <footprint.hpp>
+#include <scenarios.hpp>
+#include <threaded_scenarios.hpp>
+
+namespace coal::bench {
+
+namespace allocators {
+
+using corruption_detector = memory_corruption_detector<std::uint32_t, 0xDEADDEAD>;
+
+constexpr std::size_t affixed_size(std::size_t s)
+{
+    return sizeof(corruption_detector) + s;
+}
+
+// compositions taking their memory from LeafT, malloc_allocator or a footprint_leaf
+template<typename LeafT>
+using slab_over = slab_allocator<LeafT, 0x10000, 16, 32, 64, 128, 256, 512, 1024>;
+
+template<typename LeafT>
+using large_over = free_list_allocator<prefixed_size_allocator<LeafT>, free_list_strategy::limited_size<free_list_strategy::best_fit, 64>>;
+
+template<typename LeafT>
+using segregator_over = segregator_allocator<slab_over<LeafT>, large_over<LeafT>, 1024>;
+
+// the composite from the README
+template<typename LeafT>
+using readme_over = affix_allocator<
+    segregator_allocator<
+        slab_allocator<LeafT, 0x1000 * 2, affixed_size(8), affixed_size(16), affixed_size(32), affixed_size(64), affixed_size(128), affixed_size(512), affixed_size(1024)>,
+        large_over<LeafT>,
+        1024>,
+    corruption_detector,
+    corruption_detector>;
+
+using malloc_t = malloc_allocator;
+using mmap_t = mmap_allocator<>;
+using stack_t = stack_allocator<0x100000>;
+using slab_t = slab_over<malloc_allocator>;
+using region_t = region_allocator<malloc_allocator, 0x10000, 0x100000>;
+using bitmapped_block_t = bitmapped_block<malloc_allocator, 16, 0x10000>;
+using buddy_t = buddy_allocator<malloc_allocator, 12, 26>;
+using cascading_bitmapped_block_t = cascading_allocator<bitmapped_block<malloc_allocator, 16, 0x1000>>;
+using bucketizer_t = bucketizer<free_list_allocator<malloc_allocator, free_list_strategy::first_fit>, bucket_policy::geometric<32, 1024, 4>>;
+
+using free_list_first_fit_t = free_list_allocator<malloc_allocator, free_list_strategy::first_fit>;
+using free_list_best_fit_t = free_list_allocator<malloc_allocator, free_list_strategy::best_fit>;
+using free_list_exact_fit_t = free_list_allocator<malloc_allocator, free_list_strategy::exact_fit>;
+using free_list_limited_t = free_list_allocator<malloc_allocator, free_list_strategy::limited_size<free_list_strategy::best_fit, 64>>;
+using free_list_segregated_t = free_list_allocator<malloc_allocator, free_list_strategy::segregated_fit<64>>;
+using tlsf_t = tlsf_allocator<malloc_allocator, 0x4000000>;
+using coalescing_free_list_t = coalescing_free_list_allocator<malloc_allocator, 0x100000>;
+
+using fallback_t = fallback_allocator<stack_allocator<0x10000>, malloc_allocator>;
+
+using segregator_t = segregator_over<malloc_allocator>;
+using readme_t = readme_over<malloc_allocator>;
+
+// thread-safe compositions for the threaded scenarios
+using stats_malloc_t = stats_allocator<malloc_allocator>;
+using mutex_slab_t = locked_allocator<slab_t, lock_policy::mutex>;
+using ttas_slab_t = locked_allocator<slab_t, lock_policy::ttas_spinlock<>>;
+using ticket_slab_t = locked_allocator<slab_t, lock_policy::ticket_lock<>>;
+using adaptive_slab_t = locked_allocator<slab_t, lock_policy::adaptive_lock<>>;
+using concurrent_slab_t = concurrent_slab_allocator<malloc_allocator, 0x10000, 16, 32, 64, 128, 256, 512, 1024>;
+using mutex_segregator_t = locked_allocator<segregator_t, lock_policy::mutex>;
+using per_cpu_bitmapped_block_t = per_cpu_allocator<bitmapped_block_t>;
+using thread_cache_segregator_t = thread_cache_allocator<segregator_t, bucket_policy::geometric<32, 1024, 2>>;
+
+} // namespace allocators
+
+template<typename AllocatorT>
+void run_scenarios(runner& runner, std::string_view name, size_range range)
+{
+    const options& options = runner.get_options();
+
+    {
+        alloc_dealloc_scenario scenario{options, range};
+        runner.run<AllocatorT>(name, scenario);
+    }
+
+    {
+        lifo_churn_scenario scenario{options, range};
+        runner.run<AllocatorT>(name, scenario);
+    }
+
+    {
+        fifo_churn_scenario scenario{options, range};
+        runner.run<AllocatorT>(name, scenario);
+    }
+
+    {
+        random_churn_scenario scenario{options, range};
+        runner.run<AllocatorT>(name, scenario);
+    }
+
+    {
+        reallocate_growth_scenario scenario{options, range};
+        runner.run<AllocatorT>(name, scenario);
+    }
+
+    if constexpr (allocator_traits::has_expand<AllocatorT>)
+    {
+        expand_loop_scenario scenario{options, {range.min_size, std::min<std::size_t>(range.max_size, 512)}};
+        runner.run<AllocatorT>(name, scenario);
+    }
+}
+
+template<typename AllocatorT>
+void run_threaded_scenarios(runner& runner, std::string_view name, size_range range)
+{
+    const options& options = runner.get_options();
+
+    {
+        thread_local_churn_scenario scenario{options, range};
+        runner.run_threaded<AllocatorT>(name, scenario);
+    }
+
+    {
+        producer_consumer_scenario scenario{options, range};
+        runner.run_threaded<AllocatorT>(name, scenario);
+    }
+
+    {
+        shared_pool_scenario scenario{options, range};
+        runner.run_threaded<AllocatorT>(name, scenario);
+    }
+}
+
+void run_footprint(footprint_runner& runner)
+{
+    using namespace allocators;
+
+    runner.run<footprint_leaf>("malloc");
+    runner.run<prefixed_size_allocator<footprint_leaf>>("prefixed_size");
+    runner.run<affix_allocator<footprint_leaf, corruption_detector, corruption_detector>>("affix_corruption_detector");
+    runner.run<slab_over<footprint_leaf>>("slab", {1, slab_t::max_size});
+    runner.run<free_list_allocator<footprint_leaf, free_list_strategy::best_fit>>("free_list_best_fit");
+    runner.run<large_over<footprint_leaf>>("free_list_prefixed_size");
+    runner.run<coalescing_free_list_allocator<footprint_leaf, 0x10000>>("coalescing_free_list");
+    runner.run<segregator_over<footprint_leaf>>("segregator_slab_free_list");
+    runner.run<readme_over<footprint_leaf>>("readme_composite");
+}
+
+void run_all(runner& runner)
+{
+    using namespace allocators;
+
+    run_scenarios<malloc_t>(runner, "malloc", {});
+    run_scenarios<malloc_t>(runner, "malloc_large", {0x1000, 0x40000});
+    run_scenarios<mmap_t>(runner, "mmap", {0x1000, 0x40000});
+    run_scenarios<buddy_t>(runner, "buddy", {0x1000, 0x40000});
+    run_scenarios<stack_t>(runner, "stack", {});
+    run_scenarios<slab_t>(runner, "slab", {8, slab_t::max_size});
+    run_scenarios<region_t>(runner, "region", {8, 256});
+    run_scenarios<bitmapped_block_t>(runner, "bitmapped_block", {8, 256});
+    run_scenarios<cascading_bitmapped_block_t>(runner, "cascading_bitmapped_block", {8, 256});
+    run_scenarios<bucketizer_t>(runner, "bucketizer_geometric", {8, bucketizer_t::max_size});
+    run_scenarios<free_list_first_fit_t>(runner, "free_list_first_fit", {});
+    run_scenarios<free_list_best_fit_t>(runner, "free_list_best_fit", {});
+    run_scenarios<free_list_exact_fit_t>(runner, "free_list_exact_fit", {});
+    run_scenarios<free_list_limited_t>(runner, "free_list_limited_best_fit", {});
+    run_scenarios<free_list_segregated_t>(runner, "free_list_segregated_fit", {});
+    run_scenarios<tlsf_t>(runner, "tlsf", {});
+    run_scenarios<coalescing_free_list_t>(runner, "coalescing_free_list", {});
+    run_scenarios<fallback_t>(runner, "fallback_stack_malloc", {});
+    run_scenarios<segregator_t>(runner, "segregator_slab_free_list", {});
+    run_scenarios<readme_t>(runner, "readme_composite", {});
+
+    run_threaded_scenarios<malloc_t>(runner, "malloc", {});
+    run_threaded_scenarios<stats_malloc_t>(runner, "stats_malloc", {});
+    run_threaded_scenarios<mutex_slab_t>(runner, "mutex_slab", {8, slab_t::max_size});
+    run_threaded_scenarios<ttas_slab_t>(runner, "ttas_slab", {8, slab_t::max_size});
+    run_threaded_scenarios<ticket_slab_t>(runner, "ticket_slab", {8, slab_t::max_size});
+    run_threaded_scenarios<adaptive_slab_t>(runner, "adaptive_slab", {8, slab_t::max_size});
+    run_threaded_scenarios<concurrent_slab_t>(runner, "concurrent_slab", {8, concurrent_slab_t::max_size});
+    run_threaded_scenarios<mutex_segregator_t>(runner, "mutex_segregator", {});
+    run_threaded_scenarios<thread_cache_segregator_t>(runner, "thread_cache_segregator", {});
+    run_threaded_scenarios<per_cpu_bitmapped_block_t>(runner, "per_cpu_bitmapped_block", {8, 256});
+}
+
+bool parse_option(options& options, std::string_view arg)
+{
+    const auto value_of = [arg](std::string_view key) -> const char* {
+        return arg.starts_with(key) ? arg.data() + key.size() : nullptr;
+    };
+
+    if (const char* value = value_of("--format="))
+    {
+        const std::string_view format{value};
+
+        if (format == "table") options.format = output_format::table;
+        else if (format == "csv") options.format = output_format::csv;
+        else if (format == "json") options.format = output_format::json;
+        else return false;
+
+        return true;
+    }
+
+    if (const char* value = value_of("--filter="))
+    {
+        options.filter = value;
+        return true;
+    }
+
+    if (const char* value = value_of("--output="))
+    {
+        options.output = value;
+        return true;
+    }
+
+    if (const char* value = value_of("--operations="))
+    {
+        options.operations = std::strtoull(value, nullptr, 10);
+        return options.operations > 0;
+    }
+
+    if (const char* value = value_of("--repetitions="))
+    {
+        options.repetitions = std::strtoull(value, nullptr, 10);
+        return options.repetitions > 0;
+    }
+
+    if (arg == "--no-perf")
+    {
+        options.perf = false;
+        return true;
+    }
+
+    if (const char* value = value_of("--threads="))
+    {
+        options.threads = std::strtoull(value, nullptr, 10);
+        return options.threads > 0;
+    }
+
+    if (arg == "--footprint")
+    {
+        options.footprint = true;
+        return true;
+    }
+
+    if (const char* value = value_of("--objects="))
+    {
+        options.objects = std::strtoull(value, nullptr, 10);
+        return options.objects > 0;
+    }
+
+    if (const char* value = value_of("--seed="))
+    {
+        options.seed = std::strtoull(value, nullptr, 0);
+        return true;
+    }
+
+    return false;
+}
+
+void print_usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--format=table|csv|json] [--filter=allocator/scenario] [--output=file]\n"
+                 "          [--operations=N] [--repetitions=N] [--seed=N] [--threads=N] [--no-perf]\n"
+                 "       %s --footprint [--format=table|csv|json] [--filter=allocator/sizes] [--output=file] [--objects=N]\n",
+                 program,
+                 program);
+}
+
+} // namespace coal::bench
+
+int main(int argc, char** argv)
+{
+    coal::bench::options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!coal::bench::parse_option(options, argv[i]))
+        {
+            coal::bench::print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::FILE* file = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "w");
+
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "cannot open %s\n", options.output.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (options.footprint)
+    {
+        coal::bench::footprint_runner runner{options};
+        coal::bench::run_footprint(runner);
+        runner.report(file);
+    }
+    else
+    {
+        coal::bench::runner runner{options};
+        coal::bench::run_all(runner);
+        runner.report(file);
+    }
+
+    if (file != stdout)
+    {
+        std::fclose(file);
+    }
+
+    return EXIT_SUCCESS;
+}
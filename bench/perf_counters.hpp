@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace coal::bench {
+
+enum class perf_counter : std::size_t
+{
+    cycles,
+    instructions,
+    l1d_misses,
+    llc_misses,
+    dtlb_misses,
+
+    count
+};
+
+inline constexpr std::size_t perf_counter_count = static_cast<std::size_t>(perf_counter::count);
+
+using perf_values = std::array<std::optional<double>, perf_counter_count>;
+
+// Hardware counters of the calling thread read with perf_event_open. Counters the kernel or the PMU refuses
+// (perf_event_paranoid, containers, virtual machines) are left closed and read as std::nullopt.
+class perf_counters
+{
+public:
+    perf_counters() = default;
+    ~perf_counters();
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    [[nodiscard]] static constexpr const char* get_name(perf_counter counter);
+
+    // returns false when no counter could be opened
+    bool open();
+    void close();
+
+    [[nodiscard]] bool is_available(perf_counter counter) const;
+    [[nodiscard]] bool is_any_available() const;
+
+    void start();
+    void stop();
+
+    // counts since the last start, scaled when the kernel multiplexed the counters
+    [[nodiscard]] perf_values read() const;
+
+private:
+    std::array<int, perf_counter_count> _fds{-1, -1, -1, -1, -1};
+};
+
+inline perf_counters::~perf_counters()
+{
+    close();
+}
+
+constexpr const char* perf_counters::get_name(perf_counter counter)
+{
+    switch (counter)
+    {
+    case perf_counter::cycles: return "cycles";
+    case perf_counter::instructions: return "instructions";
+    case perf_counter::l1d_misses: return "l1d_misses";
+    case perf_counter::llc_misses: return "llc_misses";
+    case perf_counter::dtlb_misses: return "dtlb_misses";
+    case perf_counter::count: break;
+    }
+
+    return "";
+}
+
+#if defined(__linux__)
+
+namespace details {
+
+constexpr std::uint64_t perf_cache_miss_config(std::uint64_t cache)
+{
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+inline int open_perf_event(std::uint32_t type, std::uint64_t config)
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace details
+
+inline bool perf_counters::open()
+{
+    close();
+
+    _fds[static_cast<std::size_t>(perf_counter::cycles)] = details::open_perf_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    _fds[static_cast<std::size_t>(perf_counter::instructions)] = details::open_perf_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    _fds[static_cast<std::size_t>(perf_counter::l1d_misses)] = details::open_perf_event(PERF_TYPE_HW_CACHE, details::perf_cache_miss_config(PERF_COUNT_HW_CACHE_L1D));
+    _fds[static_cast<std::size_t>(perf_counter::llc_misses)] = details::open_perf_event(PERF_TYPE_HW_CACHE, details::perf_cache_miss_config(PERF_COUNT_HW_CACHE_LL));
+    _fds[static_cast<std::size_t>(perf_counter::dtlb_misses)] = details::open_perf_event(PERF_TYPE_HW_CACHE, details::perf_cache_miss_config(PERF_COUNT_HW_CACHE_DTLB));
+
+    return is_any_available();
+}
+
+inline void perf_counters::close()
+{
+    for (int& fd : _fds)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+inline void perf_counters::start()
+{
+    for (int fd : _fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+inline void perf_counters::stop()
+{
+    for (int fd : _fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+inline perf_values perf_counters::read() const
+{
+    perf_values values{};
+
+    for (std::size_t i = 0; i < perf_counter_count; ++i)
+    {
+        // value, time enabled, time running
+        std::array<std::uint64_t, 3> data{};
+
+        if (_fds[i] < 0 || ::read(_fds[i], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+        {
+            continue;
+        }
+
+        values[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+    }
+
+    return values;
+}
+
+#else
+
+inline bool perf_counters::open()
+{
+    return false;
+}
+
+inline void perf_counters::close()
+{
+}
+
+inline void perf_counters::start()
+{
+}
+
+inline void perf_counters::stop()
+{
+}
+
+inline perf_values perf_counters::read() const
+{
+    return {};
+}
+
+#endif
+
+inline bool perf_counters::is_available(perf_counter counter) const
+{
+    return _fds[static_cast<std::size_t>(counter)] >= 0;
+}
+
+inline bool perf_counters::is_any_available() const
+{
+    for (int fd : _fds)
+    {
+        if (fd >= 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace coal::bench
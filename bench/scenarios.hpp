@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/memory_block.hpp>
+
+#include <bench.hpp>
+
+namespace coal::bench {
+
+// log-uniform sizes between min_size and max_size, small sizes dominate like in most real workloads
+inline std::vector<std::size_t> make_sizes(std::size_t count, std::size_t min_size, std::size_t max_size, std::uint64_t seed)
+{
+    std::mt19937_64 rng{seed};
+    std::uniform_real_distribution<double> distribution{std::log2(static_cast<double>(min_size)), std::log2(static_cast<double>(max_size))};
+
+    std::vector<std::size_t> sizes(count);
+
+    for (std::size_t& size : sizes)
+    {
+        size = std::clamp(static_cast<std::size_t>(std::exp2(distribution(rng))), min_size, max_size);
+    }
+
+    return sizes;
+}
+
+inline void touch(const memory_block& block)
+{
+    if (block)
+    {
+        *block.as<volatile std::uint8_t>() = 1;
+    }
+}
+
+struct size_range
+{
+    std::size_t min_size{8};
+    std::size_t max_size{4096};
+};
+
+// allocate and immediately deallocate, best case for every allocator
+struct alloc_dealloc_scenario
+{
+    static constexpr const char* name = "alloc_dealloc";
+
+    alloc_dealloc_scenario(const options& options, size_range range)
+        : sizes{make_sizes(options.operations, range.min_size, range.max_size, options.seed)}
+    {
+    }
+
+    template<typename AllocatorT>
+    scenario_result run(AllocatorT& allocator)
+    {
+        scenario_result result;
+
+        for (std::size_t size : sizes)
+        {
+            memory_block block = allocator.allocate(size);
+            touch(block);
+
+            result.failures += block ? 0 : 1;
+
+            allocator.deallocate(block);
+            result.operations += 2;
+        }
+
+        return result;
+    }
+
+    std::vector<std::size_t> sizes;
+};
+
+// allocate a batch then free it, in reverse order (LIFO) or in allocation order (FIFO)
+template<bool ReverseT>
+struct batch_churn_scenario
+{
+    static constexpr const char* name = ReverseT ? "lifo_churn" : "fifo_churn";
+    static constexpr std::size_t batch_size = 64;
+
+    batch_churn_scenario(const options& options, size_range range)
+        : sizes{make_sizes(options.operations, range.min_size, range.max_size, options.seed)}
+    {
+        blocks.reserve(batch_size);
+    }
+
+    template<typename AllocatorT>
+    scenario_result run(AllocatorT& allocator)
+    {
+        scenario_result result;
+
+        for (std::size_t i = 0; i < sizes.size(); i += batch_size)
+        {
+            const std::size_t end = std::min(i + batch_size, sizes.size());
+
+            for (std::size_t j = i; j < end; ++j)
+            {
+                memory_block& block = blocks.emplace_back(allocator.allocate(sizes[j]));
+                touch(block);
+
+                result.failures += block ? 0 : 1;
+                ++result.operations;
+            }
+
+            if constexpr (ReverseT)
+            {
+                for (auto it = blocks.rbegin(); it != blocks.rend(); ++it)
+                {
+                    allocator.deallocate(*it);
+                    ++result.operations;
+                }
+            }
+            else
+            {
+                for (memory_block& block : blocks)
+                {
+                    allocator.deallocate(block);
+                    ++result.operations;
+                }
+            }
+
+            blocks.clear();
+        }
+
+        return result;
+    }
+
+    std::vector<std::size_t> sizes;
+    std::vector<memory_block> blocks;
+};
+
+using lifo_churn_scenario = batch_churn_scenario<true>;
+using fifo_churn_scenario = batch_churn_scenario<false>;
+
+// random frees and allocations over a bounded live set
+struct random_churn_scenario
+{
+    static constexpr const char* name = "random_churn";
+    static constexpr std::size_t live_set_size = 1024;
+
+    random_churn_scenario(const options& options, size_range range)
+        : sizes{make_sizes(options.operations, range.min_size, range.max_size, options.seed)}
+        , slots(options.operations)
+        , blocks(live_set_size)
+    {
+        std::mt19937_64 rng{options.seed ^ 0x5EED};
+        std::uniform_int_distribution<std::size_t> distribution{0, live_set_size - 1};
+
+        for (std::size_t& slot : slots)
+        {
+            slot = distribution(rng);
+        }
+    }
+
+    template<typename AllocatorT>
+    scenario_result run(AllocatorT& allocator)
+    {
+        scenario_result result;
+
+        for (std::size_t i = 0; i < sizes.size(); ++i)
+        {
+            memory_block& block = blocks[slots[i]];
+
+            if (block)
+            {
+                allocator.deallocate(block);
+                block = nullblk;
+            }
+            else
+            {
+                block = allocator.allocate(sizes[i]);
+                touch(block);
+
+                result.failures += block ? 0 : 1;
+            }
+
+            ++result.operations;
+        }
+
+        for (memory_block& block : blocks)
+        {
+            if (block)
+            {
+                allocator.deallocate(block);
+                block = nullblk;
+                ++result.operations;
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<std::size_t> sizes;
+    std::vector<std::size_t> slots;
+    std::vector<memory_block> blocks;
+};
+
+// grow a block from min_size to max_size through reallocate, as a vector or string builder would
+struct reallocate_growth_scenario
+{
+    static constexpr const char* name = "reallocate_growth";
+
+    reallocate_growth_scenario(const options& options, size_range range)
+        : range{range}
+        , chains{std::max<std::size_t>(options.operations / 16, 1)}
+    {
+    }
+
+    template<typename AllocatorT>
+    scenario_result run(AllocatorT& allocator)
+    {
+        scenario_result result;
+
+        for (std::size_t i = 0; i < chains; ++i)
+        {
+            memory_block block = allocator.allocate(range.min_size);
+            touch(block);
+            ++result.operations;
+
+            for (std::size_t size = range.min_size + range.min_size / 2; block && size <= range.max_size; size += size / 2)
+            {
+                if (!allocator.reallocate(block, size))
+                {
+                    ++result.failures;
+                    ++result.operations;
+                    break;
+                }
+
+                touch(block);
+                ++result.operations;
+            }
+
+            allocator.deallocate(block);
+            ++result.operations;
+        }
+
+        return result;
+    }
+
+    size_range range;
+    std::size_t chains;
+};
+
+// grow a block in place by small steps through expand, only for allocators that support it
+struct expand_loop_scenario
+{
+    static constexpr const char* name = "expand_loop";
+    static constexpr std::size_t step = 8;
+
+    expand_loop_scenario(const options& options, size_range range)
+        : range{range}
+        , chains{std::max<std::size_t>(options.operations / 16, 1)}
+    {
+    }
+
+    template<typename AllocatorT>
+    scenario_result run(AllocatorT& allocator)
+    {
+        scenario_result result;
+
+        if constexpr (allocator_traits::has_expand<AllocatorT>)
+        {
+            for (std::size_t i = 0; i < chains; ++i)
+            {
+                memory_block block = allocator.allocate(range.min_size);
+                touch(block);
+                ++result.operations;
+
+                while (block && block.size + step <= range.max_size)
+                {
+                    ++result.operations;
+
+                    if (!allocator.expand(block, step))
+                    {
+                        ++result.failures;
+                        break;
+                    }
+                }
+
+                allocator.deallocate(block);
+                ++result.operations;
+            }
+        }
+
+        return result;
+    }
+
+    size_range range;
+    std::size_t chains;
+};
+
+} // namespace coal::bench
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <coal/memory_block.hpp>
+
+#include <bench.hpp>
+#include <scenarios.hpp>
+
+namespace coal::bench {
+
+// Starts the workers together and returns the wall time until the last one finished, thread creation excluded.
+template<typename WorkT>
+std::uint64_t run_threads(std::size_t thread_count, WorkT&& work)
+{
+    std::atomic<std::size_t> ready{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            ready.fetch_add(1, std::memory_order_release);
+
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            work(i);
+        });
+    }
+
+    while (ready.load(std::memory_order_acquire) != thread_count)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// each thread churns its own live set, the allocator is only shared
+struct thread_local_churn_scenario
+{
+    static constexpr const char* name = "mt_local_churn";
+    static constexpr std::size_t thread_step = 1;
+    static constexpr std::size_t live_set_size = 64;
+
+    thread_local_churn_scenario(const options& options, size_range range)
+        : operations{options.operations}
+        , seed{options.seed}
+        , range{range}
+    {
+    }
+
+    template<typename AllocatorT>
+    threaded_result run(AllocatorT& allocator, std::size_t thread_count)
+    {
+        std::vector<std::vector<std::size_t>> sizes;
+
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            sizes.push_back(make_sizes(operations, range.min_size, range.max_size, seed + i));
+        }
+
+        std::atomic<std::size_t> failures{0};
+
+        threaded_result result;
+        result.elapsed_ns = run_threads(thread_count, [&](std::size_t index) {
+            std::vector<memory_block> blocks(live_set_size);
+            std::size_t thread_failures = 0;
+
+            for (std::size_t i = 0; i < sizes[index].size(); ++i)
+            {
+                memory_block& block = blocks[i % live_set_size];
+
+                if (block)
+                {
+                    allocator.deallocate(block);
+                }
+
+                block = allocator.allocate(sizes[index][i]);
+                touch(block);
+
+                thread_failures += block ? 0 : 1;
+            }
+
+            for (memory_block& block : blocks)
+            {
+                if (block)
+                {
+                    allocator.deallocate(block);
+                }
+            }
+
+            failures.fetch_add(thread_failures, std::memory_order_relaxed);
+        });
+
+        result.operations = thread_count * operations * 2;
+        result.failures = failures.load();
+        return result;
+    }
+
+    std::size_t operations;
+    std::uint64_t seed;
+    size_range range;
+};
+
+// threads are paired, the producer allocates and the consumer frees through a bounded queue
+struct producer_consumer_scenario
+{
+    static constexpr const char* name = "mt_producer_consumer";
+    static constexpr std::size_t thread_step = 2;
+    static constexpr std::size_t queue_capacity = 1024;
+
+    struct queue
+    {
+        std::unique_ptr<memory_block[]> blocks{new memory_block[queue_capacity]};
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+    };
+
+    producer_consumer_scenario(const options& options, size_range range)
+        : sizes{make_sizes(options.operations, range.min_size, range.max_size, options.seed)}
+    {
+    }
+
+    template<typename AllocatorT>
+    threaded_result run(AllocatorT& allocator, std::size_t thread_count)
+    {
+        const std::size_t pair_count = std::max<std::size_t>(thread_count / 2, 1);
+        std::vector<queue> queues(pair_count);
+        std::atomic<std::size_t> failures{0};
+
+        threaded_result result;
+        result.elapsed_ns = run_threads(pair_count * 2, [&](std::size_t index) {
+            queue& q = queues[index / 2];
+
+            if (index % 2 == 0)
+            {
+                std::size_t thread_failures = 0;
+
+                for (std::size_t size : sizes)
+                {
+                    memory_block block = allocator.allocate(size);
+                    touch(block);
+
+                    thread_failures += block ? 0 : 1;
+
+                    const std::size_t tail = q.tail.load(std::memory_order_relaxed);
+
+                    while (tail - q.head.load(std::memory_order_acquire) == queue_capacity)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    q.blocks[tail % queue_capacity] = block;
+                    q.tail.store(tail + 1, std::memory_order_release);
+                }
+
+                failures.fetch_add(thread_failures, std::memory_order_relaxed);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < sizes.size(); ++i)
+                {
+                    const std::size_t head = q.head.load(std::memory_order_relaxed);
+
+                    while (q.tail.load(std::memory_order_acquire) == head)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    memory_block block = q.blocks[head % queue_capacity];
+                    q.head.store(head + 1, std::memory_order_release);
+
+                    if (block)
+                    {
+                        allocator.deallocate(block);
+                    }
+                }
+            }
+        });
+
+        result.operations = pair_count * sizes.size() * 2;
+        result.failures = failures.load();
+        return result;
+    }
+
+    std::vector<std::size_t> sizes;
+};
+
+// threads swap blocks in and out of a shared pool, most blocks are freed by another thread than the one that
+// allocated them; the block size is stored in the block itself so a slot is a single atomic pointer
+struct shared_pool_scenario
+{
+    static constexpr const char* name = "mt_shared_pool";
+    static constexpr std::size_t thread_step = 1;
+    static constexpr std::size_t pool_size = 1024;
+
+    shared_pool_scenario(const options& options, size_range range)
+        : operations{options.operations}
+        , seed{options.seed}
+        , range{std::max(range.min_size, sizeof(std::size_t)), std::max(range.max_size, sizeof(std::size_t))}
+    {
+    }
+
+    template<typename AllocatorT>
+    threaded_result run(AllocatorT& allocator, std::size_t thread_count)
+    {
+        std::vector<std::atomic<void*>> pool(pool_size);
+        std::atomic<std::size_t> failures{0};
+
+        const auto release = [&allocator](void* ptr) {
+            if (ptr != nullptr)
+            {
+                memory_block block{ptr, 0};
+                std::memcpy(&block.size, ptr, sizeof(std::size_t));
+                allocator.deallocate(block);
+            }
+        };
+
+        threaded_result result;
+        result.elapsed_ns = run_threads(thread_count, [&](std::size_t index) {
+            const std::vector<std::size_t> sizes = make_sizes(operations, range.min_size, range.max_size, seed + index);
+
+            std::mt19937_64 rng{seed ^ index};
+            std::uniform_int_distribution<std::size_t> distribution{0, pool_size - 1};
+            std::size_t thread_failures = 0;
+
+            for (std::size_t size : sizes)
+            {
+                std::atomic<void*>& slot = pool[distribution(rng)];
+
+                release(slot.exchange(nullptr, std::memory_order_acq_rel));
+
+                memory_block block = allocator.allocate(size);
+
+                if (!block)
+                {
+                    ++thread_failures;
+                    continue;
+                }
+
+                std::memcpy(block.ptr, &block.size, sizeof(std::size_t));
+
+                // another thread may have refilled the slot meanwhile
+                release(slot.exchange(block.ptr, std::memory_order_acq_rel));
+            }
+
+            failures.fetch_add(thread_failures, std::memory_order_relaxed);
+        });
+
+        for (std::atomic<void*>& slot : pool)
+        {
+            release(slot.exchange(nullptr));
+        }
+
+        result.operations = thread_count * operations * 2;
+        result.failures = failures.load();
+        return result;
+    }
+
+    std::size_t operations;
+    std::uint64_t seed;
+    size_range range;
+};
+
+} // namespace coal::bench
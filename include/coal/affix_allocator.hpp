@@ -8,6 +8,7 @@
 
 #include <coal/alignment.hpp>
 #include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_marker.hpp>
 #include <coal/details/allocator_reallocation.hpp>
 #include <coal/memory_block.hpp>
 
@@ -34,9 +35,16 @@ public:
     static constexpr bool has_prefix = prefix_size > 0;
     static constexpr bool has_suffix = suffix_size > 0;
 
+    using marker = details::marker_of_t<allocator>;
+
 public:
     [[nodiscard]] constexpr size_t get_alignment() const;
 
+    // granted size of the outer block, affixes included
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_granted_size<U>)
+    [[nodiscard]] constexpr size_t granted_size(size_t size) const;
+
     [[nodiscard]] constexpr const allocator& get_allocator() const;
     [[nodiscard]] constexpr allocator& get_allocator();
 
@@ -55,6 +63,15 @@ public:
     constexpr bool reallocate(memory_block& block, size_t new_size);
     constexpr void deallocate(memory_block& block);
 
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_mark<U>)
+    [[nodiscard]] constexpr marker mark() const;
+
+    // the affixes of the rewound blocks are released without being destroyed
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_mark<U>)
+    constexpr void rewind(const marker& marker);
+
     constexpr const prefix* get_prefix(const memory_block& block) const;
     constexpr const suffix* get_suffix(const memory_block& block) const;
 
@@ -135,6 +152,14 @@ constexpr size_t affix_allocator<AllocatorT, PrefixT, SuffixT>::get_alignment()
     return alignment;
 }
 
+template<typename AllocatorT, typename PrefixT, typename SuffixT>
+template<typename U>
+requires(allocator_traits::has_granted_size<U>)
+constexpr size_t affix_allocator<AllocatorT, PrefixT, SuffixT>::granted_size(size_t size) const
+{
+    return _allocator.granted_size(align_up(size, alignment) + prefix_size + suffix_size);
+}
+
 template<typename AllocatorT, typename PrefixT, typename SuffixT>
 constexpr const affix_allocator<AllocatorT, PrefixT, SuffixT>::allocator& affix_allocator<AllocatorT, PrefixT, SuffixT>::get_allocator() const
 {
@@ -269,12 +294,31 @@ constexpr void affix_allocator<AllocatorT, PrefixT, SuffixT>::deallocate(memory_
     block = nullblk;
 }
 
+template<typename AllocatorT, typename PrefixT, typename SuffixT>
+template<typename U>
+requires(allocator_traits::has_mark<U>)
+constexpr affix_allocator<AllocatorT, PrefixT, SuffixT>::marker affix_allocator<AllocatorT, PrefixT, SuffixT>::mark() const
+{
+    return _allocator.mark();
+}
+
+template<typename AllocatorT, typename PrefixT, typename SuffixT>
+template<typename U>
+requires(allocator_traits::has_mark<U>)
+constexpr void affix_allocator<AllocatorT, PrefixT, SuffixT>::rewind(const marker& marker)
+{
+    _allocator.rewind(marker);
+}
+
 template<typename AllocatorT, typename PrefixT, typename SuffixT>
 constexpr const affix_allocator<AllocatorT, PrefixT, SuffixT>::prefix* affix_allocator<AllocatorT, PrefixT, SuffixT>::get_prefix(const memory_block& block) const
 {
     if constexpr (prefix_size > 0)
     {
-        assert(owns(block));
+        if constexpr (allocator_traits::has_owns<AllocatorT>)
+        {
+            assert(owns(block));
+        }
         return prefix_from_outer(unaligned_inner_to_outer(block));
     }
     return nullptr;
@@ -285,7 +329,10 @@ constexpr const affix_allocator<AllocatorT, PrefixT, SuffixT>::suffix* affix_all
 {
     if constexpr (suffix_size > 0)
     {
-        assert(owns(block));
+        if constexpr (allocator_traits::has_owns<AllocatorT>)
+        {
+            assert(owns(block));
+        }
         return suffix_from_outer(unaligned_inner_to_outer(block));
     }
     return nullptr;
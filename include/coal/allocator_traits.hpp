@@ -1,5 +1,7 @@
 #pragma once
 
+#include <concepts>
+
 #include <coal/memory_block.hpp>
 
 #define _COAL_TYPE_TRAIT_HAS_METHOD_IMPL(name, method_name, return_type, suffix, ...) \
@@ -41,4 +43,14 @@ COAL_TYPE_TRAIT_HAS_METHOD_CONST(has_owns, owns, bool, const memory_block&);
 COAL_TYPE_TRAIT_HAS_METHOD(has_expand, expand, bool, memory_block&, std::size_t);
 COAL_TYPE_TRAIT_HAS_METHOD(has_deallocate_all, deallocate_all, void);
 
+// granted_size returns the bytes a block of the given size really takes, once rounded to the allocator granularity
+COAL_TYPE_TRAIT_HAS_METHOD_CONST(has_granted_size, granted_size, std::size_t, std::size_t);
+
+// mark returns a T::marker, rewind to it frees every block allocated since
+template<typename T>
+inline static constexpr bool has_mark = requires(T& allocator, const T& const_allocator, const typename T::marker& marker) {
+    { const_allocator.mark() } -> std::same_as<typename T::marker>;
+    allocator.rewind(marker);
+};
+
 } // namespace coal::allocator_traits
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/bitmap.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Carves one block of the parent allocator into BlockCountT slots of BlockSizeT bytes. The free slots are tracked
+// in a bitmap outside of the slots, so freeing never writes to the freed memory. An allocation takes as many
+// contiguous slots as its size needs.
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+class bitmapped_block
+{
+    static_assert(BlockSizeT > 0, "Block size must be greater than zero.");
+    static_assert(BlockCountT > 0, "Block count must be greater than zero.");
+    static_assert((BlockSizeT % AllocatorT::alignment) == 0, "Block size must be a multiple of alignment.");
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t block_size = BlockSizeT;
+    static constexpr std::size_t block_count = BlockCountT;
+    static constexpr std::size_t max_size = BlockSizeT * BlockCountT;
+
+public:
+    constexpr bitmapped_block() = default;
+    constexpr ~bitmapped_block();
+
+    bitmapped_block(const bitmapped_block&) = delete;
+    bitmapped_block& operator=(const bitmapped_block&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // whole blocks taken by size
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    [[nodiscard]] constexpr std::size_t get_free_block_count() const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+    constexpr bool expand(memory_block& block, std::size_t delta);
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+    constexpr void deallocate_all();
+
+private:
+    using bitmap = details::bitmap<BlockCountT>;
+
+    static constexpr std::size_t blocks_for_size(std::size_t size);
+
+    [[nodiscard]] constexpr std::size_t index_of(const memory_block& block) const;
+
+    constexpr bool acquire_region();
+
+    // set bits are free slots; every slot before _first_free is in use
+    bitmap _free{};
+    std::size_t _first_free{0};
+    std::size_t _free_count{0};
+    memory_block _region{nullblk};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::~bitmapped_block()
+{
+    // the slots still allocated go back with the region
+    if (_region)
+    {
+        _allocator.deallocate(_region);
+    }
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr std::size_t bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr std::size_t bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::granted_size(std::size_t size) const
+{
+    return blocks_for_size(size) * BlockSizeT;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr const bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::allocator& bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::allocator& bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr std::size_t bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::get_free_block_count() const
+{
+    return _region ? _free_count : BlockCountT;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+template<typename Initializer>
+constexpr void bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr memory_block bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::allocate(std::size_t size)
+{
+    if (size == 0 || size > max_size)
+    {
+        return nullblk;
+    }
+
+    if (!_region && !acquire_region())
+    {
+        return nullblk;
+    }
+
+    const std::size_t count = blocks_for_size(size);
+
+    if (count > _free_count)
+    {
+        return nullblk;
+    }
+
+    _first_free = _free.find_first_set(_first_free);
+
+    const std::size_t index = _free.find_set_run(_first_free, count);
+
+    if (index == bitmap::npos)
+    {
+        return nullblk;
+    }
+
+    _free.reset(index, count);
+    _free_count -= count;
+
+    if (index == _first_free)
+    {
+        _first_free += count;
+    }
+
+    const memory_block block{_region.as<std::uint8_t>() + index * BlockSizeT, size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr bool bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::owns(const memory_block& block) const
+{
+    return block && _region && block.ptr >= _region.ptr && block.ptr < _region.as<std::uint8_t>() + max_size;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr bool bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    if (new_size > max_size)
+    {
+        return false;
+    }
+
+    const std::size_t count = blocks_for_size(block.size);
+    const std::size_t new_count = blocks_for_size(new_size);
+
+    if (new_count > count)
+    {
+        // grow in place over the free slots following the block
+        const std::size_t end = index_of(block) + count;
+        const std::size_t extra = new_count - count;
+
+        if (BlockCountT - end < extra || _free.count_set_run(end, extra) < extra)
+        {
+            return false;
+        }
+
+        _free.reset(end, extra);
+        _free_count -= extra;
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr bool bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    const std::size_t count = blocks_for_size(block.size);
+    const std::size_t new_count = blocks_for_size(new_size);
+
+    if (new_count <= count)
+    {
+        // the slots past the new size go back to the bitmap
+        const std::size_t end = index_of(block) + new_count;
+
+        _free.set(end, count - new_count);
+        _free_count += count - new_count;
+        _first_free = end < _first_free ? end : _first_free;
+
+        block.size = new_size;
+        return true;
+    }
+
+    if (expand(block, new_size - block.size))
+    {
+        return true;
+    }
+
+    if (memory_block new_block = allocate(new_size))
+    {
+        std::memcpy(new_block.ptr, block.ptr, block.size);
+        deallocate(block);
+        block = new_block;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr void bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    const std::size_t index = index_of(block);
+    const std::size_t count = blocks_for_size(block.size);
+
+    _free.set(index, count);
+    _free_count += count;
+    _first_free = index < _first_free ? index : _first_free;
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr void bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::deallocate_all()
+{
+    // the region is kept, only the bitmap is reset
+    _free.set_all();
+    _first_free = 0;
+    _free_count = BlockCountT;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr std::size_t bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::blocks_for_size(std::size_t size)
+{
+    return (size + BlockSizeT - 1) / BlockSizeT;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr std::size_t bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::index_of(const memory_block& block) const
+{
+    assert(owns(block));
+
+    return static_cast<std::size_t>(block.as<std::uint8_t>() - _region.as<std::uint8_t>()) / BlockSizeT;
+}
+
+template<typename AllocatorT, std::size_t BlockSizeT, std::size_t BlockCountT>
+constexpr bool bitmapped_block<AllocatorT, BlockSizeT, BlockCountT>::acquire_region()
+{
+    _region = _allocator.allocate(max_size);
+
+    if (!_region)
+    {
+        return false;
+    }
+
+    deallocate_all();
+    return true;
+}
+
+} // namespace coal
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+
+namespace coal::bucket_policy {
+
+// Buckets of MinSizeT then StepsT evenly spaced sizes in each doubling up to MaxSizeT, e.g. with 4 steps from 16:
+// 16, 20, 24, 28, 32, 40, 48, 56, 64, ... so rounding never wastes more than 1 / StepsT of a block.
+template<std::size_t MinSizeT, std::size_t MaxSizeT, std::size_t StepsT>
+struct geometric
+{
+    static_assert(std::has_single_bit(MinSizeT), "Minimum size must be a power of two.");
+    static_assert(std::has_single_bit(MaxSizeT), "Maximum size must be a power of two.");
+    static_assert(MaxSizeT >= MinSizeT, "Maximum size must not be less than minimum size.");
+    static_assert(std::has_single_bit(StepsT), "Steps per doubling must be a power of two.");
+    static_assert(MinSizeT >= StepsT, "Minimum size must be at least the steps per doubling.");
+
+    static constexpr std::size_t min_size = MinSizeT;
+    static constexpr std::size_t max_size = MaxSizeT;
+    static constexpr std::size_t bucket_count = (std::bit_width(MaxSizeT) - std::bit_width(MinSizeT)) * StepsT + 1;
+
+    static constexpr std::size_t index_for_size(std::size_t size);
+    static constexpr std::size_t size_at_index(std::size_t index);
+};
+
+template<std::size_t MinSizeT, std::size_t MaxSizeT, std::size_t StepsT>
+constexpr std::size_t geometric<MinSizeT, MaxSizeT, StepsT>::index_for_size(std::size_t size)
+{
+    if (size <= MinSizeT)
+    {
+        return 0;
+    }
+
+    // size is in the doubling (2^k, 2^(k+1)], split in steps of 2^k / StepsT
+    const std::size_t k = static_cast<std::size_t>(std::bit_width(size - 1)) - 1;
+    const std::size_t base = std::size_t{1} << k;
+    const std::size_t step_shift = k - static_cast<std::size_t>(std::countr_zero(StepsT));
+
+    return (k - static_cast<std::size_t>(std::countr_zero(MinSizeT))) * StepsT + ((size - base - 1) >> step_shift) + 1;
+}
+
+template<std::size_t MinSizeT, std::size_t MaxSizeT, std::size_t StepsT>
+constexpr std::size_t geometric<MinSizeT, MaxSizeT, StepsT>::size_at_index(std::size_t index)
+{
+    if (index == 0)
+    {
+        return MinSizeT;
+    }
+
+    const std::size_t base = MinSizeT << ((index - 1) / StepsT);
+
+    return base + ((index - 1) % StepsT + 1) * (base / StepsT);
+}
+
+} // namespace coal::bucket_policy
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+namespace coal::bucket_policy {
+
+// Buckets of MinSizeT, MinSizeT + StepT, ... up to MaxSizeT.
+template<std::size_t MinSizeT, std::size_t MaxSizeT, std::size_t StepT>
+struct linear
+{
+    static_assert(MinSizeT > 0, "Minimum size must be greater than zero.");
+    static_assert(StepT > 0, "Step must be greater than zero.");
+    static_assert(MaxSizeT >= MinSizeT, "Maximum size must not be less than minimum size.");
+    static_assert((MaxSizeT - MinSizeT) % StepT == 0, "Maximum size must be minimum size plus a multiple of step.");
+
+    static constexpr std::size_t min_size = MinSizeT;
+    static constexpr std::size_t max_size = MaxSizeT;
+    static constexpr std::size_t bucket_count = (MaxSizeT - MinSizeT) / StepT + 1;
+
+    static constexpr std::size_t index_for_size(std::size_t size);
+    static constexpr std::size_t size_at_index(std::size_t index);
+};
+
+template<std::size_t MinSizeT, std::size_t MaxSizeT, std::size_t StepT>
+constexpr std::size_t linear<MinSizeT, MaxSizeT, StepT>::index_for_size(std::size_t size)
+{
+    return size <= MinSizeT ? 0 : (size - MinSizeT + StepT - 1) / StepT;
+}
+
+template<std::size_t MinSizeT, std::size_t MaxSizeT, std::size_t StepT>
+constexpr std::size_t linear<MinSizeT, MaxSizeT, StepT>::size_at_index(std::size_t index)
+{
+    return MinSizeT + index * StepT;
+}
+
+} // namespace coal::bucket_policy
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+namespace details {
+
+template<typename BucketPolicyT>
+constexpr bool are_bucket_sizes_aligned(std::size_t alignment)
+{
+    for (std::size_t index = 0; index < BucketPolicyT::bucket_count; ++index)
+    {
+        if (BucketPolicyT::size_at_index(index) % alignment != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace details
+
+// One AllocatorT per bucket of BucketPolicyT, a size goes to the smallest bucket holding it. Each child only sees
+// its bucket size, so any block it freed fits the next allocation of the bucket.
+template<typename AllocatorT, typename BucketPolicyT>
+class bucketizer
+{
+    static_assert(BucketPolicyT::bucket_count > 0, "Bucket policy must have at least one bucket.");
+    static_assert(details::are_bucket_sizes_aligned<BucketPolicyT>(AllocatorT::alignment), "Each bucket size must be a multiple of alignment.");
+
+public:
+    using allocator = AllocatorT;
+    using bucket_policy = BucketPolicyT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t bucket_count = bucket_policy::bucket_count;
+    static constexpr std::size_t max_size = bucket_policy::max_size;
+
+    static constexpr std::size_t index_for_size(std::size_t size);
+    static constexpr std::size_t size_at_index(std::size_t index);
+
+public:
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // size of the bucket serving size, size itself past max_size
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator(std::size_t index) const;
+    [[nodiscard]] constexpr allocator& get_allocator(std::size_t index);
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+
+    constexpr bool expand(memory_block& block, std::size_t delta);
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_deallocate_all<U>)
+    constexpr void deallocate_all();
+
+private:
+    std::array<allocator, bucket_count> _allocators{};
+};
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr std::size_t bucketizer<AllocatorT, BucketPolicyT>::index_for_size(std::size_t size)
+{
+    return bucket_policy::index_for_size(size);
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr std::size_t bucketizer<AllocatorT, BucketPolicyT>::size_at_index(std::size_t index)
+{
+    return bucket_policy::size_at_index(index);
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr std::size_t bucketizer<AllocatorT, BucketPolicyT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr std::size_t bucketizer<AllocatorT, BucketPolicyT>::granted_size(std::size_t size) const
+{
+    return size > 0 && size <= max_size ? size_at_index(index_for_size(size)) : size;
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr const bucketizer<AllocatorT, BucketPolicyT>::allocator& bucketizer<AllocatorT, BucketPolicyT>::get_allocator(std::size_t index) const
+{
+    return _allocators[index];
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr bucketizer<AllocatorT, BucketPolicyT>::allocator& bucketizer<AllocatorT, BucketPolicyT>::get_allocator(std::size_t index)
+{
+    return _allocators[index];
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+template<typename Initializer>
+constexpr void bucketizer<AllocatorT, BucketPolicyT>::init(Initializer& initializer)
+{
+    for (allocator& child : _allocators)
+    {
+        child.init(initializer);
+    }
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr memory_block bucketizer<AllocatorT, BucketPolicyT>::allocate(std::size_t size)
+{
+    if (size == 0 || size > max_size)
+    {
+        return nullblk;
+    }
+
+    const std::size_t index = index_for_size(size);
+
+    if (memory_block block = _allocators[index].allocate(size_at_index(index)))
+    {
+        block.size = size;
+        return block;
+    }
+
+    return nullblk;
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+constexpr bool bucketizer<AllocatorT, BucketPolicyT>::owns(const memory_block& block) const
+{
+    if (!block || block.size > max_size)
+    {
+        return false;
+    }
+
+    const std::size_t index = index_for_size(block.size);
+
+    return _allocators[index].owns({block.ptr, size_at_index(index)});
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr bool bucketizer<AllocatorT, BucketPolicyT>::expand(memory_block& block, std::size_t delta)
+{
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    // the block cannot leave its bucket in place
+    if (new_size > max_size || index_for_size(new_size) != index_for_size(block.size))
+    {
+        return false;
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr bool bucketizer<AllocatorT, BucketPolicyT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    if (new_size <= max_size && index_for_size(new_size) == index_for_size(block.size))
+    {
+        block.size = new_size;
+        return true;
+    }
+
+    return details::reallocate_with_new_allocator(*this, *this, block, new_size);
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+constexpr void bucketizer<AllocatorT, BucketPolicyT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    const std::size_t index = index_for_size(block.size);
+
+    memory_block bucket_block{block.ptr, size_at_index(index)};
+    _allocators[index].deallocate(bucket_block);
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, typename BucketPolicyT>
+template<typename U>
+requires(allocator_traits::has_deallocate_all<U>)
+constexpr void bucketizer<AllocatorT, BucketPolicyT>::deallocate_all()
+{
+    for (allocator& child : _allocators)
+    {
+        child.deallocate_all();
+    }
+}
+
+} // namespace coal
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/bitmap.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Binary buddy system over one block of 2^MaxOrderT bytes taken from the parent allocator. Blocks are rounded up to
+// a power of two of at least 2^MinOrderT and carved by halving larger free blocks. A freed block merges with its
+// buddy, the other half of the block it was split from, as long as that one is free too, so fragmentation stays
+// bounded. Free blocks of each order are linked through their own memory, a bitmap over the split tree tells whether
+// a buddy is free in constant time.
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+class buddy_allocator
+{
+    struct free_node
+    {
+        free_node* previous;
+        free_node* next;
+    };
+
+    static_assert(MaxOrderT >= MinOrderT, "Max order must be greater or equal to min order.");
+    static_assert(MaxOrderT < sizeof(std::size_t) * 8, "Max order must fit in a size.");
+    static_assert(MaxOrderT - MinOrderT < 20, "Order count must keep the split tree bitmap small.");
+    static_assert((std::size_t{1} << MinOrderT) >= sizeof(free_node), "Min order must hold the free list links.");
+    static_assert(((std::size_t{1} << MinOrderT) % AllocatorT::alignment) == 0, "Min block size must be a multiple of alignment.");
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t min_order = MinOrderT;
+    static constexpr std::size_t max_order = MaxOrderT;
+    static constexpr std::size_t order_count = MaxOrderT - MinOrderT + 1;
+    static constexpr std::size_t min_size = std::size_t{1} << MinOrderT;
+    static constexpr std::size_t max_size = std::size_t{1} << MaxOrderT;
+
+    // smallest order holding size, size must not be zero
+    static constexpr std::size_t order_for_size(std::size_t size);
+
+public:
+    constexpr buddy_allocator() = default;
+    ~buddy_allocator();
+
+    buddy_allocator(const buddy_allocator&) = delete;
+    buddy_allocator& operator=(const buddy_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // power of two block serving size
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    // bytes held by free blocks, the rounding of the allocated blocks counts as used
+    [[nodiscard]] constexpr std::size_t get_free_size() const;
+
+    // free blocks of order
+    [[nodiscard]] std::size_t get_free_block_count(std::size_t order) const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+    void deallocate_all();
+
+private:
+    // one bit per node of the split tree, 2^(order_count) - 1 nodes from the whole region down to the min blocks
+    using bitmap = details::bitmap<(std::size_t{1} << order_count) - 1>;
+
+    [[nodiscard]] static constexpr std::size_t node_index(std::size_t offset, std::size_t order);
+
+    [[nodiscard]] constexpr std::size_t offset_of(const memory_block& block) const;
+    [[nodiscard]] constexpr bool is_free(std::size_t offset, std::size_t order) const;
+
+    void push_free(std::size_t offset, std::size_t order);
+    void remove_free(std::size_t offset, std::size_t order);
+
+    bool acquire_region();
+
+    // set bits are free blocks, a node is only set at the order of the free block starting there
+    bitmap _free{};
+    std::array<free_node*, order_count> _free_lists{};
+    std::uint64_t _non_empty_orders{0};
+    std::size_t _free_size{0};
+    memory_block _region{nullblk};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::order_for_size(std::size_t size)
+{
+    const std::size_t order = static_cast<std::size_t>(std::bit_width(size - 1));
+    return order < MinOrderT ? MinOrderT : order;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::~buddy_allocator()
+{
+    // the blocks still allocated go back with the region
+    if (_region)
+    {
+        _allocator.deallocate(_region);
+    }
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::granted_size(std::size_t size) const
+{
+    return size > 0 && size <= max_size ? std::size_t{1} << order_for_size(size) : size;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr const buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::allocator& buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::allocator& buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::get_free_size() const
+{
+    return _region ? _free_size : max_size;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::get_free_block_count(std::size_t order) const
+{
+    assert(order >= MinOrderT && order <= MaxOrderT);
+
+    if (!_region)
+    {
+        return order == MaxOrderT ? 1 : 0;
+    }
+
+    std::size_t count = 0;
+
+    for (const free_node* node = _free_lists[order - MinOrderT]; node; node = node->next)
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+template<typename Initializer>
+constexpr void buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+memory_block buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::allocate(std::size_t size)
+{
+    if (size == 0 || size > max_size)
+    {
+        return nullblk;
+    }
+
+    if (!_region && !acquire_region())
+    {
+        return nullblk;
+    }
+
+    const std::size_t order = order_for_size(size);
+    const std::uint64_t candidates = _non_empty_orders >> (order - MinOrderT);
+
+    if (candidates == 0)
+    {
+        return nullblk;
+    }
+
+    // smallest free block large enough, halved until it fits
+    std::size_t current = order + static_cast<std::size_t>(std::countr_zero(candidates));
+    const std::size_t offset = static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(_free_lists[current - MinOrderT]) - _region.as<std::uint8_t>());
+
+    remove_free(offset, current);
+
+    while (current > order)
+    {
+        --current;
+        push_free(offset + (std::size_t{1} << current), current);
+    }
+
+    const memory_block block{_region.as<std::uint8_t>() + offset, size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr bool buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::owns(const memory_block& block) const
+{
+    return block && _region && block.ptr >= _region.ptr && block.ptr < _region.as<std::uint8_t>() + max_size;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+bool buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    if (new_size > max_size)
+    {
+        return false;
+    }
+
+    const std::size_t order = order_for_size(block.size);
+    const std::size_t new_order = order_for_size(new_size);
+    const std::size_t offset = offset_of(block);
+
+    // merging in place needs the block to be the first half at every order and each second half to be free
+    if (offset % (std::size_t{1} << new_order) != 0)
+    {
+        return false;
+    }
+
+    for (std::size_t current = order; current < new_order; ++current)
+    {
+        if (!is_free(offset + (std::size_t{1} << current), current))
+        {
+            return false;
+        }
+    }
+
+    for (std::size_t current = order; current < new_order; ++current)
+    {
+        remove_free(offset + (std::size_t{1} << current), current);
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+bool buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    const std::size_t order = order_for_size(block.size);
+    const std::size_t new_order = order_for_size(new_size);
+
+    if (new_order <= order)
+    {
+        // the second halves past the new order go back, their buddies hold the block so they cannot merge
+        const std::size_t offset = offset_of(block);
+
+        for (std::size_t current = order; current > new_order; --current)
+        {
+            push_free(offset + (std::size_t{1} << (current - 1)), current - 1);
+        }
+
+        block.size = new_size;
+        return true;
+    }
+
+    if (expand(block, new_size - block.size))
+    {
+        return true;
+    }
+
+    if (memory_block new_block = allocate(new_size))
+    {
+        std::memcpy(new_block.ptr, block.ptr, block.size);
+        deallocate(block);
+        block = new_block;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+void buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    std::size_t order = order_for_size(block.size);
+    std::size_t offset = offset_of(block);
+
+    for (; order < MaxOrderT; ++order)
+    {
+        const std::size_t buddy = offset ^ (std::size_t{1} << order);
+
+        if (!is_free(buddy, order))
+        {
+            break;
+        }
+
+        remove_free(buddy, order);
+        offset = offset < buddy ? offset : buddy;
+    }
+
+    push_free(offset, order);
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+void buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::deallocate_all()
+{
+    if (!_region)
+    {
+        return;
+    }
+
+    // the region is kept as a single free block
+    _free.reset_all();
+    _free_lists.fill(nullptr);
+    _non_empty_orders = 0;
+    _free_size = 0;
+
+    push_free(0, MaxOrderT);
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::node_index(std::size_t offset, std::size_t order)
+{
+    return (std::size_t{1} << (MaxOrderT - order)) - 1 + (offset >> order);
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr std::size_t buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::offset_of(const memory_block& block) const
+{
+    assert(owns(block));
+
+    return static_cast<std::size_t>(block.as<std::uint8_t>() - _region.as<std::uint8_t>());
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+constexpr bool buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::is_free(std::size_t offset, std::size_t order) const
+{
+    return _free.test(node_index(offset, order));
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+void buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::push_free(std::size_t offset, std::size_t order)
+{
+    free_node*& head = _free_lists[order - MinOrderT];
+    free_node* node = reinterpret_cast<free_node*>(_region.as<std::uint8_t>() + offset);
+
+    node->previous = nullptr;
+    node->next = head;
+
+    if (head)
+    {
+        head->previous = node;
+    }
+
+    head = node;
+
+    _free.set(node_index(offset, order), 1);
+    _non_empty_orders |= std::uint64_t{1} << (order - MinOrderT);
+    _free_size += std::size_t{1} << order;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+void buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::remove_free(std::size_t offset, std::size_t order)
+{
+    free_node*& head = _free_lists[order - MinOrderT];
+    free_node* node = reinterpret_cast<free_node*>(_region.as<std::uint8_t>() + offset);
+
+    assert(is_free(offset, order));
+
+    (node->previous ? node->previous->next : head) = node->next;
+
+    if (node->next)
+    {
+        node->next->previous = node->previous;
+    }
+
+    if (!head)
+    {
+        _non_empty_orders &= ~(std::uint64_t{1} << (order - MinOrderT));
+    }
+
+    _free.reset(node_index(offset, order), 1);
+    _free_size -= std::size_t{1} << order;
+}
+
+template<typename AllocatorT, std::size_t MinOrderT, std::size_t MaxOrderT>
+bool buddy_allocator<AllocatorT, MinOrderT, MaxOrderT>::acquire_region()
+{
+    _region = _allocator.allocate(max_size);
+
+    if (!_region)
+    {
+        return false;
+    }
+
+    deallocate_all();
+    return true;
+}
+
+} // namespace coal
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#include <coal/alignment.hpp>
+#include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Grows a fixed capacity AllocatorT into an unbounded one by keeping a list of its instances, each one stored in a
+// block of ParentAllocatorT. An allocation tries every instance, the newest first, and creates a new one when they
+// all fail. Blocks go back to the instance which owns them. An instance left without live blocks is destroyed, except
+// for one kept to absorb allocations oscillating around the capacity of an instance.
+template<typename AllocatorT, typename ParentAllocatorT = malloc_allocator>
+class cascading_allocator
+{
+    static_assert(allocator_traits::has_owns<AllocatorT>, "Allocator must implement owns to route blocks back to their instance.");
+
+    struct node
+    {
+        node* next{nullptr};
+        std::size_t live_count{0};
+
+        // block of the parent holding the node, larger than it when the parent alignment is not enough
+        memory_block storage;
+
+        AllocatorT instance;
+    };
+
+    static constexpr std::size_t node_storage_size = sizeof(node) + (alignof(node) > ParentAllocatorT::alignment ? alignof(node) - ParentAllocatorT::alignment : 0);
+
+public:
+    using allocator = AllocatorT;
+    using parent_allocator = ParentAllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+
+public:
+    constexpr cascading_allocator() = default;
+    ~cascading_allocator();
+
+    cascading_allocator(const cascading_allocator&) = delete;
+    cascading_allocator& operator=(const cascading_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    [[nodiscard]] constexpr const parent_allocator& get_parent_allocator() const;
+    [[nodiscard]] constexpr parent_allocator& get_parent_allocator();
+
+    [[nodiscard]] constexpr std::size_t get_instance_count() const;
+
+    // instances are created on demand, only the parent allocator is initialized
+    template<typename Initializer>
+    void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+    [[nodiscard]] bool owns(const memory_block& block) const;
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_expand<U>)
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+    void deallocate_all();
+
+private:
+    [[nodiscard]] node* find_owner(const memory_block& block) const;
+
+    [[nodiscard]] node* create_node();
+    void destroy_node(node* n);
+
+    // removes n from the list, previous is the node before it or nullptr when n is the head
+    void unlink_node(node* previous, node* n);
+
+    node* _head{nullptr};
+    std::size_t _instance_count{0};
+    std::size_t _empty_count{0};
+    parent_allocator _parent;
+};
+
+template<typename AllocatorT, typename ParentAllocatorT>
+cascading_allocator<AllocatorT, ParentAllocatorT>::~cascading_allocator()
+{
+    deallocate_all();
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+constexpr std::size_t cascading_allocator<AllocatorT, ParentAllocatorT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+constexpr const cascading_allocator<AllocatorT, ParentAllocatorT>::parent_allocator& cascading_allocator<AllocatorT, ParentAllocatorT>::get_parent_allocator() const
+{
+    return _parent;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+constexpr cascading_allocator<AllocatorT, ParentAllocatorT>::parent_allocator& cascading_allocator<AllocatorT, ParentAllocatorT>::get_parent_allocator()
+{
+    return _parent;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+constexpr std::size_t cascading_allocator<AllocatorT, ParentAllocatorT>::get_instance_count() const
+{
+    return _instance_count;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+template<typename Initializer>
+void cascading_allocator<AllocatorT, ParentAllocatorT>::init(Initializer& initializer)
+{
+    _parent.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+memory_block cascading_allocator<AllocatorT, ParentAllocatorT>::allocate(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    for (node* n = _head; n; n = n->next)
+    {
+        if (memory_block block = n->instance.allocate(size))
+        {
+            _empty_count -= n->live_count == 0 ? 1 : 0;
+            ++n->live_count;
+            return block;
+        }
+    }
+
+    node* n = create_node();
+
+    if (!n)
+    {
+        return nullblk;
+    }
+
+    memory_block block = n->instance.allocate(size);
+
+    if (!block)
+    {
+        // too large for any instance, a new one cannot help
+        unlink_node(nullptr, n);
+        destroy_node(n);
+        return nullblk;
+    }
+
+    n->live_count = 1;
+
+    return block;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+bool cascading_allocator<AllocatorT, ParentAllocatorT>::owns(const memory_block& block) const
+{
+    return block && find_owner(block);
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+template<typename U>
+requires(allocator_traits::has_expand<U>)
+bool cascading_allocator<AllocatorT, ParentAllocatorT>::expand(memory_block& block, std::size_t delta)
+{
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    node* owner = find_owner(block);
+
+    assert(owner && "Block not owned by any instance.");
+
+    return owner->instance.expand(block, delta);
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+bool cascading_allocator<AllocatorT, ParentAllocatorT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    node* owner = find_owner(block);
+
+    assert(owner && "Block not owned by any instance.");
+
+    if (owner->instance.reallocate(block, new_size))
+    {
+        return true;
+    }
+
+    // the owner is full, another instance or a new one may have room
+    return details::reallocate_with_new_allocator(*this, *this, block, new_size);
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+void cascading_allocator<AllocatorT, ParentAllocatorT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    node* previous = nullptr;
+    node* n = _head;
+
+    while (n && !n->instance.owns(block))
+    {
+        previous = n;
+        n = n->next;
+    }
+
+    assert(n && "Block not owned by any instance.");
+
+    n->instance.deallocate(block);
+    block = nullblk;
+
+    if (--n->live_count > 0)
+    {
+        return;
+    }
+
+    if (_empty_count > 0)
+    {
+        unlink_node(previous, n);
+        destroy_node(n);
+        return;
+    }
+
+    ++_empty_count;
+
+    // an allocator such as stack_allocator only reclaims its memory when it is reset
+    if constexpr (allocator_traits::has_deallocate_all<allocator>)
+    {
+        n->instance.deallocate_all();
+    }
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+void cascading_allocator<AllocatorT, ParentAllocatorT>::deallocate_all()
+{
+    while (_head)
+    {
+        node* n = _head;
+        unlink_node(nullptr, n);
+        destroy_node(n);
+    }
+
+    _empty_count = 0;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+cascading_allocator<AllocatorT, ParentAllocatorT>::node* cascading_allocator<AllocatorT, ParentAllocatorT>::find_owner(const memory_block& block) const
+{
+    for (node* n = _head; n; n = n->next)
+    {
+        if (n->instance.owns(block))
+        {
+            return n;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+cascading_allocator<AllocatorT, ParentAllocatorT>::node* cascading_allocator<AllocatorT, ParentAllocatorT>::create_node()
+{
+    memory_block block = _parent.allocate(node_storage_size);
+
+    if (!block)
+    {
+        return nullptr;
+    }
+
+    node* n = new (reinterpret_cast<void*>(align_up(reinterpret_cast<std::uintptr_t>(block.ptr), alignof(node)))) node;
+
+    n->storage = block;
+
+    n->next = _head;
+    _head = n;
+    ++_instance_count;
+
+    return n;
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+void cascading_allocator<AllocatorT, ParentAllocatorT>::destroy_node(node* n)
+{
+    memory_block block = n->storage;
+
+    n->~node();
+
+    _parent.deallocate(block);
+}
+
+template<typename AllocatorT, typename ParentAllocatorT>
+void cascading_allocator<AllocatorT, ParentAllocatorT>::unlink_node(node* previous, node* n)
+{
+    (previous ? previous->next : _head) = n->next;
+    --_instance_count;
+}
+
+} // namespace coal
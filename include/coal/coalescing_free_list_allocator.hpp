@@ -0,0 +1,685 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <coal/alignment.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Free list allocator carving its blocks out of chunks of ChunkSizeT bytes taken from the parent allocator, larger
+// chunks being taken for the blocks which do not fit one. Every block starts and ends with a boundary tag holding its
+// size, so a freed block finds its physical neighbours and merges with the free ones in constant time. Free blocks
+// are linked in address order and served first fit, a freed block without a free neighbour walks the list to its
+// place. A chunk left with a single free block goes back to the parent, except for one kept to absorb allocations
+// oscillating around the capacity of a chunk.
+template<typename AllocatorT, std::size_t ChunkSizeT>
+class coalescing_free_list_allocator
+{
+    // lowest bit of a boundary tag, set while the block is allocated
+    static constexpr std::size_t used_bit = 1;
+
+    struct node
+    {
+        // size of the whole block, boundary tags included, repeated in the last word of the block
+        std::size_t tag;
+
+        // only valid while the block is free
+        node* previous_free;
+        node* next_free;
+    };
+
+    struct chunk
+    {
+        chunk* previous;
+        chunk* next;
+        std::size_t size;
+    };
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = sizeof(std::size_t);
+    static constexpr std::size_t chunk_size = ChunkSizeT;
+
+private:
+    static constexpr std::size_t tag_size = sizeof(std::size_t);
+    static constexpr std::size_t min_block_size = sizeof(node) + tag_size;
+
+    // chunk header and the used tags of size zero bounding the blocks of a chunk on both sides
+    static constexpr std::size_t chunk_overhead = sizeof(chunk) + 2 * tag_size;
+
+    static_assert(allocator::alignment >= alignment, "Parent allocator must align chunks at least to a boundary tag.");
+    static_assert(ChunkSizeT >= chunk_overhead + min_block_size, "Chunk size must hold at least one block.");
+
+public:
+    static constexpr std::size_t max_size = std::numeric_limits<std::size_t>::max() / 2;
+
+public:
+    constexpr coalescing_free_list_allocator() = default;
+    ~coalescing_free_list_allocator();
+
+    coalescing_free_list_allocator(const coalescing_free_list_allocator&) = delete;
+    coalescing_free_list_allocator& operator=(const coalescing_free_list_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // payload size of the block serving size, its boundary tags excluded
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    [[nodiscard]] constexpr std::size_t get_chunk_count() const;
+
+    // bytes of the free blocks, boundary tags included
+    [[nodiscard]] constexpr std::size_t get_free_size() const;
+    [[nodiscard]] constexpr std::size_t get_free_block_count() const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+    [[nodiscard]] bool owns(const memory_block& block) const;
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+    void deallocate_all();
+
+private:
+    static constexpr std::size_t block_size(std::size_t size);
+
+    static std::uint8_t* bytes_of(node* b);
+    static std::uint8_t* payload_of(node* b);
+    static node* block_of(const memory_block& block);
+
+    static std::size_t size_of(node* b);
+    static bool is_used(node* b);
+    static void write_tags(node* b, std::size_t size, bool used);
+
+    static node* next_physical(node* b);
+    static std::size_t previous_tag(node* b);
+    static node* previous_physical(node* b);
+
+    // true when b is the only block of its chunk
+    static bool spans_chunk(node* b);
+    static chunk* chunk_of(node* b);
+
+    [[nodiscard]] node* find_free_block(std::size_t size) const;
+
+    void link_free(node* b, node* previous, node* next);
+    void unlink_free(node* b);
+
+    // b takes the place of old in the address ordered list, old must not be linked anymore afterwards
+    void replace_free(node* old, node* b);
+
+    // walks the list to the place of b
+    void insert_free(node* b);
+
+    // hands out the first size bytes of the free block b, the remainder stays free
+    void take(node* b, std::size_t size);
+
+    // frees the used block b, merging it with its free neighbours and releasing its chunk once empty
+    void release(node* b);
+
+    [[nodiscard]] node* acquire_chunk(std::size_t size);
+    void release_chunk(chunk* c);
+
+    node* _free_head{nullptr};
+    std::size_t _free_size{0};
+    std::size_t _free_block_count{0};
+    chunk* _chunks{nullptr};
+    std::size_t _chunk_count{0};
+    std::size_t _empty_chunk_count{0};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::~coalescing_free_list_allocator()
+{
+    deallocate_all();
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::granted_size(std::size_t size) const
+{
+    return block_size(size) - 2 * tag_size;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr const coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::allocator& coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::allocator& coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::get_chunk_count() const
+{
+    return _chunk_count;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::get_free_size() const
+{
+    return _free_size;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::get_free_block_count() const
+{
+    return _free_block_count;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+template<typename Initializer>
+constexpr void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+memory_block coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::allocate(std::size_t size)
+{
+    if (size == 0 || size > max_size)
+    {
+        return nullblk;
+    }
+
+    const std::size_t needed_size = block_size(size);
+    node* b = find_free_block(needed_size);
+
+    if (b)
+    {
+        // the only fully free chunk kept is in use again
+        _empty_chunk_count -= spans_chunk(b) ? 1 : 0;
+    }
+    else if (!(b = acquire_chunk(needed_size)))
+    {
+        return nullblk;
+    }
+
+    take(b, needed_size);
+
+    const memory_block result{payload_of(b), size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, result.ptr);
+
+    return result;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+bool coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::owns(const memory_block& block) const
+{
+    if (!block)
+    {
+        return false;
+    }
+
+    const std::uint8_t* ptr = block.as<std::uint8_t>();
+
+    for (chunk* c = _chunks; c; c = c->next)
+    {
+        const std::uint8_t* begin = reinterpret_cast<const std::uint8_t*>(c);
+
+        if (ptr >= begin && ptr < begin + c->size)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+bool coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    if (new_size > max_size)
+    {
+        return false;
+    }
+
+    node* b = block_of(block);
+    const std::size_t size = size_of(b);
+    const std::size_t needed_size = block_size(new_size);
+
+    if (needed_size > size)
+    {
+        node* next = next_physical(b);
+
+        if (is_used(next) || size + size_of(next) < needed_size)
+        {
+            return false;
+        }
+
+        const std::size_t merged_size = size + size_of(next);
+
+        if (merged_size - needed_size >= min_block_size)
+        {
+            node* remainder = reinterpret_cast<node*>(bytes_of(b) + needed_size);
+
+            replace_free(next, remainder);
+            write_tags(remainder, merged_size - needed_size, false);
+            write_tags(b, needed_size, true);
+
+            _free_size -= needed_size - size;
+        }
+        else
+        {
+            unlink_free(next);
+            write_tags(b, merged_size, true);
+
+            _free_size -= merged_size - size;
+            --_free_block_count;
+        }
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+bool coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    if (new_size > max_size)
+    {
+        return false;
+    }
+
+    if (new_size < block.size)
+    {
+        node* b = block_of(block);
+        const std::size_t size = size_of(b);
+        const std::size_t needed_size = block_size(new_size);
+
+        // shrinks in place, the tail is freed and merges with the following block when free
+        if (size - needed_size >= min_block_size)
+        {
+            node* tail = reinterpret_cast<node*>(bytes_of(b) + needed_size);
+
+            write_tags(b, needed_size, true);
+            write_tags(tail, size - needed_size, true);
+
+            release(tail);
+        }
+
+        block.size = new_size;
+        return true;
+    }
+
+    if (expand(block, new_size - block.size))
+    {
+        return true;
+    }
+
+    if (memory_block new_block = allocate(new_size))
+    {
+        std::memcpy(new_block.ptr, block.ptr, block.size);
+        deallocate(block);
+        block = new_block;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    assert(owns(block));
+
+    release(block_of(block));
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::deallocate_all()
+{
+    while (_chunks)
+    {
+        release_chunk(_chunks);
+    }
+
+    _free_head = nullptr;
+    _free_size = 0;
+    _free_block_count = 0;
+    _empty_chunk_count = 0;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+constexpr std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::block_size(std::size_t size)
+{
+    const std::size_t size_with_tags = align_up(size, alignment) + 2 * tag_size;
+    return size_with_tags < min_block_size ? min_block_size : size_with_tags;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+std::uint8_t* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::bytes_of(node* b)
+{
+    return reinterpret_cast<std::uint8_t*>(b);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+std::uint8_t* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::payload_of(node* b)
+{
+    return bytes_of(b) + tag_size;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::node* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::block_of(const memory_block& block)
+{
+    return reinterpret_cast<node*>(block.as<std::uint8_t>() - tag_size);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::size_of(node* b)
+{
+    return b->tag & ~used_bit;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+bool coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::is_used(node* b)
+{
+    return b->tag & used_bit;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::write_tags(node* b, std::size_t size, bool used)
+{
+    const std::size_t tag = size | (used ? used_bit : 0);
+
+    b->tag = tag;
+    std::memcpy(bytes_of(b) + size - tag_size, &tag, tag_size);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::node* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::next_physical(node* b)
+{
+    return reinterpret_cast<node*>(bytes_of(b) + size_of(b));
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+std::size_t coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::previous_tag(node* b)
+{
+    std::size_t tag;
+    std::memcpy(&tag, bytes_of(b) - tag_size, tag_size);
+    return tag;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::node* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::previous_physical(node* b)
+{
+    return reinterpret_cast<node*>(bytes_of(b) - (previous_tag(b) & ~used_bit));
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+bool coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::spans_chunk(node* b)
+{
+    // only the tags bounding a chunk have a size of zero
+    return previous_tag(b) == used_bit && next_physical(b)->tag == used_bit;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::chunk* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::chunk_of(node* b)
+{
+    assert(previous_tag(b) == used_bit);
+
+    return reinterpret_cast<chunk*>(bytes_of(b) - tag_size - sizeof(chunk));
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::node* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::find_free_block(std::size_t size) const
+{
+    for (node* b = _free_head; b; b = b->next_free)
+    {
+        if (size_of(b) >= size)
+        {
+            return b;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::link_free(node* b, node* previous, node* next)
+{
+    b->previous_free = previous;
+    b->next_free = next;
+
+    (previous ? previous->next_free : _free_head) = b;
+
+    if (next)
+    {
+        next->previous_free = b;
+    }
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::unlink_free(node* b)
+{
+    (b->previous_free ? b->previous_free->next_free : _free_head) = b->next_free;
+
+    if (b->next_free)
+    {
+        b->next_free->previous_free = b->previous_free;
+    }
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::replace_free(node* old, node* b)
+{
+    // b may overlap the links of old
+    node* previous = old->previous_free;
+    node* next = old->next_free;
+
+    link_free(b, previous, next);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::insert_free(node* b)
+{
+    node* previous = nullptr;
+    node* next = _free_head;
+
+    while (next && next < b)
+    {
+        previous = next;
+        next = next->next_free;
+    }
+
+    link_free(b, previous, next);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::take(node* b, std::size_t size)
+{
+    const std::size_t free_size = size_of(b);
+
+    if (free_size - size >= min_block_size)
+    {
+        // the remainder follows b, it keeps the place of b in the list
+        node* remainder = reinterpret_cast<node*>(bytes_of(b) + size);
+
+        replace_free(b, remainder);
+        write_tags(remainder, free_size - size, false);
+        write_tags(b, size, true);
+
+        _free_size -= size;
+    }
+    else
+    {
+        unlink_free(b);
+        write_tags(b, free_size, true);
+
+        _free_size -= free_size;
+        --_free_block_count;
+    }
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::release(node* b)
+{
+    assert(is_used(b));
+
+    const std::size_t size = size_of(b);
+    node* next = next_physical(b);
+
+    _free_size += size;
+
+    if (!(previous_tag(b) & used_bit))
+    {
+        // the previous block grows over b and keeps its place in the list
+        node* previous = previous_physical(b);
+        std::size_t merged_size = size_of(previous) + size;
+
+        if (!is_used(next))
+        {
+            merged_size += size_of(next);
+            unlink_free(next);
+            --_free_block_count;
+        }
+
+        write_tags(previous, merged_size, false);
+        b = previous;
+    }
+    else if (!is_used(next))
+    {
+        // b starts right before next, so it takes its place in the list
+        replace_free(next, b);
+        write_tags(b, size + size_of(next), false);
+    }
+    else
+    {
+        write_tags(b, size, false);
+        insert_free(b);
+        ++_free_block_count;
+    }
+
+    if (!spans_chunk(b))
+    {
+        return;
+    }
+
+    if (_empty_chunk_count > 0)
+    {
+        unlink_free(b);
+
+        _free_size -= size_of(b);
+        --_free_block_count;
+
+        release_chunk(chunk_of(b));
+        return;
+    }
+
+    ++_empty_chunk_count;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::node* coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::acquire_chunk(std::size_t size)
+{
+    // a block too large for a chunk gets a chunk of its own
+    const std::size_t size_with_overhead = size + chunk_overhead;
+    memory_block storage = _allocator.allocate(size_with_overhead > ChunkSizeT ? size_with_overhead : ChunkSizeT);
+
+    if (!storage)
+    {
+        return nullptr;
+    }
+
+    chunk* c = storage.as<chunk>();
+    c->previous = nullptr;
+    c->next = _chunks;
+    c->size = storage.size;
+
+    if (_chunks)
+    {
+        _chunks->previous = c;
+    }
+
+    _chunks = c;
+    ++_chunk_count;
+
+    // one free block between a used tag of size zero on each side, so merging never looks past the chunk
+    std::uint8_t* begin = storage.as<std::uint8_t>() + sizeof(chunk);
+    std::uint8_t* end = storage.as<std::uint8_t>() + align_down(storage.size, alignment);
+
+    std::memcpy(begin, &used_bit, tag_size);
+    std::memcpy(end - tag_size, &used_bit, tag_size);
+
+    node* b = reinterpret_cast<node*>(begin + tag_size);
+    write_tags(b, static_cast<std::size_t>(end - begin) - 2 * tag_size, false);
+
+    insert_free(b);
+
+    _free_size += size_of(b);
+    ++_free_block_count;
+
+    return b;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT>
+void coalescing_free_list_allocator<AllocatorT, ChunkSizeT>::release_chunk(chunk* c)
+{
+    (c->previous ? c->previous->next : _chunks) = c->next;
+
+    if (c->next)
+    {
+        c->next->previous = c->previous;
+    }
+
+    --_chunk_count;
+
+    memory_block storage{c, c->size};
+    _allocator.deallocate(storage);
+}
+
+} // namespace coal
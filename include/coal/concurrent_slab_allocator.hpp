@@ -0,0 +1,361 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+
+#include <coal/alignment.hpp>
+#include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/tagged_pointer.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Lock-free free list of a slab (Treiber stack). The head is a tagged pointer so a pop racing with a pop and push
+// of the same object fails its exchange instead of linking a stale next.
+struct concurrent_slab
+{
+    struct object
+    {
+        object* next;
+    };
+
+    void* allocate()
+    {
+        details::tagged_pointer<object> head = first_free.load(std::memory_order_acquire);
+
+        while (head.ptr)
+        {
+            // the object may already be handed out by another thread, the tag makes the exchange fail if so
+            object* next = std::atomic_ref{head.ptr->next}.load(std::memory_order_relaxed);
+
+            if (first_free.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return head.ptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void deallocate(memory_block& block)
+    {
+        push(static_cast<object*>(block.ptr), static_cast<object*>(block.ptr));
+    }
+
+    // links the chain first..last in front of the free list with a single exchange
+    void push(object* first, object* last)
+    {
+        details::tagged_pointer<object> head = first_free.load(std::memory_order_relaxed);
+
+        do
+        {
+            std::atomic_ref{last->next}.store(head.ptr, std::memory_order_relaxed);
+        } while (!first_free.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    details::atomic_tagged_pointer<object> first_free;
+};
+
+// slab_allocator safe to share between threads without a lock. Allocations and deallocations only exchange the head
+// of a free list, a refill carves a whole chunk and publishes it with one exchange. AllocatorT is called by the
+// threads refilling a slab at the same time and must be thread-safe. Chunks go back to AllocatorT on destruction.
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+class concurrent_slab_allocator
+{
+    struct chunk_header
+    {
+        chunk_header* next;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t header_size = align_up(sizeof(chunk_header), AllocatorT::alignment);
+
+    static_assert(SlabCapacityT > header_size, "Slab capacity must be greater than the chunk header.");
+    static_assert((SlabCapacityT % AllocatorT::alignment) == 0, "Slab capacity must be a multiple of alignment.");
+    static_assert((((SlabSizesT % AllocatorT::alignment) == 0) && ...), "Each allocation size must be a multiple of alignment.");
+    static_assert(((SlabSizesT >= sizeof(void*)) && ...), "Each allocation size must be at least the size of a pointer.");
+    static_assert(((SlabSizesT <= SlabCapacityT - header_size) && ...), "Each allocation size must fit in a chunk.");
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t index_for_size(std::size_t size);
+    static constexpr std::size_t size_at_index(std::size_t index);
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t max_size = size_at_index(sizeof...(SlabSizesT) - 1);
+
+public:
+    concurrent_slab_allocator() = default;
+    ~concurrent_slab_allocator();
+
+    concurrent_slab_allocator(const concurrent_slab_allocator&) = delete;
+    concurrent_slab_allocator& operator=(const concurrent_slab_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    [[nodiscard]] const allocator& get_allocator() const;
+    [[nodiscard]] allocator& get_allocator();
+
+    [[nodiscard]] std::size_t get_chunk_count() const;
+
+    template<typename Initializer>
+    void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] bool owns(const memory_block& block) const;
+
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+
+    // not synchronized, only safe while no other thread uses the allocator
+    void deallocate_all();
+
+private:
+    // returns one object of the new chunk, the others are published to the slab
+    [[nodiscard]] void* allocate_for_slab(concurrent_slab& slab, std::size_t index);
+
+    std::array<concurrent_slab, sizeof...(SlabSizesT)> _slabs{};
+    std::atomic<chunk_header*> _chunks{nullptr};
+    std::atomic<std::size_t> _chunk_count{0};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+constexpr std::size_t concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::index_for_size(std::size_t size)
+{
+    std::size_t index = 0;
+    (..., (index += (SlabSizesT < size ? 1 : 0)));
+    return index;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+constexpr std::size_t concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::size_at_index(std::size_t index)
+{
+    std::size_t size = 0;
+    (..., (size = index-- == 0 ? SlabSizesT : size));
+    return size;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::~concurrent_slab_allocator()
+{
+    deallocate_all();
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+constexpr std::size_t concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+const concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::allocator& concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::allocator& concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+std::size_t concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::get_chunk_count() const
+{
+    return _chunk_count.load(std::memory_order_relaxed);
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+template<typename Initializer>
+void concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+memory_block concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::allocate(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    if (size > max_size)
+    {
+        return nullblk;
+    }
+
+    const std::size_t index = index_for_size(size);
+    concurrent_slab& slab = _slabs[index];
+
+    void* ptr = slab.allocate();
+
+    if (!ptr)
+    {
+        ptr = allocate_for_slab(slab, index);
+
+        if (!ptr)
+        {
+            return nullblk;
+        }
+    }
+
+    const memory_block block{ptr, size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+bool concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::owns(const memory_block& block) const
+{
+    return block.size <= max_size && _allocator.owns(block);
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+bool concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    if (new_size > max_size || index_for_size(new_size) != index_for_size(block.size))
+    {
+        return false;
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+bool concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    if (new_size <= max_size && index_for_size(new_size) == index_for_size(block.size))
+    {
+        block.size = new_size;
+        return true;
+    }
+
+    return details::reallocate_with_new_allocator(*this, *this, block, new_size);
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+void concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    const std::size_t index = index_for_size(block.size);
+
+    if (index >= _slabs.size())
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    _slabs[index].deallocate(block);
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+void concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::deallocate_all()
+{
+    for (concurrent_slab& slab : _slabs)
+    {
+        slab.first_free.store(nullptr, std::memory_order_relaxed);
+    }
+
+    chunk_header* chunk = _chunks.exchange(nullptr, std::memory_order_acquire);
+
+    while (chunk)
+    {
+        chunk_header* next = chunk->next;
+
+        memory_block block{chunk, chunk->size};
+        _allocator.deallocate(block);
+
+        chunk = next;
+    }
+
+    _chunk_count.store(0, std::memory_order_relaxed);
+}
+
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+void* concurrent_slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::allocate_for_slab(concurrent_slab& slab, std::size_t index)
+{
+    memory_block block = _allocator.allocate(SlabCapacityT);
+
+    if (!block)
+    {
+        return nullptr;
+    }
+
+    const std::size_t object_size = size_at_index(index);
+    const std::size_t objects_count = (block.size - header_size) / object_size;
+
+    COAL_USDT_ALLOCATOR_PROBE(slab_refill, object_size, block.ptr, block.size);
+
+    auto* header = block.as<chunk_header>();
+    header->size = block.size;
+    header->next = _chunks.load(std::memory_order_relaxed);
+
+    while (!_chunks.compare_exchange_weak(header->next, header, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+
+    _chunk_count.fetch_add(1, std::memory_order_relaxed);
+
+    // the chunk is private until published, its objects are linked without atomics
+    std::uint8_t* objects = block.as<std::uint8_t>() + header_size;
+
+    for (std::size_t i = 1; i + 1 < objects_count; ++i)
+    {
+        reinterpret_cast<concurrent_slab::object*>(objects + i * object_size)->next = reinterpret_cast<concurrent_slab::object*>(objects + (i + 1) * object_size);
+    }
+
+    if (objects_count > 1)
+    {
+        slab.push(reinterpret_cast<concurrent_slab::object*>(objects + object_size), reinterpret_cast<concurrent_slab::object*>(objects + (objects_count - 1) * object_size));
+    }
+
+    return objects;
+}
+
+} // namespace coal
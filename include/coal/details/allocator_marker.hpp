@@ -0,0 +1,50 @@
+#pragma once
+
+#include <coal/allocator_traits.hpp>
+
+namespace coal::details {
+
+// stands for the marker of an allocator without mark, so a composite can mark the children which have one
+struct no_marker
+{
+};
+
+template<typename AllocatorT>
+struct marker_of
+{
+    using type = no_marker;
+};
+
+template<typename AllocatorT>
+requires(allocator_traits::has_mark<AllocatorT>)
+struct marker_of<AllocatorT>
+{
+    using type = typename AllocatorT::marker;
+};
+
+template<typename AllocatorT>
+using marker_of_t = typename marker_of<AllocatorT>::type;
+
+template<typename AllocatorT>
+constexpr marker_of_t<AllocatorT> try_mark(const AllocatorT& allocator)
+{
+    if constexpr (allocator_traits::has_mark<AllocatorT>)
+    {
+        return allocator.mark();
+    }
+    else
+    {
+        return {};
+    }
+}
+
+template<typename AllocatorT>
+constexpr void try_rewind(AllocatorT& allocator, const marker_of_t<AllocatorT>& marker)
+{
+    if constexpr (allocator_traits::has_mark<AllocatorT>)
+    {
+        allocator.rewind(marker);
+    }
+}
+
+} // namespace coal::details
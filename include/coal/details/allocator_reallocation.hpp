@@ -40,7 +40,7 @@ constexpr bool reallocate_with_new_allocator(OriginalAllocatorT& original_alloca
 {
     if (memory_block new_block = new_allocator.allocate(new_size))
     {
-        std::memcpy(new_block.ptr, block.ptr, block.size);
+        std::memcpy(new_block.ptr, block.ptr, block.size < new_size ? block.size : new_size);
         original_allocator.deallocate(block);
         block = new_block;
 
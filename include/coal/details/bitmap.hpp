@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace coal::details {
+
+// Fixed size bitmap with word scans: countr_zero within a word, AVX2 or SSE2 to skip whole words.
+template<std::size_t BitCountT>
+class bitmap
+{
+    static_assert(BitCountT > 0, "Bitmap must hold at least one bit.");
+
+public:
+    using word = std::uint64_t;
+
+    static constexpr std::size_t word_bits = 64;
+    static constexpr std::size_t word_count = (BitCountT + word_bits - 1) / word_bits;
+    static constexpr std::size_t bit_count = BitCountT;
+    static constexpr std::size_t npos = ~std::size_t{0};
+
+public:
+    [[nodiscard]] constexpr bool test(std::size_t index) const;
+
+    constexpr void set(std::size_t first, std::size_t count);
+    constexpr void reset(std::size_t first, std::size_t count);
+
+    constexpr void set_all();
+    constexpr void reset_all();
+
+    // first set bit at or after first, npos when none
+    [[nodiscard]] constexpr std::size_t find_first_set(std::size_t first) const;
+
+    // first reset bit at or after first, bit_count when none
+    [[nodiscard]] constexpr std::size_t find_first_reset(std::size_t first) const;
+
+    // first run of count set bits starting at or after first, npos when none
+    [[nodiscard]] constexpr std::size_t find_set_run(std::size_t first, std::size_t count) const;
+
+    // length of the run of set bits at first, counting stops once count is reached
+    [[nodiscard]] constexpr std::size_t count_set_run(std::size_t first, std::size_t count) const;
+
+private:
+    static constexpr word last_word_mask = BitCountT % word_bits ? (word{1} << (BitCountT % word_bits)) - 1 : ~word{0};
+
+    // index of the first word in [first, word_count) not equal to flip, word_count when none
+    [[nodiscard]] constexpr std::size_t find_word(std::size_t first, word flip) const;
+
+    template<bool ValueT>
+    constexpr void assign(std::size_t first, std::size_t count);
+
+    template<bool ValueT>
+    [[nodiscard]] constexpr std::size_t find_first(std::size_t first) const;
+
+    std::array<word, word_count> _words{};
+};
+
+template<std::size_t BitCountT>
+constexpr bool bitmap<BitCountT>::test(std::size_t index) const
+{
+    return (_words[index / word_bits] >> (index % word_bits)) & 1;
+}
+
+template<std::size_t BitCountT>
+constexpr void bitmap<BitCountT>::set(std::size_t first, std::size_t count)
+{
+    assign<true>(first, count);
+}
+
+template<std::size_t BitCountT>
+constexpr void bitmap<BitCountT>::reset(std::size_t first, std::size_t count)
+{
+    assign<false>(first, count);
+}
+
+template<std::size_t BitCountT>
+constexpr void bitmap<BitCountT>::set_all()
+{
+    _words.fill(~word{0});
+    _words.back() = last_word_mask;
+}
+
+template<std::size_t BitCountT>
+constexpr void bitmap<BitCountT>::reset_all()
+{
+    _words.fill(0);
+}
+
+template<std::size_t BitCountT>
+constexpr std::size_t bitmap<BitCountT>::find_first_set(std::size_t first) const
+{
+    return find_first<true>(first);
+}
+
+template<std::size_t BitCountT>
+constexpr std::size_t bitmap<BitCountT>::find_first_reset(std::size_t first) const
+{
+    const std::size_t index = find_first<false>(first);
+    return index < BitCountT ? index : BitCountT;
+}
+
+template<std::size_t BitCountT>
+constexpr std::size_t bitmap<BitCountT>::find_set_run(std::size_t first, std::size_t count) const
+{
+    if (first >= BitCountT || count == 0)
+    {
+        return npos;
+    }
+
+    for (std::size_t index = first / word_bits; index < word_count; index = find_word(index + 1, 0))
+    {
+        const word bits = index == first / word_bits ? _words[index] & (~word{0} << (first % word_bits)) : _words[index];
+
+        // runs held within the word: a bit stays set when the count - 1 bits above it are set too
+        if (count <= word_bits)
+        {
+            word starts = bits;
+
+            for (std::size_t length = 1; length < count && starts;)
+            {
+                const std::size_t shift = length < count - length ? length : count - length;
+
+                starts &= starts >> shift;
+                length += shift;
+            }
+
+            if (starts)
+            {
+                return index * word_bits + static_cast<std::size_t>(std::countr_zero(starts));
+            }
+        }
+
+        // a run reaching the top of the word may go on in the next ones
+        if (const std::size_t top = static_cast<std::size_t>(std::countl_one(bits)); top > 0 && index + 1 < word_count)
+        {
+            const std::size_t start = (index + 1) * word_bits - top;
+
+            if (top + count_set_run((index + 1) * word_bits, count - top) >= count)
+            {
+                return start;
+            }
+        }
+    }
+
+    return npos;
+}
+
+template<std::size_t BitCountT>
+constexpr std::size_t bitmap<BitCountT>::count_set_run(std::size_t first, std::size_t count) const
+{
+    std::size_t length = 0;
+
+    while (length < count)
+    {
+        const std::size_t index = first + length;
+        const std::size_t offset = index % word_bits;
+        const std::size_t ones = static_cast<std::size_t>(std::countr_one(_words[index / word_bits] >> offset));
+
+        // the shift fills the word with zeros, ones past them belong to the next word
+        length += ones < word_bits - offset ? ones : word_bits - offset;
+
+        if (ones < word_bits - offset || index / word_bits + 1 == word_count)
+        {
+            break;
+        }
+    }
+
+    return length;
+}
+
+template<std::size_t BitCountT>
+constexpr std::size_t bitmap<BitCountT>::find_word(std::size_t first, word flip) const
+{
+    std::size_t index = first;
+
+    if (!std::is_constant_evaluated())
+    {
+#if defined(__AVX2__)
+        const __m256i flip_vector = _mm256_set1_epi64x(static_cast<long long>(flip));
+
+        for (; index + 4 <= word_count; index += 4)
+        {
+            const __m256i words = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_words[index])), flip_vector);
+
+            if (!_mm256_testz_si256(words, words))
+            {
+                break;
+            }
+        }
+#elif defined(__SSE2__)
+        const __m128i flip_vector = _mm_set1_epi64x(static_cast<long long>(flip));
+
+        for (; index + 2 <= word_count; index += 2)
+        {
+            const __m128i words = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&_words[index])), flip_vector);
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(words, _mm_setzero_si128())) != 0xFFFF)
+            {
+                break;
+            }
+        }
+#endif
+    }
+
+    for (; index < word_count; ++index)
+    {
+        if (_words[index] != flip)
+        {
+            break;
+        }
+    }
+
+    return index;
+}
+
+template<std::size_t BitCountT>
+template<bool ValueT>
+constexpr void bitmap<BitCountT>::assign(std::size_t first, std::size_t count)
+{
+    while (count > 0)
+    {
+        const std::size_t offset = first % word_bits;
+        const std::size_t length = count < word_bits - offset ? count : word_bits - offset;
+        const word mask = (length == word_bits ? ~word{0} : (word{1} << length) - 1) << offset;
+
+        if constexpr (ValueT)
+        {
+            _words[first / word_bits] |= mask;
+        }
+        else
+        {
+            _words[first / word_bits] &= ~mask;
+        }
+
+        first += length;
+        count -= length;
+    }
+}
+
+template<std::size_t BitCountT>
+template<bool ValueT>
+constexpr std::size_t bitmap<BitCountT>::find_first(std::size_t first) const
+{
+    constexpr word flip = ValueT ? 0 : ~word{0};
+
+    if (first >= BitCountT)
+    {
+        return npos;
+    }
+
+    std::size_t index = first / word_bits;
+
+    // the bits before first are masked out of the first word
+    if (const word bits = (_words[index] ^ flip) & (~word{0} << (first % word_bits)))
+    {
+        return index * word_bits + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+
+    index = find_word(index + 1, flip);
+
+    return index < word_count ? index * word_bits + static_cast<std::size_t>(std::countr_zero(_words[index] ^ flip)) : npos;
+}
+
+} // namespace coal::details
@@ -0,0 +1,20 @@
+#pragma once
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace coal::details {
+
+// Hints the CPU that the caller is spinning on a memory location, freeing resources for the sibling hyperthread and
+// avoiding the memory order violation penalty when the spin exits.
+inline void cpu_relax()
+{
+#if defined(__SSE2__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace coal::details
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#endif
+
+namespace coal::details {
+
+// glibc 2.35 registers an rseq area for every thread, the kernel keeps its cpu_id up to date on every migration
+#if defined(__GLIBC_HAVE_KERNEL_RSEQ) && defined(__has_builtin)
+#if __has_builtin(__builtin_thread_pointer)
+#define COAL_HAS_RSEQ 1
+#endif
+#endif
+
+// CPU the calling thread runs on, read from the rseq area without a system call when glibc registered one and with
+// sched_getcpu otherwise. The thread may migrate right after, the result is only a hint.
+inline std::size_t current_cpu()
+{
+#if defined(COAL_HAS_RSEQ)
+    if (__rseq_size > 0)
+    {
+        const auto* area = reinterpret_cast<const volatile struct rseq*>(static_cast<const char*>(__builtin_thread_pointer()) + __rseq_offset);
+        const auto cpu = static_cast<std::int32_t>(area->cpu_id);
+
+        if (cpu >= 0)
+        {
+            return static_cast<std::size_t>(cpu);
+        }
+    }
+#endif
+
+#if defined(__linux__)
+    if (const int cpu = sched_getcpu(); cpu >= 0)
+    {
+        return static_cast<std::size_t>(cpu);
+    }
+#endif
+
+    return 0;
+}
+
+// CPUs configured on the machine, including the offline ones which may come online later
+inline std::size_t cpu_count()
+{
+#if defined(__linux__)
+    if (const long count = sysconf(_SC_NPROCESSORS_CONF); count > 0)
+    {
+        return static_cast<std::size_t>(count);
+    }
+#endif
+
+    return 1;
+}
+
+} // namespace coal::details
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+#include <coal/allocator_traits.hpp>
+
+namespace coal::details {
+
+// bytes AllocatorT reserves for a block of size, size itself when the allocator does not round
+template<typename AllocatorT>
+constexpr std::size_t granted_size(const AllocatorT& allocator, std::size_t size)
+{
+    if constexpr (allocator_traits::has_granted_size<AllocatorT>)
+    {
+        return allocator.granted_size(size);
+    }
+    else
+    {
+        return size;
+    }
+}
+
+} // namespace coal::details
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <sys/mman.h>
+
+namespace coal::details {
+
+struct mapping
+{
+    [[nodiscard]] constexpr bool contains(const void* address, std::size_t size) const;
+
+    void* ptr{nullptr};
+    std::size_t length{0};
+};
+
+constexpr bool mapping::contains(const void* address, std::size_t size) const
+{
+    const std::byte* begin = static_cast<const std::byte*>(ptr);
+    const std::byte* first = static_cast<const std::byte*>(address);
+
+    return first >= begin && first < begin + length && size <= static_cast<std::size_t>(begin + length - first);
+}
+
+// Mappings sorted by address, stored in pages mapped for the table so it never goes through malloc.
+class mapping_table
+{
+public:
+    mapping_table() = default;
+    ~mapping_table();
+
+    mapping_table(const mapping_table&) = delete;
+    mapping_table& operator=(const mapping_table&) = delete;
+
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] const mapping* begin() const;
+    [[nodiscard]] const mapping* end() const;
+    [[nodiscard]] mapping* begin();
+    [[nodiscard]] mapping* end();
+
+    // mapping starting at ptr, nullptr when none
+    [[nodiscard]] mapping* find(const void* ptr);
+
+    // mapping holding [ptr, ptr + size), nullptr when none
+    [[nodiscard]] const mapping* find_containing(const void* ptr, std::size_t size) const;
+
+    bool insert(const mapping& mapping);
+    void erase(mapping* mapping);
+    void clear();
+
+private:
+    [[nodiscard]] std::size_t lower_bound(const void* ptr) const;
+
+    bool grow();
+
+    mapping* _mappings{nullptr};
+    std::size_t _size{0};
+    std::size_t _capacity{0};
+};
+
+inline mapping_table::~mapping_table()
+{
+    if (_mappings != nullptr)
+    {
+        munmap(_mappings, _capacity * sizeof(mapping));
+    }
+}
+
+inline std::size_t mapping_table::size() const
+{
+    return _size;
+}
+
+inline const mapping* mapping_table::begin() const
+{
+    return _mappings;
+}
+
+inline const mapping* mapping_table::end() const
+{
+    return _mappings + _size;
+}
+
+inline mapping* mapping_table::begin()
+{
+    return _mappings;
+}
+
+inline mapping* mapping_table::end()
+{
+    return _mappings + _size;
+}
+
+inline mapping* mapping_table::find(const void* ptr)
+{
+    const std::size_t index = lower_bound(ptr);
+    return index < _size && _mappings[index].ptr == ptr ? &_mappings[index] : nullptr;
+}
+
+inline const mapping* mapping_table::find_containing(const void* ptr, std::size_t size) const
+{
+    // the candidate is the last mapping starting at or before ptr
+    const std::size_t index = lower_bound(ptr);
+
+    if (index < _size && _mappings[index].ptr == ptr)
+    {
+        return _mappings[index].contains(ptr, size) ? &_mappings[index] : nullptr;
+    }
+
+    return index > 0 && _mappings[index - 1].contains(ptr, size) ? &_mappings[index - 1] : nullptr;
+}
+
+inline bool mapping_table::insert(const mapping& mapping)
+{
+    if (_size == _capacity && !grow())
+    {
+        return false;
+    }
+
+    const std::size_t index = lower_bound(mapping.ptr);
+
+    std::memmove(_mappings + index + 1, _mappings + index, (_size - index) * sizeof(details::mapping));
+    _mappings[index] = mapping;
+    ++_size;
+
+    return true;
+}
+
+inline void mapping_table::erase(mapping* mapping)
+{
+    const std::size_t index = static_cast<std::size_t>(mapping - _mappings);
+
+    std::memmove(_mappings + index, _mappings + index + 1, (_size - index - 1) * sizeof(details::mapping));
+    --_size;
+}
+
+inline void mapping_table::clear()
+{
+    _size = 0;
+}
+
+inline std::size_t mapping_table::lower_bound(const void* ptr) const
+{
+    std::size_t first = 0;
+    std::size_t count = _size;
+
+    while (count > 0)
+    {
+        const std::size_t half = count / 2;
+
+        if (static_cast<const std::byte*>(_mappings[first + half].ptr) < static_cast<const std::byte*>(ptr))
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+
+    return first;
+}
+
+inline bool mapping_table::grow()
+{
+    constexpr std::size_t initial_bytes = 0x1000;
+
+    const std::size_t bytes = _capacity * sizeof(mapping);
+    const std::size_t new_bytes = bytes ? bytes * 2 : initial_bytes;
+
+    void* ptr = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (ptr == MAP_FAILED)
+    {
+        return false;
+    }
+
+    if (_mappings != nullptr)
+    {
+        std::memcpy(ptr, _mappings, _size * sizeof(mapping));
+        munmap(_mappings, bytes);
+    }
+
+    _mappings = static_cast<mapping*>(ptr);
+    _capacity = new_bytes / sizeof(mapping);
+
+    return true;
+}
+
+} // namespace coal::details
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+
+namespace coal::details {
+
+// Bucket of size in a log2 histogram of BucketCountT buckets: bucket 0 counts zero sizes, bucket i counts sizes in
+// [2^(i-1), 2^i) and the last bucket also counts every larger size.
+template<std::size_t BucketCountT>
+constexpr std::size_t size_histogram_bucket(std::size_t size)
+{
+    static_assert(BucketCountT >= 2, "A size histogram needs at least two buckets.");
+
+    const std::size_t bucket = static_cast<std::size_t>(std::bit_width(size));
+    return bucket < BucketCountT ? bucket : BucketCountT - 1;
+}
+
+} // namespace coal::details
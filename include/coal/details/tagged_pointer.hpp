@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace coal::details {
+
+template<typename T>
+struct tagged_pointer
+{
+    T* ptr{nullptr};
+    std::uintptr_t tag{0};
+
+    constexpr bool operator==(const tagged_pointer& other) const = default;
+};
+
+// Pointer and tag swapped together by one compare-and-swap. Every exchange bumps the tag, so a pointer popped and
+// pushed back between a load and an exchange no longer compares equal (ABA). Uses a double-width compare-and-swap
+// when the target has a lock-free one, otherwise packs the pointer and a narrower tag in a 64-bit word.
+template<typename T>
+class atomic_tagged_pointer
+{
+public:
+    static constexpr bool is_wide = std::atomic<tagged_pointer<T>>::is_always_lock_free;
+
+    // user space pointers fit in 48 bits on x86-64 and aarch64
+    static constexpr std::size_t pointer_bits = is_wide ? sizeof(T*) * 8 : (sizeof(T*) == 4 ? 32 : 48);
+    static constexpr std::uintptr_t tag_mask = is_wide ? ~std::uintptr_t{0} : (std::uint64_t{1} << (64 - pointer_bits)) - 1;
+
+public:
+    [[nodiscard]] tagged_pointer<T> load(std::memory_order order) const;
+
+    // replaces expected by ptr with the next tag, expected is reloaded on failure
+    bool compare_exchange_weak(tagged_pointer<T>& expected, T* ptr, std::memory_order success, std::memory_order failure);
+
+    void store(T* ptr, std::memory_order order);
+
+private:
+    using storage = std::conditional_t<is_wide, tagged_pointer<T>, std::uint64_t>;
+
+    [[nodiscard]] static storage pack(const tagged_pointer<T>& value);
+    [[nodiscard]] static tagged_pointer<T> unpack(storage value);
+
+    std::atomic<storage> _value{};
+};
+
+template<typename T>
+tagged_pointer<T> atomic_tagged_pointer<T>::load(std::memory_order order) const
+{
+    return unpack(_value.load(order));
+}
+
+template<typename T>
+bool atomic_tagged_pointer<T>::compare_exchange_weak(tagged_pointer<T>& expected, T* ptr, std::memory_order success, std::memory_order failure)
+{
+    storage current = pack(expected);
+
+    if (_value.compare_exchange_weak(current, pack({ptr, (expected.tag + 1) & tag_mask}), success, failure))
+    {
+        return true;
+    }
+
+    expected = unpack(current);
+    return false;
+}
+
+template<typename T>
+void atomic_tagged_pointer<T>::store(T* ptr, std::memory_order order)
+{
+    _value.store(pack({ptr, 0}), order);
+}
+
+template<typename T>
+atomic_tagged_pointer<T>::storage atomic_tagged_pointer<T>::pack(const tagged_pointer<T>& value)
+{
+    if constexpr (is_wide)
+    {
+        return value;
+    }
+    else
+    {
+        const auto address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value.ptr));
+
+        assert((address >> pointer_bits) == 0);
+
+        return address | (static_cast<std::uint64_t>(value.tag) << pointer_bits);
+    }
+}
+
+template<typename T>
+tagged_pointer<T> atomic_tagged_pointer<T>::unpack(storage value)
+{
+    if constexpr (is_wide)
+    {
+        return value;
+    }
+    else
+    {
+        const std::uint64_t address = value & ((std::uint64_t{1} << pointer_bits) - 1);
+
+        return {reinterpret_cast<T*>(static_cast<std::uintptr_t>(address)), static_cast<std::uintptr_t>(value >> pointer_bits)};
+    }
+}
+
+} // namespace coal::details
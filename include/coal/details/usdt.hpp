@@ -0,0 +1,161 @@
+#pragma once
+
+// USDT probes for bpftrace, perf or systemtap, compiled out unless COAL_ENABLE_USDT is defined.
+// Every probe is in the "coal" provider and starts with the allocator type name and instance:
+//   allocate(type, allocator, size, ptr)
+//   deallocate(type, allocator, size, ptr)
+//   reallocate(type, allocator, old_ptr, old_size, new_ptr, new_size, success)
+//   expand(type, allocator, ptr, old_size, delta, success)
+//   slab_refill(type, allocator, object_size, slab_ptr, slab_size)
+//   free_list_hit(type, allocator, size, ptr, search_length)
+//   free_list_miss(type, allocator, size, search_length)
+// e.g. bpftrace -e 'usdt:./service:coal:slab_refill { @[str(arg0)] = count(); }'
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace coal::details {
+
+// returns a plain pointer, a std::string_view would be listed after T in the signature by gcc
+template<typename T>
+constexpr const char* usdt_pretty_function()
+{
+    return __PRETTY_FUNCTION__;
+}
+
+// the name of T cut out of "... [with T = name]" (gcc) or "... [T = name]" (clang), null terminated
+template<typename T>
+constexpr auto usdt_extract_type_name()
+{
+    constexpr std::string_view pretty = usdt_pretty_function<T>();
+    constexpr std::size_t prefix = pretty.find("T = ");
+    static_assert(prefix != std::string_view::npos, "Unexpected __PRETTY_FUNCTION__ format.");
+
+    constexpr std::size_t first = prefix + 4;
+    constexpr std::size_t last = pretty.find(';', first) != std::string_view::npos ? pretty.find(';', first) : pretty.rfind(']');
+    static_assert(last != std::string_view::npos && first <= last, "Unexpected __PRETTY_FUNCTION__ format.");
+
+    std::array<char, last - first + 1> name{};
+    for (std::size_t i = 0; i < last - first; ++i)
+    {
+        name[i] = pretty[first + i];
+    }
+    return name;
+}
+
+template<typename T>
+inline constexpr auto usdt_type_name_storage = usdt_extract_type_name<T>();
+
+// static string holding only the name of T, so the str() keys of bpftrace tell the types apart
+template<typename T>
+constexpr const char* usdt_type_name()
+{
+    return usdt_type_name_storage<T>.data();
+}
+
+} // namespace coal::details
+
+#if defined(COAL_ENABLE_USDT)
+
+#if !__has_include(<sys/sdt.h>)
+#error "COAL_ENABLE_USDT requires <sys/sdt.h>, install systemtap-sdt-dev or systemtap-sdt-devel"
+#endif
+
+#include <sys/sdt.h>
+#include <type_traits>
+
+#include <coal/memory_block.hpp>
+
+#define COAL_USDT_ENABLED 1
+
+// probes are inline assembly, they cannot be part of a constant evaluation
+#define COAL_USDT_PROBE(name, ...)                  \
+    do                                              \
+    {                                               \
+        if (!std::is_constant_evaluated())          \
+        {                                           \
+            STAP_PROBEV(coal, name, __VA_ARGS__);   \
+        }                                           \
+    } while (0)
+
+// probe of a member function, prepends the allocator type name and this
+#define COAL_USDT_ALLOCATOR_PROBE(name, ...) COAL_USDT_PROBE(name, ::coal::details::usdt_type_name<std::remove_cvref_t<decltype(*this)>>(), this, __VA_ARGS__)
+
+// fire the reallocate or expand probe when the member function returns, whatever the return path
+#define COAL_USDT_REALLOCATE_SCOPE(block, new_size) ::coal::details::usdt_reallocate_scope<std::remove_cvref_t<decltype(*this)>> coal_usdt_scope_{this, block, new_size}
+#define COAL_USDT_EXPAND_SCOPE(block, delta) ::coal::details::usdt_expand_scope<std::remove_cvref_t<decltype(*this)>> coal_usdt_scope_{this, block, delta}
+
+namespace coal::details {
+
+// a reallocate succeeded when the block has its new size, it is left untouched otherwise
+template<typename AllocatorT>
+struct usdt_reallocate_scope
+{
+    constexpr usdt_reallocate_scope(const AllocatorT* allocator, const memory_block& block, std::size_t new_size)
+        : allocator{allocator}
+        , block{block}
+        , old_block{block}
+        , new_size{new_size}
+    {}
+
+    constexpr ~usdt_reallocate_scope()
+    {
+        COAL_USDT_PROBE(reallocate, usdt_type_name<AllocatorT>(), allocator, old_block.ptr, old_block.size, block.ptr, block.size, block.size == new_size);
+    }
+
+    const AllocatorT* allocator;
+    const memory_block& block;
+    memory_block old_block;
+    std::size_t new_size;
+};
+
+// an expand succeeded when the block grew by delta
+template<typename AllocatorT>
+struct usdt_expand_scope
+{
+    constexpr usdt_expand_scope(const AllocatorT* allocator, const memory_block& block, std::size_t delta)
+        : allocator{allocator}
+        , block{block}
+        , old_block{block}
+        , delta{delta}
+    {}
+
+    constexpr ~usdt_expand_scope()
+    {
+        COAL_USDT_PROBE(expand, usdt_type_name<AllocatorT>(), allocator, old_block.ptr, old_block.size, delta, block.size == old_block.size + delta);
+    }
+
+    const AllocatorT* allocator;
+    const memory_block& block;
+    memory_block old_block;
+    std::size_t delta;
+};
+
+} // namespace coal::details
+
+#else
+
+#define COAL_USDT_ENABLED 0
+
+#define COAL_USDT_PROBE(name, ...) \
+    do                             \
+    {                              \
+    } while (0)
+
+#define COAL_USDT_ALLOCATOR_PROBE(name, ...) \
+    do                                       \
+    {                                        \
+    } while (0)
+
+#define COAL_USDT_REALLOCATE_SCOPE(block, new_size) \
+    do                                              \
+    {                                               \
+    } while (0)
+
+#define COAL_USDT_EXPAND_SCOPE(block, delta) \
+    do                                       \
+    {                                        \
+    } while (0)
+
+#endif
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <coal/alignment.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Stack growing from both ends of one buffer: allocate and allocate_low bump up from the bottom, allocate_high bumps
+// down from the top, the two ends meet when the buffer is full. Each end is freed and rewound on its own.
+template<std::size_t SizeT, std::size_t AlignmentT = default_alignment>
+class double_ended_stack_allocator
+{
+    static_assert((SizeT % AlignmentT) == 0, "Size must be a multiple of alignment.");
+
+public:
+    static constexpr std::size_t alignment = AlignmentT;
+    static constexpr std::size_t max_size = SizeT;
+
+    struct low_marker
+    {
+        std::uint8_t* ptr{nullptr};
+    };
+
+    struct high_marker
+    {
+        std::uint8_t* ptr{nullptr};
+    };
+
+    struct marker
+    {
+        low_marker low;
+        high_marker high;
+    };
+
+public:
+    constexpr std::size_t get_alignment() const;
+
+    // bytes left between the two ends
+    [[nodiscard]] constexpr std::size_t get_free_size() const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+    [[nodiscard]] constexpr memory_block allocate_low(std::size_t size);
+    [[nodiscard]] constexpr memory_block allocate_high(std::size_t size);
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+
+    // only the last block of the low end grows in place
+    constexpr bool expand(memory_block& block, std::size_t delta);
+
+    // a block moving to grow stays on its end, the last high block shrinks toward the top
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+    constexpr void deallocate_all();
+    constexpr void deallocate_all_low();
+    constexpr void deallocate_all_high();
+
+    [[nodiscard]] constexpr marker mark() const;
+    [[nodiscard]] constexpr low_marker mark_low() const;
+    [[nodiscard]] constexpr high_marker mark_high() const;
+
+    // invalidates the markers of the same end taken after this one
+    constexpr void rewind(const marker& marker);
+    constexpr void rewind_low(const low_marker& marker);
+    constexpr void rewind_high(const high_marker& marker);
+
+private:
+    [[nodiscard]] constexpr bool is_high_block(const memory_block& block) const;
+    [[nodiscard]] constexpr bool is_last_low_block(const memory_block& block) const;
+    [[nodiscard]] constexpr bool is_last_high_block(const memory_block& block) const;
+
+private:
+    alignas(AlignmentT) std::uint8_t _data[SizeT];
+    std::uint8_t* _low{_data};
+    std::uint8_t* _high{_data + SizeT};
+};
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr std::size_t double_ended_stack_allocator<SizeT, AlignmentT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr std::size_t double_ended_stack_allocator<SizeT, AlignmentT>::get_free_size() const
+{
+    return static_cast<std::size_t>(_high - _low);
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+template<typename Initializer>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::init(Initializer& initializer)
+{
+    initializer.init(*this);
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr memory_block double_ended_stack_allocator<SizeT, AlignmentT>::allocate(std::size_t size)
+{
+    return allocate_low(size);
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr memory_block double_ended_stack_allocator<SizeT, AlignmentT>::allocate_low(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    const std::size_t aligned_size = align_up(size, alignment);
+
+    if (aligned_size > get_free_size())
+    {
+        return nullblk;
+    }
+
+    memory_block block{_low, size};
+
+    _low += aligned_size;
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr memory_block double_ended_stack_allocator<SizeT, AlignmentT>::allocate_high(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    const std::size_t aligned_size = align_up(size, alignment);
+
+    if (aligned_size > get_free_size())
+    {
+        return nullblk;
+    }
+
+    _high -= aligned_size;
+
+    memory_block block{_high, size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr bool double_ended_stack_allocator<SizeT, AlignmentT>::owns(const memory_block& block) const
+{
+    return block && block.ptr >= _data && block.ptr < _data + SizeT;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr bool double_ended_stack_allocator<SizeT, AlignmentT>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    if (!is_last_low_block(block))
+    {
+        return false;
+    }
+
+    const std::size_t aligned_new_size = align_up(block.size + delta, alignment);
+
+    if (aligned_new_size > static_cast<std::size_t>(_high - block.as<std::uint8_t>()))
+    {
+        return false;
+    }
+
+    _low = block.as<std::uint8_t>() + aligned_new_size;
+    block.size += delta;
+
+    return true;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr bool double_ended_stack_allocator<SizeT, AlignmentT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    const std::size_t aligned_new_size = align_up(new_size, alignment);
+
+    if (is_last_low_block(block))
+    {
+        if (aligned_new_size <= static_cast<std::size_t>(_high - block.as<std::uint8_t>()))
+        {
+            block.size = new_size;
+            _low = block.as<std::uint8_t>() + aligned_new_size;
+            return true;
+        }
+        return false; // oom
+    }
+
+    if (is_last_high_block(block))
+    {
+        // the last high block grows down over the free space or shrinks up, its end stays in place
+        std::uint8_t* end = block.as<std::uint8_t>() + align_up(block.size, alignment);
+
+        if (aligned_new_size <= static_cast<std::size_t>(end - _low))
+        {
+            _high = end - aligned_new_size;
+            std::memmove(_high, block.ptr, new_size < block.size ? new_size : block.size);
+            block = {_high, new_size};
+            return true;
+        }
+        return false; // oom
+    }
+
+    if (aligned_new_size <= align_up(block.size, alignment))
+    {
+        block.size = new_size;
+        return true;
+    }
+
+    if (memory_block new_block = is_high_block(block) ? allocate_high(new_size) : allocate_low(new_size))
+    {
+        std::memcpy(new_block.ptr, block.ptr, block.size);
+        deallocate(block);
+        block = new_block;
+        return true;
+    }
+
+    return false;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    if (is_last_low_block(block))
+    {
+        _low = block.as<std::uint8_t>();
+    }
+    else if (is_last_high_block(block))
+    {
+        _high = block.as<std::uint8_t>() + align_up(block.size, alignment);
+    }
+
+    block = nullblk;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::deallocate_all()
+{
+    deallocate_all_low();
+    deallocate_all_high();
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::deallocate_all_low()
+{
+    _low = _data;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::deallocate_all_high()
+{
+    _high = _data + SizeT;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr double_ended_stack_allocator<SizeT, AlignmentT>::marker double_ended_stack_allocator<SizeT, AlignmentT>::mark() const
+{
+    return {mark_low(), mark_high()};
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr double_ended_stack_allocator<SizeT, AlignmentT>::low_marker double_ended_stack_allocator<SizeT, AlignmentT>::mark_low() const
+{
+    return {_low};
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr double_ended_stack_allocator<SizeT, AlignmentT>::high_marker double_ended_stack_allocator<SizeT, AlignmentT>::mark_high() const
+{
+    return {_high};
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::rewind(const marker& marker)
+{
+    rewind_low(marker.low);
+    rewind_high(marker.high);
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::rewind_low(const low_marker& marker)
+{
+    assert(marker.ptr >= _data && marker.ptr <= _low);
+
+    _low = marker.ptr;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void double_ended_stack_allocator<SizeT, AlignmentT>::rewind_high(const high_marker& marker)
+{
+    assert(marker.ptr >= _high && marker.ptr <= _data + SizeT);
+
+    _high = marker.ptr;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr bool double_ended_stack_allocator<SizeT, AlignmentT>::is_high_block(const memory_block& block) const
+{
+    return block.as<std::uint8_t>() >= _high;
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr bool double_ended_stack_allocator<SizeT, AlignmentT>::is_last_low_block(const memory_block& block) const
+{
+    return _low == block.as<std::uint8_t>() + align_up(block.size, alignment);
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr bool double_ended_stack_allocator<SizeT, AlignmentT>::is_last_high_block(const memory_block& block) const
+{
+    return _high == block.as<std::uint8_t>();
+}
+
+} // namespace coal
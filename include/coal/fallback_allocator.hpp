@@ -1,6 +1,7 @@
 #pragma once
 
 #include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_marker.hpp>
 #include <coal/details/allocator_reallocation.hpp>
 #include <coal/memory_block.hpp>
 
@@ -15,9 +16,21 @@ public:
 
     static constexpr std::size_t alignment = primary::alignment > fallback::alignment ? primary::alignment : fallback::alignment;
 
+    // markers of the children which have one, rewinding leaves the blocks of the others allocated
+    struct marker
+    {
+        [[no_unique_address]] details::marker_of_t<primary> primary_marker{};
+        [[no_unique_address]] details::marker_of_t<fallback> fallback_marker{};
+    };
+
 public:
     [[nodiscard]] constexpr std::size_t get_alignment() const;
 
+    // granted size of the primary, the fallback only serves what the primary refuses
+    template<typename U = PrimaryAllocatorT, typename V = FallbackAllocatorT>
+    requires(allocator_traits::has_granted_size<U> && allocator_traits::has_granted_size<V>)
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     [[nodiscard]] constexpr const primary& get_primary_allocator() const;
     [[nodiscard]] constexpr primary& get_primary_allocator();
 
@@ -43,6 +56,14 @@ public:
     requires(allocator_traits::has_deallocate_all<U> && allocator_traits::has_deallocate_all<V>)
     constexpr void deallocate_all();
 
+    template<typename U = PrimaryAllocatorT, typename V = FallbackAllocatorT>
+    requires(allocator_traits::has_mark<U> || allocator_traits::has_mark<V>)
+    [[nodiscard]] constexpr marker mark() const;
+
+    template<typename U = PrimaryAllocatorT, typename V = FallbackAllocatorT>
+    requires(allocator_traits::has_mark<U> || allocator_traits::has_mark<V>)
+    constexpr void rewind(const marker& marker);
+
 private:
     primary _primary;
     fallback _fallback;
@@ -54,6 +75,14 @@ constexpr std::size_t fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>:
     return alignment;
 }
 
+template<typename PrimaryAllocatorT, typename FallbackAllocatorT>
+template<typename U, typename V>
+requires(allocator_traits::has_granted_size<U> && allocator_traits::has_granted_size<V>)
+constexpr std::size_t fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::granted_size(std::size_t size) const
+{
+    return _primary.granted_size(size);
+}
+
 template<typename PrimaryAllocatorT, typename FallbackAllocatorT>
 constexpr const fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::primary& fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::get_primary_allocator() const
 {
@@ -190,4 +219,21 @@ constexpr void fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::deallo
     _fallback.deallocate_all();
 }
 
+template<typename PrimaryAllocatorT, typename FallbackAllocatorT>
+template<typename U, typename V>
+requires(allocator_traits::has_mark<U> || allocator_traits::has_mark<V>)
+constexpr fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::marker fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::mark() const
+{
+    return {details::try_mark(_primary), details::try_mark(_fallback)};
+}
+
+template<typename PrimaryAllocatorT, typename FallbackAllocatorT>
+template<typename U, typename V>
+requires(allocator_traits::has_mark<U> || allocator_traits::has_mark<V>)
+constexpr void fallback_allocator<PrimaryAllocatorT, FallbackAllocatorT>::rewind(const marker& marker)
+{
+    details::try_rewind(_primary, marker.primary_marker);
+    details::try_rewind(_fallback, marker.fallback_marker);
+}
+
 } // namespace coal
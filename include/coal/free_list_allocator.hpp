@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <type_traits>
+
 #include <coal/alignment.hpp>
 #include <coal/allocator_traits.hpp>
 #include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/size_histogram.hpp>
+#include <coal/details/usdt.hpp>
 #include <coal/memory_block.hpp>
 
 namespace coal {
@@ -17,24 +22,142 @@ struct free_list
 {
     constexpr operator bool() const { return first_node; }
 
+    template<typename FunctionT>
+    constexpr void for_each_node(FunctionT&& function) const;
+
     free_list_node* first_node{nullptr};
 };
 
+// ListT with the number of nodes visited by the last allocate of the strategy. Strategies only count on such lists,
+// used by free_list_strategy::instrumented and the USDT probes, so a plain list costs no bookkeeping.
+template<typename ListT>
+struct searched_free_list : ListT
+{
+    std::size_t search_length{0};
+};
+
+template<typename FunctionT>
+constexpr void free_list::for_each_node(FunctionT&& function) const
+{
+    for (const free_list_node* node = first_node; node; node = node->next)
+    {
+        function(*node);
+    }
+}
+
+namespace details {
+
+// the list a strategy works on, free_list unless the strategy declares its own list_type
+template<typename StrategyT>
+struct free_list_type
+{
+    using type = free_list;
+};
+
+template<typename StrategyT>
+requires requires { typename StrategyT::list_type; }
+struct free_list_type<StrategyT>
+{
+    using type = typename StrategyT::list_type;
+};
+
+template<typename StrategyT>
+using free_list_type_t = typename free_list_type<StrategyT>::type;
+
+template<typename ListT>
+concept has_search_length = requires(ListT& list) { list.search_length; };
+
+// ListT itself when it already counts its search length
+template<typename ListT>
+using searched_free_list_t = std::conditional_t<has_search_length<ListT>, ListT, searched_free_list<ListT>>;
+
+// stores the search length of an allocate, compiled out on the lists which do not count it
+template<typename ListT>
+constexpr void set_search_length(ListT& list, std::size_t search_length)
+{
+    if constexpr (has_search_length<ListT>)
+    {
+        list.search_length = search_length;
+    }
+}
+
+} // namespace details
+
+struct free_list_stats
+{
+    // same buckets as allocator_stats, bucket i counts nodes of size [2^(i-1), 2^i) and bucket 0 stays empty
+    static constexpr std::size_t histogram_bucket_count = 32;
+
+    static constexpr std::size_t histogram_bucket(std::size_t size);
+
+    [[nodiscard]] constexpr double get_average_search_length() const;
+
+    // share of the cached bytes that cannot be served by a single node, 0 when every cached byte is in the largest node
+    [[nodiscard]] constexpr double get_external_fragmentation() const;
+
+    std::size_t node_count{0};
+    std::size_t cached_bytes{0};
+    std::size_t largest_node_size{0};
+    std::array<std::size_t, histogram_bucket_count> size_histogram{};
+
+    // collected by free_list_strategy::instrumented, zero with other strategies
+    std::size_t allocate_count{0};
+    std::size_t hit_count{0};
+    std::size_t total_search_length{0};
+    std::size_t max_search_length{0};
+
+    // bytes past the requested size of the nodes handed out whole, lost until the parent releases them
+    std::size_t internal_waste_bytes{0};
+};
+
+constexpr std::size_t free_list_stats::histogram_bucket(std::size_t size)
+{
+    return details::size_histogram_bucket<histogram_bucket_count>(size);
+}
+
+constexpr double free_list_stats::get_average_search_length() const
+{
+    return allocate_count ? static_cast<double>(total_search_length) / static_cast<double>(allocate_count) : 0.0;
+}
+
+constexpr double free_list_stats::get_external_fragmentation() const
+{
+    return cached_bytes ? 1.0 - static_cast<double>(largest_node_size) / static_cast<double>(cached_bytes) : 0.0;
+}
+
 template<typename AllocatorT, typename StrategyT>
 class free_list_allocator
 {
 public:
     using allocator = AllocatorT;
     using strategy = StrategyT;
+#if COAL_USDT_ENABLED
+    // the free-list probes report the search length
+    using list_type = details::searched_free_list_t<details::free_list_type_t<strategy>>;
+#else
+    using list_type = details::free_list_type_t<strategy>;
+#endif
 
     static constexpr std::size_t alignment = allocator::alignment;
 
+    // a freed block must be able to hold its own node
+    static constexpr std::size_t node_size(std::size_t size);
+
 public:
     constexpr std::size_t get_alignment() const;
 
+    // node size of a block, the bytes taken from the parent and cached once freed
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     [[nodiscard]] constexpr const allocator& get_allocator() const;
     [[nodiscard]] constexpr allocator& get_allocator();
 
+    [[nodiscard]] constexpr const strategy& get_strategy() const;
+    [[nodiscard]] constexpr strategy& get_strategy();
+
+    // walks the free list, keep it out of hot paths
+    [[nodiscard]] constexpr free_list_stats get_free_list_stats() const;
+
     template<typename Initializer>
     constexpr void init(Initializer& initializer);
 
@@ -57,15 +180,27 @@ public:
 private:
     allocator _allocator;
     strategy _strategy;
-    free_list _free_list;
+    list_type _free_list;
 };
 
+template<typename AllocatorT, typename StrategyT>
+constexpr std::size_t free_list_allocator<AllocatorT, StrategyT>::node_size(std::size_t size)
+{
+    return align_up(size < sizeof(free_list_node) ? sizeof(free_list_node) : size, alignment);
+}
+
 template<typename AllocatorT, typename StrategyT>
 constexpr std::size_t free_list_allocator<AllocatorT, StrategyT>::get_alignment() const
 {
     return alignment;
 }
 
+template<typename AllocatorT, typename StrategyT>
+constexpr std::size_t free_list_allocator<AllocatorT, StrategyT>::granted_size(std::size_t size) const
+{
+    return node_size(size);
+}
+
 template<typename AllocatorT, typename StrategyT>
 constexpr const free_list_allocator<AllocatorT, StrategyT>::allocator& free_list_allocator<AllocatorT, StrategyT>::get_allocator() const
 {
@@ -78,6 +213,38 @@ constexpr free_list_allocator<AllocatorT, StrategyT>::allocator& free_list_alloc
     return _allocator;
 }
 
+template<typename AllocatorT, typename StrategyT>
+constexpr const free_list_allocator<AllocatorT, StrategyT>::strategy& free_list_allocator<AllocatorT, StrategyT>::get_strategy() const
+{
+    return _strategy;
+}
+
+template<typename AllocatorT, typename StrategyT>
+constexpr free_list_allocator<AllocatorT, StrategyT>::strategy& free_list_allocator<AllocatorT, StrategyT>::get_strategy()
+{
+    return _strategy;
+}
+
+template<typename AllocatorT, typename StrategyT>
+constexpr free_list_stats free_list_allocator<AllocatorT, StrategyT>::get_free_list_stats() const
+{
+    free_list_stats stats;
+
+    _free_list.for_each_node([&stats](const free_list_node& node) {
+        ++stats.node_count;
+        stats.cached_bytes += node.size;
+        stats.largest_node_size = node.size > stats.largest_node_size ? node.size : stats.largest_node_size;
+        ++stats.size_histogram[free_list_stats::histogram_bucket(node.size)];
+    });
+
+    if constexpr (requires(const strategy& s, free_list_stats& st) { s.collect_stats(st); })
+    {
+        _strategy.collect_stats(stats);
+    }
+
+    return stats;
+}
+
 template<typename AllocatorT, typename StrategyT>
 template<typename Initializer>
 constexpr void free_list_allocator<AllocatorT, StrategyT>::init(Initializer& initializer)
@@ -90,20 +257,32 @@ constexpr void free_list_allocator<AllocatorT, StrategyT>::init(Initializer& ini
 template<typename AllocatorT, typename StrategyT>
 constexpr memory_block free_list_allocator<AllocatorT, StrategyT>::allocate(std::size_t size)
 {
-    const std::size_t aligned_size = align_up(size, alignment);
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    const std::size_t aligned_size = node_size(size);
 
     if (_free_list)
     {
         if (free_list_node* node = _strategy.allocate(_free_list, aligned_size))
         {
+            COAL_USDT_ALLOCATOR_PROBE(free_list_hit, size, node, _free_list.search_length);
+            COAL_USDT_ALLOCATOR_PROBE(allocate, size, node);
+
             return memory_block{node, size};
         }
+
+        COAL_USDT_ALLOCATOR_PROBE(free_list_miss, size, _free_list.search_length);
     }
 
     if (memory_block block = _allocator.allocate(aligned_size))
     {
         block.size = size;
 
+        COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
         return block;
     }
 
@@ -123,19 +302,50 @@ template<typename U>
 requires(allocator_traits::has_expand<U>)
 constexpr bool free_list_allocator<AllocatorT, StrategyT>::expand(memory_block& block, std::size_t delta)
 {
-    return _allocator.expand(block, delta);
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t aligned_size = node_size(block.size);
+    const std::size_t aligned_new_size = node_size(block.size + delta);
+
+    if (aligned_new_size > aligned_size)
+    {
+        memory_block aligned_block(block.ptr, aligned_size);
+
+        if (!_allocator.expand(aligned_block, aligned_new_size - aligned_size))
+        {
+            return false;
+        }
+
+        block.ptr = aligned_block.ptr;
+    }
+
+    block.size += delta;
+    return true;
 }
 
 template<typename AllocatorT, typename StrategyT>
 constexpr bool free_list_allocator<AllocatorT, StrategyT>::reallocate(memory_block& block, std::size_t new_size)
 {
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
     if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
     {
         return reallocated;
     }
 
-    const std::size_t aligned_size = align_up(new_size, alignment);
-    const std::size_t aligned_block_size = align_up(block.size, alignment);
+    const std::size_t aligned_size = node_size(new_size);
+    const std::size_t aligned_block_size = node_size(block.size);
 
     if (aligned_size < aligned_block_size)
     {
@@ -164,7 +374,9 @@ constexpr void free_list_allocator<AllocatorT, StrategyT>::deallocate(memory_blo
         return;
     }
 
-    memory_block aligned_block(block.ptr, align_up(block.size, alignment));
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    memory_block aligned_block(block.ptr, node_size(block.size));
 
     if (!_strategy.deallocate(_free_list, aligned_block))
     {
@@ -8,19 +8,25 @@ namespace coal::free_list_strategy {
 
 struct best_fit
 {
-    constexpr free_list_node* allocate(free_list& list, std::size_t size);
+    template<typename ListT>
+    constexpr free_list_node* allocate(ListT& list, std::size_t size);
+
     constexpr bool deallocate(free_list& list, memory_block& block);
 };
 
-constexpr free_list_node* best_fit::allocate(free_list& list, std::size_t size)
+template<typename ListT>
+constexpr free_list_node* best_fit::allocate(ListT& list, std::size_t size)
 {
     free_list_node* best_prev_node = nullptr;
     free_list_node* best_node = nullptr;
     free_list_node* prev_node = nullptr;
     free_list_node* node = list.first_node;
+    std::size_t search_length = 0;
 
     while (node)
     {
+        ++search_length;
+
         if (node->size == size)
         {
             if (prev_node)
@@ -33,6 +39,7 @@ constexpr free_list_node* best_fit::allocate(free_list& list, std::size_t size)
             }
 
             node->next = nullptr;
+            details::set_search_length(list, search_length);
             return node;
         }
         else if (node->size > size)
@@ -62,6 +69,7 @@ constexpr free_list_node* best_fit::allocate(free_list& list, std::size_t size)
         best_node->next = nullptr;
     }
 
+    details::set_search_length(list, search_length);
     return best_node;
 }
 
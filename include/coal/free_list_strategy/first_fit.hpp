@@ -8,17 +8,23 @@ namespace coal::free_list_strategy {
 
 struct first_fit
 {
-    constexpr free_list_node* allocate(free_list& list, std::size_t size);
+    template<typename ListT>
+    constexpr free_list_node* allocate(ListT& list, std::size_t size);
+
     constexpr bool deallocate(free_list& list, memory_block& block);
 };
 
-constexpr free_list_node* first_fit::allocate(free_list& list, std::size_t size)
+template<typename ListT>
+constexpr free_list_node* first_fit::allocate(ListT& list, std::size_t size)
 {
     free_list_node* prev_node = nullptr;
     free_list_node* node = list.first_node;
+    std::size_t search_length = 0;
 
     while (node)
     {
+        ++search_length;
+
         if (node->size >= size)
         {
             if (prev_node)
@@ -31,6 +37,7 @@ constexpr free_list_node* first_fit::allocate(free_list& list, std::size_t size)
             }
 
             node->next = nullptr;
+            details::set_search_length(list, search_length);
             return node;
         }
 
@@ -38,6 +45,7 @@ constexpr free_list_node* first_fit::allocate(free_list& list, std::size_t size)
         node = node->next;
     }
 
+    details::set_search_length(list, search_length);
     return nullptr;
 }
 
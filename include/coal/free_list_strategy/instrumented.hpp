@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+
+#include <coal/free_list_allocator.hpp>
+
+namespace coal::free_list_strategy {
+
+// Collects the search length and the internal waste of every allocate of the wrapped strategy,
+// reported by free_list_allocator::get_free_list_stats(). The strategy counts its search length on a
+// searched_free_list only, so the list type gains the counter here.
+template<typename StrategyT>
+struct instrumented : private StrategyT
+{
+    using strategy = StrategyT;
+    using list_type = details::searched_free_list_t<details::free_list_type_t<StrategyT>>;
+
+    template<typename ListT>
+    constexpr free_list_node* allocate(ListT& list, std::size_t size);
+
+    template<typename ListT>
+    constexpr bool deallocate(ListT& list, memory_block& block);
+
+    constexpr void collect_stats(free_list_stats& stats) const;
+    constexpr void reset_stats();
+
+    std::size_t allocate_count{0};
+    std::size_t hit_count{0};
+    std::size_t total_search_length{0};
+    std::size_t max_search_length{0};
+    std::size_t internal_waste_bytes{0};
+};
+
+template<typename StrategyT>
+template<typename ListT>
+constexpr free_list_node* instrumented<StrategyT>::allocate(ListT& list, std::size_t size)
+{
+    static_assert(details::has_search_length<ListT>, "The list must be a searched_free_list.");
+
+    list.search_length = 0;
+
+    free_list_node* node = strategy::allocate(list, size);
+
+    ++allocate_count;
+    total_search_length += list.search_length;
+    max_search_length = list.search_length > max_search_length ? list.search_length : max_search_length;
+
+    if (node != nullptr)
+    {
+        ++hit_count;
+        internal_waste_bytes += node->size - size;
+    }
+
+    return node;
+}
+
+template<typename StrategyT>
+template<typename ListT>
+constexpr bool instrumented<StrategyT>::deallocate(ListT& list, memory_block& block)
+{
+    return strategy::deallocate(list, block);
+}
+
+template<typename StrategyT>
+constexpr void instrumented<StrategyT>::collect_stats(free_list_stats& stats) const
+{
+    stats.allocate_count = allocate_count;
+    stats.hit_count = hit_count;
+    stats.total_search_length = total_search_length;
+    stats.max_search_length = max_search_length;
+    stats.internal_waste_bytes = internal_waste_bytes;
+}
+
+template<typename StrategyT>
+constexpr void instrumented<StrategyT>::reset_stats()
+{
+    allocate_count = 0;
+    hit_count = 0;
+    total_search_length = 0;
+    max_search_length = 0;
+    internal_waste_bytes = 0;
+}
+
+} // namespace coal::free_list_strategy
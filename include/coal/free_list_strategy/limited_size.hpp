@@ -18,18 +18,24 @@ template<typename StrategyT, std::size_t MaxSizeT>
 struct limited_size : private StrategyT
 {
     using strategy = StrategyT;
+    using list_type = details::free_list_type_t<StrategyT>;
 
-    constexpr free_list_node* allocate(free_list& list, std::size_t size);
-    constexpr bool deallocate(free_list& list, memory_block& block);
+    template<typename ListT>
+    constexpr free_list_node* allocate(ListT& list, std::size_t size);
+
+    template<typename ListT>
+    constexpr bool deallocate(ListT& list, memory_block& block);
 
     std::size_t list_size{0};
 };
 
 template<typename StrategyT, std::size_t MaxSizeT>
-constexpr free_list_node* limited_size<StrategyT, MaxSizeT>::allocate(free_list& list, std::size_t size)
+template<typename ListT>
+constexpr free_list_node* limited_size<StrategyT, MaxSizeT>::allocate(ListT& list, std::size_t size)
 {
     if (list_size == 0)
     {
+        details::set_search_length(list, 0);
         return nullptr;
     }
 
@@ -44,7 +50,8 @@ constexpr free_list_node* limited_size<StrategyT, MaxSizeT>::allocate(free_list&
 }
 
 template<typename StrategyT, std::size_t MaxSizeT>
-constexpr bool limited_size<StrategyT, MaxSizeT>::deallocate(free_list& list, memory_block& block)
+template<typename ListT>
+constexpr bool limited_size<StrategyT, MaxSizeT>::deallocate(ListT& list, memory_block& block)
 {
     if (list_size >= MaxSizeT)
     {
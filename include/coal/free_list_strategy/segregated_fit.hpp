@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <coal/alignment.hpp>
+#include <coal/free_list_allocator.hpp>
+
+namespace coal {
+
+// Free list split into bins, with a bitmap telling which bins hold nodes.
+template<std::size_t BinCountT>
+struct segregated_free_list
+{
+    constexpr operator bool() const { return non_empty_bins != 0; }
+
+    template<typename FunctionT>
+    constexpr void for_each_node(FunctionT&& function) const;
+
+    std::array<free_list_node*, BinCountT> bins{};
+    std::uint64_t non_empty_bins{0};
+};
+
+template<std::size_t BinCountT>
+template<typename FunctionT>
+constexpr void segregated_free_list<BinCountT>::for_each_node(FunctionT&& function) const
+{
+    for (const free_list_node* first_node : bins)
+    {
+        for (const free_list_node* node = first_node; node; node = node->next)
+        {
+            function(*node);
+        }
+    }
+}
+
+} // namespace coal
+
+namespace coal::free_list_strategy {
+
+// Bins the nodes by size instead of keeping them in one list. Bin n holds the nodes of (n * GranularityT,
+// (n + 1) * GranularityT] bytes and the last bin every larger node, searched best fit. Any node of a bin above the one
+// of a size fits it, one bit scan of the non-empty bins finds it. With GranularityT set to the alignment of the
+// free_list_allocator each bin but the last holds a single size and exact hits are constant time.
+template<std::size_t BinCountT, std::size_t GranularityT = default_alignment>
+struct segregated_fit
+{
+    static_assert(BinCountT >= 2 && BinCountT <= 64, "Bin count must be between 2 and 64, the bitmap is a single word.");
+    static_assert(std::has_single_bit(GranularityT), "Granularity must be a power of two.");
+
+    using list_type = segregated_free_list<BinCountT>;
+
+    static constexpr std::size_t bin_count = BinCountT;
+    static constexpr std::size_t granularity = GranularityT;
+
+    // nodes larger than this share the last bin
+    static constexpr std::size_t max_binned_size = (bin_count - 1) * granularity;
+
+    static constexpr std::size_t bin_index(std::size_t size);
+
+    template<typename ListT>
+    constexpr free_list_node* allocate(ListT& list, std::size_t size);
+
+    constexpr bool deallocate(list_type& list, memory_block& block);
+
+private:
+    static constexpr free_list_node* unlink(list_type& list, std::size_t bin, free_list_node* prev_node, free_list_node* node);
+};
+
+template<std::size_t BinCountT, std::size_t GranularityT>
+constexpr std::size_t segregated_fit<BinCountT, GranularityT>::bin_index(std::size_t size)
+{
+    return size <= max_binned_size ? (size - 1) / granularity : bin_count - 1;
+}
+
+template<std::size_t BinCountT, std::size_t GranularityT>
+template<typename ListT>
+constexpr free_list_node* segregated_fit<BinCountT, GranularityT>::allocate(ListT& list, std::size_t size)
+{
+    constexpr std::size_t last_bin = bin_count - 1;
+
+    std::size_t bin = bin_index(size);
+    std::size_t search_length = 0;
+
+    if (bin != last_bin)
+    {
+        // the bin of size may hold smaller nodes when the granularity is coarser than the node alignment
+        free_list_node* prev_node = nullptr;
+
+        for (free_list_node* node = list.bins[bin]; node; node = node->next)
+        {
+            ++search_length;
+
+            if (node->size >= size)
+            {
+                details::set_search_length(list, search_length);
+                return unlink(list, bin, prev_node, node);
+            }
+
+            prev_node = node;
+        }
+
+        const std::uint64_t larger_bins = list.non_empty_bins & (~std::uint64_t{0} << (bin + 1));
+
+        if (larger_bins == 0)
+        {
+            details::set_search_length(list, search_length);
+            return nullptr;
+        }
+
+        bin = static_cast<std::size_t>(std::countr_zero(larger_bins));
+
+        if (bin != last_bin)
+        {
+            details::set_search_length(list, search_length + 1);
+            return unlink(list, bin, nullptr, list.bins[bin]);
+        }
+    }
+
+    free_list_node* best_prev_node = nullptr;
+    free_list_node* best_node = nullptr;
+    free_list_node* prev_node = nullptr;
+
+    for (free_list_node* node = list.bins[last_bin]; node; node = node->next)
+    {
+        ++search_length;
+
+        if (node->size == size)
+        {
+            best_prev_node = prev_node;
+            best_node = node;
+            break;
+        }
+
+        if (node->size > size && (best_node == nullptr || node->size < best_node->size))
+        {
+            best_prev_node = prev_node;
+            best_node = node;
+        }
+
+        prev_node = node;
+    }
+
+    details::set_search_length(list, search_length);
+    return best_node ? unlink(list, last_bin, best_prev_node, best_node) : nullptr;
+}
+
+template<std::size_t BinCountT, std::size_t GranularityT>
+constexpr bool segregated_fit<BinCountT, GranularityT>::deallocate(list_type& list, memory_block& block)
+{
+    const std::size_t bin = bin_index(block.size);
+
+    free_list_node* node = block.as<free_list_node>();
+
+    node->size = block.size;
+    node->next = list.bins[bin];
+
+    list.bins[bin] = node;
+    list.non_empty_bins |= std::uint64_t{1} << bin;
+
+    return true;
+}
+
+template<std::size_t BinCountT, std::size_t GranularityT>
+constexpr free_list_node* segregated_fit<BinCountT, GranularityT>::unlink(list_type& list, std::size_t bin, free_list_node* prev_node, free_list_node* node)
+{
+    if (prev_node)
+    {
+        prev_node->next = node->next;
+    }
+    else
+    {
+        list.bins[bin] = node->next;
+
+        if (list.bins[bin] == nullptr)
+        {
+            list.non_empty_bins &= ~(std::uint64_t{1} << bin);
+        }
+    }
+
+    node->next = nullptr;
+    return node;
+}
+
+} // namespace coal::free_list_strategy
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COAL_HAS_TSC 1
+#else
+#define COAL_HAS_TSC 0
+#endif
+
+namespace coal {
+
+// Monotonic clock in nanoseconds, clock_gettime(CLOCK_MONOTONIC) on linux.
+struct steady_latency_clock
+{
+    [[nodiscard]] static std::uint64_t now();
+    [[nodiscard]] static double get_ns_per_tick();
+};
+
+inline std::uint64_t steady_latency_clock::now()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline double steady_latency_clock::get_ns_per_tick()
+{
+    return 1.0;
+}
+
+// Time stamp counter, a few cycles per read instead of a vdso call. Ticks are converted to nanoseconds with a
+// ratio calibrated against the steady clock on first use. Falls back to steady_latency_clock without a TSC.
+struct tsc_latency_clock
+{
+    [[nodiscard]] static std::uint64_t now();
+    [[nodiscard]] static double get_ns_per_tick();
+
+private:
+    [[nodiscard]] static double calibrate();
+};
+
+inline std::uint64_t tsc_latency_clock::now()
+{
+#if COAL_HAS_TSC
+    return __rdtsc();
+#else
+    return steady_latency_clock::now();
+#endif
+}
+
+inline double tsc_latency_clock::get_ns_per_tick()
+{
+    static const double ns_per_tick = calibrate();
+    return ns_per_tick;
+}
+
+inline double tsc_latency_clock::calibrate()
+{
+#if COAL_HAS_TSC
+    constexpr std::uint64_t calibration_ns = 10'000'000;
+
+    const std::uint64_t start_ns = steady_latency_clock::now();
+    const std::uint64_t start_ticks = now();
+
+    std::uint64_t end_ns = start_ns;
+
+    while (end_ns - start_ns < calibration_ns)
+    {
+        end_ns = steady_latency_clock::now();
+    }
+
+    const std::uint64_t end_ticks = now();
+
+    return end_ticks > start_ticks ? static_cast<double>(end_ns - start_ns) / static_cast<double>(end_ticks - start_ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+} // namespace coal
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace coal {
+
+// Log-linear histogram in the style of HdrHistogram: values below 2^sub_bucket_bits are counted exactly, above
+// that each power of two is split in 2^(sub_bucket_bits - 1) buckets so the relative error stays under 1/16.
+// Values above 2^max_value_bits share the last bucket, the exact maximum is kept aside.
+class latency_histogram
+{
+public:
+    static constexpr std::size_t sub_bucket_bits = 5;
+    static constexpr std::size_t max_value_bits = 40;
+
+    static constexpr std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t half_sub_bucket_count = sub_bucket_count / 2;
+    static constexpr std::size_t bucket_count = (max_value_bits - sub_bucket_bits + 2) * half_sub_bucket_count;
+
+    [[nodiscard]] static constexpr std::size_t get_bucket_index(std::uint64_t value);
+    [[nodiscard]] static constexpr std::uint64_t get_bucket_lower_bound(std::size_t index);
+    [[nodiscard]] static constexpr std::uint64_t get_bucket_upper_bound(std::size_t index);
+
+public:
+    constexpr void record(std::uint64_t value);
+    constexpr void merge(const latency_histogram& other);
+    constexpr void reset();
+
+    [[nodiscard]] constexpr std::uint64_t get_count() const;
+    [[nodiscard]] constexpr std::uint64_t get_min() const;
+    [[nodiscard]] constexpr std::uint64_t get_max() const;
+    [[nodiscard]] constexpr std::uint64_t get_bucket_count(std::size_t index) const;
+
+    // upper bound of the bucket holding the given percentile, clamped to the recorded maximum
+    [[nodiscard]] constexpr std::uint64_t get_value_at_percentile(double percentile) const;
+
+private:
+    std::array<std::uint64_t, bucket_count> _buckets{};
+    std::uint64_t _count{0};
+    std::uint64_t _min{~std::uint64_t{0}};
+    std::uint64_t _max{0};
+};
+
+constexpr std::size_t latency_histogram::get_bucket_index(std::uint64_t value)
+{
+    if (value < sub_bucket_count)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    const std::size_t shift = static_cast<std::size_t>(std::bit_width(value)) - sub_bucket_bits;
+    const std::size_t index = (shift + 1) * half_sub_bucket_count + static_cast<std::size_t>(value >> shift) - half_sub_bucket_count;
+
+    return std::min(index, bucket_count - 1);
+}
+
+constexpr std::uint64_t latency_histogram::get_bucket_lower_bound(std::size_t index)
+{
+    if (index < sub_bucket_count)
+    {
+        return index;
+    }
+
+    const std::size_t shift = index / half_sub_bucket_count - 1;
+    const std::uint64_t sub_bucket = index % half_sub_bucket_count + half_sub_bucket_count;
+
+    return sub_bucket << shift;
+}
+
+constexpr std::uint64_t latency_histogram::get_bucket_upper_bound(std::size_t index)
+{
+    if (index < sub_bucket_count)
+    {
+        return index;
+    }
+
+    if (index == bucket_count - 1)
+    {
+        return ~std::uint64_t{0};
+    }
+
+    return get_bucket_lower_bound(index + 1) - 1;
+}
+
+constexpr void latency_histogram::record(std::uint64_t value)
+{
+    ++_buckets[get_bucket_index(value)];
+    ++_count;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+constexpr void latency_histogram::merge(const latency_histogram& other)
+{
+    for (std::size_t i = 0; i < bucket_count; ++i)
+    {
+        _buckets[i] += other._buckets[i];
+    }
+
+    _count += other._count;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+constexpr void latency_histogram::reset()
+{
+    *this = latency_histogram{};
+}
+
+constexpr std::uint64_t latency_histogram::get_count() const
+{
+    return _count;
+}
+
+constexpr std::uint64_t latency_histogram::get_min() const
+{
+    return _count ? _min : 0;
+}
+
+constexpr std::uint64_t latency_histogram::get_max() const
+{
+    return _max;
+}
+
+constexpr std::uint64_t latency_histogram::get_bucket_count(std::size_t index) const
+{
+    return _buckets[index];
+}
+
+constexpr std::uint64_t latency_histogram::get_value_at_percentile(double percentile) const
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    const double clamped = std::clamp(percentile, 0.0, 100.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(_count) + 0.5));
+
+    std::uint64_t seen = 0;
+
+    for (std::size_t i = 0; i < bucket_count; ++i)
+    {
+        seen += _buckets[i];
+
+        if (seen >= rank)
+        {
+            return std::min(get_bucket_upper_bound(i), _max);
+        }
+    }
+
+    return _max;
+}
+
+} // namespace coal
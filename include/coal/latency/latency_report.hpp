@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+#include <coal/latency/latency_histogram.hpp>
+#include <coal/latency_allocator.hpp>
+
+namespace coal {
+
+struct latency_percentiles
+{
+    std::uint64_t count{0};
+    double p50_ns{0.0};
+    double p99_ns{0.0};
+    double p999_ns{0.0};
+    double max_ns{0.0};
+};
+
+struct latency_summary
+{
+    const char* name{nullptr};
+    std::array<latency_percentiles, static_cast<std::size_t>(latency_operation::count)> operations{};
+
+    [[nodiscard]] constexpr const latency_percentiles& get_percentiles(latency_operation operation) const;
+};
+
+constexpr const latency_percentiles& latency_summary::get_percentiles(latency_operation operation) const
+{
+    return operations[static_cast<std::size_t>(operation)];
+}
+
+inline latency_percentiles summarize_latency(const latency_histogram& histogram, double ns_per_tick)
+{
+    return {
+        histogram.get_count(),
+        static_cast<double>(histogram.get_value_at_percentile(50.0)) * ns_per_tick,
+        static_cast<double>(histogram.get_value_at_percentile(99.0)) * ns_per_tick,
+        static_cast<double>(histogram.get_value_at_percentile(99.9)) * ns_per_tick,
+        static_cast<double>(histogram.get_max()) * ns_per_tick,
+    };
+}
+
+template<typename T>
+struct is_latency_allocator : std::false_type
+{};
+
+template<typename AllocatorT, typename ClockT>
+struct is_latency_allocator<latency_allocator<AllocatorT, ClockT>> : std::true_type
+{};
+
+// Initializer visiting a composite and summarizing each latency_allocator it finds, inner layers first.
+class latency_collector
+{
+public:
+    template<typename AllocatorT>
+    void init(AllocatorT& allocator);
+
+    [[nodiscard]] const std::vector<latency_summary>& get_summaries() const;
+
+private:
+    std::vector<latency_summary> _summaries;
+};
+
+template<typename AllocatorT>
+void latency_collector::init(AllocatorT& allocator)
+{
+    if constexpr (is_latency_allocator<AllocatorT>::value)
+    {
+        const double ns_per_tick = AllocatorT::clock::get_ns_per_tick();
+
+        latency_summary summary;
+        summary.name = allocator.get_name();
+
+        for (std::size_t i = 0; i < summary.operations.size(); ++i)
+        {
+            summary.operations[i] = summarize_latency(allocator.get_histogram(static_cast<latency_operation>(i)), ns_per_tick);
+        }
+
+        _summaries.push_back(summary);
+    }
+}
+
+inline const std::vector<latency_summary>& latency_collector::get_summaries() const
+{
+    return _summaries;
+}
+
+template<typename AllocatorT>
+std::vector<latency_summary> collect_latencies(AllocatorT& allocator)
+{
+    latency_collector collector;
+    allocator.init(collector);
+    return collector.get_summaries();
+}
+
+// Prints p50/p99/p99.9/max in nanoseconds for every operation called at least once.
+inline void print_latency_report(std::FILE* file, const std::vector<latency_summary>& summaries)
+{
+    static constexpr std::array<const char*, static_cast<std::size_t>(latency_operation::count)> operation_names{"allocate", "deallocate", "reallocate", "expand"};
+
+    std::fprintf(file, "%-24s %-10s %12s %10s %10s %10s %12s\n", "allocator", "operation", "count", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+
+    for (std::size_t i = 0; i < summaries.size(); ++i)
+    {
+        const latency_summary& summary = summaries[i];
+
+        for (std::size_t op = 0; op < operation_names.size(); ++op)
+        {
+            const latency_percentiles& p = summary.operations[op];
+
+            if (p.count == 0)
+            {
+                continue;
+            }
+
+            if (summary.name)
+            {
+                std::fprintf(file, "%-24s ", summary.name);
+            }
+            else
+            {
+                std::fprintf(file, "#%-23zu ", i);
+            }
+
+            std::fprintf(file, "%-10s %12llu %10.0f %10.0f %10.0f %12.0f\n", operation_names[op], static_cast<unsigned long long>(p.count), p.p50_ns, p.p99_ns, p.p999_ns, p.max_ns);
+        }
+    }
+}
+
+} // namespace coal
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/latency/latency_clock.hpp>
+#include <coal/latency/latency_histogram.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+enum class latency_operation : std::uint8_t
+{
+    allocate,
+    deallocate,
+    reallocate,
+    expand,
+
+    count
+};
+
+// Records the latency of each call made to the wrapped allocator in a histogram per operation, in clock ticks.
+// Place one around each layer of a composite and use collect_latencies() to report them, nested layers include
+// the latency of the layers they wrap. Not thread-safe.
+template<typename AllocatorT, typename ClockT = tsc_latency_clock>
+class latency_allocator
+{
+public:
+    using allocator = AllocatorT;
+    using clock = ClockT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t operation_count = static_cast<std::size_t>(latency_operation::count);
+
+public:
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    // name used by reports, the string is not copied
+    [[nodiscard]] constexpr const char* get_name() const;
+    constexpr void set_name(const char* name);
+
+    [[nodiscard]] constexpr const latency_histogram& get_histogram(latency_operation operation) const;
+    constexpr void reset_histograms();
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_expand<U>)
+    constexpr bool expand(memory_block& block, std::size_t delta);
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_deallocate_all<U>)
+    constexpr void deallocate_all();
+
+private:
+    constexpr void record(latency_operation operation, std::uint64_t start);
+
+    allocator _allocator;
+    const char* _name{nullptr};
+    std::array<latency_histogram, operation_count> _histograms{};
+};
+
+template<typename AllocatorT, typename ClockT>
+constexpr std::size_t latency_allocator<AllocatorT, ClockT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr const latency_allocator<AllocatorT, ClockT>::allocator& latency_allocator<AllocatorT, ClockT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr latency_allocator<AllocatorT, ClockT>::allocator& latency_allocator<AllocatorT, ClockT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr const char* latency_allocator<AllocatorT, ClockT>::get_name() const
+{
+    return _name;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr void latency_allocator<AllocatorT, ClockT>::set_name(const char* name)
+{
+    _name = name;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr const latency_histogram& latency_allocator<AllocatorT, ClockT>::get_histogram(latency_operation operation) const
+{
+    return _histograms[static_cast<std::size_t>(operation)];
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr void latency_allocator<AllocatorT, ClockT>::reset_histograms()
+{
+    for (latency_histogram& histogram : _histograms)
+    {
+        histogram.reset();
+    }
+}
+
+template<typename AllocatorT, typename ClockT>
+template<typename Initializer>
+constexpr void latency_allocator<AllocatorT, ClockT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr memory_block latency_allocator<AllocatorT, ClockT>::allocate(std::size_t size)
+{
+    const std::uint64_t start = clock::now();
+
+    memory_block block = _allocator.allocate(size);
+
+    record(latency_operation::allocate, start);
+
+    return block;
+}
+
+template<typename AllocatorT, typename ClockT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+constexpr bool latency_allocator<AllocatorT, ClockT>::owns(const memory_block& block) const
+{
+    return _allocator.owns(block);
+}
+
+template<typename AllocatorT, typename ClockT>
+template<typename U>
+requires(allocator_traits::has_expand<U>)
+constexpr bool latency_allocator<AllocatorT, ClockT>::expand(memory_block& block, std::size_t delta)
+{
+    const std::uint64_t start = clock::now();
+
+    const bool success = _allocator.expand(block, delta);
+
+    record(latency_operation::expand, start);
+
+    return success;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr bool latency_allocator<AllocatorT, ClockT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    const std::uint64_t start = clock::now();
+
+    const bool success = _allocator.reallocate(block, new_size);
+
+    record(latency_operation::reallocate, start);
+
+    return success;
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr void latency_allocator<AllocatorT, ClockT>::deallocate(memory_block& block)
+{
+    const std::uint64_t start = clock::now();
+
+    _allocator.deallocate(block);
+
+    record(latency_operation::deallocate, start);
+}
+
+template<typename AllocatorT, typename ClockT>
+template<typename U>
+requires(allocator_traits::has_deallocate_all<U>)
+constexpr void latency_allocator<AllocatorT, ClockT>::deallocate_all()
+{
+    _allocator.deallocate_all();
+}
+
+template<typename AllocatorT, typename ClockT>
+constexpr void latency_allocator<AllocatorT, ClockT>::record(latency_operation operation, std::uint64_t start)
+{
+    const std::uint64_t end = clock::now();
+
+    // the tsc of another core can lag behind after a migration
+    _histograms[static_cast<std::size_t>(operation)].record(end > start ? end - start : 0);
+}
+
+} // namespace coal
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <coal/details/cpu_relax.hpp>
+#include <coal/lock_policy/lock_contention.hpp>
+
+namespace coal::lock_policy {
+
+// Spins up to SpinCountT times for the lock to be released, then parks the thread on the lock word with
+// std::atomic::wait (a futex on Linux). The lock word records whether a thread may be parked so an uncontended
+// unlock makes no system call. Suits critical sections which are usually short but sometimes are not.
+template<std::uint32_t SpinCountT = 128>
+class adaptive_lock
+{
+public:
+    static constexpr std::uint32_t spin_count = SpinCountT;
+
+    lock_contention lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    enum state : std::uint32_t
+    {
+        unlocked,
+        locked,
+        locked_with_waiters
+    };
+
+    std::atomic<std::uint32_t> _state{unlocked};
+};
+
+template<std::uint32_t SpinCountT>
+lock_contention adaptive_lock<SpinCountT>::lock()
+{
+    lock_contention contention;
+
+    for (; contention.spins < SpinCountT; ++contention.spins)
+    {
+        std::uint32_t expected = unlocked;
+
+        if (_state.load(std::memory_order_relaxed) == unlocked && _state.compare_exchange_weak(expected, locked, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return contention;
+        }
+
+        details::cpu_relax();
+    }
+
+    // a thread leaving the wait cannot tell whether others are parked, it keeps the lock marked as having waiters
+    while (_state.exchange(locked_with_waiters, std::memory_order_acquire) != unlocked)
+    {
+        contention.waited = true;
+        _state.wait(locked_with_waiters, std::memory_order_relaxed);
+    }
+
+    return contention;
+}
+
+template<std::uint32_t SpinCountT>
+bool adaptive_lock<SpinCountT>::try_lock()
+{
+    std::uint32_t expected = unlocked;
+    return _state.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+template<std::uint32_t SpinCountT>
+void adaptive_lock<SpinCountT>::unlock()
+{
+    if (_state.exchange(unlocked, std::memory_order_release) == locked_with_waiters)
+    {
+        _state.notify_one();
+    }
+}
+
+} // namespace coal::lock_policy
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace coal::lock_policy {
+
+// What a single lock() went through before acquiring the lock, reported by every lock policy.
+struct lock_contention
+{
+    constexpr bool contended() const { return spins > 0 || waited; }
+
+    // iterations spent busy waiting on the lock
+    std::uint32_t spins{0};
+
+    // whether the thread was parked by the kernel
+    bool waited{false};
+};
+
+} // namespace coal::lock_policy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mutex>
+
+#include <coal/lock_policy/lock_contention.hpp>
+
+namespace coal::lock_policy {
+
+// std::mutex, parks the thread as soon as the lock is taken. Suits long critical sections and oversubscribed cores.
+class mutex
+{
+public:
+    lock_contention lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::mutex _mutex;
+};
+
+inline lock_contention mutex::lock()
+{
+    if (_mutex.try_lock())
+    {
+        return {};
+    }
+
+    _mutex.lock();
+
+    return {.waited = true};
+}
+
+inline bool mutex::try_lock()
+{
+    return _mutex.try_lock();
+}
+
+inline void mutex::unlock()
+{
+    _mutex.unlock();
+}
+
+} // namespace coal::lock_policy
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <coal/details/cpu_relax.hpp>
+#include <coal/lock_policy/lock_contention.hpp>
+
+namespace coal::lock_policy {
+
+// Spinlock granting the lock in arrival order: each thread takes a ticket and spins until it is served. No waiter
+// starves, at the cost of handing the lock to a waiter which may be descheduled: past YieldSpinsT spins a waiter
+// yields its time slice so the threads ahead of it in the queue can run. Never parks.
+template<std::uint32_t YieldSpinsT = 1024>
+class ticket_lock
+{
+public:
+    static constexpr std::uint32_t yield_spins = YieldSpinsT;
+
+    lock_contention lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::atomic<std::uint32_t> _next{0};
+    std::atomic<std::uint32_t> _serving{0};
+};
+
+template<std::uint32_t YieldSpinsT>
+lock_contention ticket_lock<YieldSpinsT>::lock()
+{
+    lock_contention contention;
+
+    const std::uint32_t ticket = _next.fetch_add(1, std::memory_order_relaxed);
+
+    while (_serving.load(std::memory_order_acquire) != ticket)
+    {
+        if (++contention.spins < YieldSpinsT)
+        {
+            details::cpu_relax();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    return contention;
+}
+
+template<std::uint32_t YieldSpinsT>
+bool ticket_lock<YieldSpinsT>::try_lock()
+{
+    std::uint32_t ticket = _serving.load(std::memory_order_acquire);
+
+    // only take a ticket when it is served right away
+    return _next.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+template<std::uint32_t YieldSpinsT>
+void ticket_lock<YieldSpinsT>::unlock()
+{
+    // only the owner writes the served ticket
+    _serving.store(_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+} // namespace coal::lock_policy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include <coal/details/cpu_relax.hpp>
+#include <coal/lock_policy/lock_contention.hpp>
+
+namespace coal::lock_policy {
+
+// Test and test-and-set spinlock. Waiters spin on a plain load, which stays in their cache until the owner releases
+// the lock, and double their pause count after each failed exchange up to MaxBackoffT to spread the retries.
+// Never parks, for short critical sections with no more threads than cores.
+template<std::uint32_t MaxBackoffT = 64>
+class ttas_spinlock
+{
+    static_assert(MaxBackoffT > 0, "Maximum backoff must be greater than zero.");
+
+public:
+    static constexpr std::uint32_t max_backoff = MaxBackoffT;
+
+    lock_contention lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::atomic<bool> _locked{false};
+};
+
+template<std::uint32_t MaxBackoffT>
+lock_contention ttas_spinlock<MaxBackoffT>::lock()
+{
+    lock_contention contention;
+    std::uint32_t backoff = 1;
+
+    while (_locked.exchange(true, std::memory_order_acquire))
+    {
+        do
+        {
+            for (std::uint32_t i = 0; i < backoff; ++i)
+            {
+                details::cpu_relax();
+            }
+
+            ++contention.spins;
+        } while (_locked.load(std::memory_order_relaxed));
+
+        backoff = std::min(backoff * 2, MaxBackoffT);
+    }
+
+    return contention;
+}
+
+template<std::uint32_t MaxBackoffT>
+bool ttas_spinlock<MaxBackoffT>::try_lock()
+{
+    return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(true, std::memory_order_acquire);
+}
+
+template<std::uint32_t MaxBackoffT>
+void ttas_spinlock<MaxBackoffT>::unlock()
+{
+    _locked.store(false, std::memory_order_release);
+}
+
+} // namespace coal::lock_policy
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/lock_policy/lock_contention.hpp>
+#include <coal/lock_policy/mutex.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+struct lock_stats
+{
+    // every lock taken by an operation
+    std::uint64_t acquisitions{0};
+
+    // acquisitions which found the lock taken
+    std::uint64_t contended_acquisitions{0};
+
+    // busy wait iterations, summed over the acquisitions
+    std::uint64_t spins{0};
+
+    // acquisitions which parked the thread
+    std::uint64_t waits{0};
+};
+
+// Makes AllocatorT thread-safe by running each operation under a lock of type LockT, one of the lock_policy types or
+// any class whose lock() returns a lock_policy::lock_contention. Meant for the tier of a composition threads actually
+// share, such as the large side of a segregator_allocator. Counters are updated while holding the lock.
+template<typename AllocatorT, typename LockT = lock_policy::mutex>
+class locked_allocator
+{
+public:
+    using allocator = AllocatorT;
+    using lock_type = LockT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+
+public:
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // not synchronized, only safe while no other thread uses the allocator
+    [[nodiscard]] const allocator& get_allocator() const;
+    [[nodiscard]] allocator& get_allocator();
+
+    template<typename Initializer>
+    void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] bool owns(const memory_block& block) const;
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_expand<U>)
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_deallocate_all<U>)
+    void deallocate_all();
+
+    [[nodiscard]] lock_stats get_lock_stats() const;
+    void reset_lock_stats();
+
+private:
+    // takes the lock and accounts for its contention
+    class guard
+    {
+    public:
+        explicit guard(const locked_allocator& owner);
+        ~guard();
+
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+    private:
+        const locked_allocator& _owner;
+    };
+
+    allocator _allocator;
+
+    mutable lock_type _lock;
+    mutable lock_stats _stats;
+};
+
+template<typename AllocatorT, typename LockT>
+locked_allocator<AllocatorT, LockT>::guard::guard(const locked_allocator& owner)
+    : _owner{owner}
+{
+    const lock_policy::lock_contention contention = _owner._lock.lock();
+
+    lock_stats& stats = _owner._stats;
+
+    ++stats.acquisitions;
+    stats.contended_acquisitions += contention.contended() ? 1 : 0;
+    stats.spins += contention.spins;
+    stats.waits += contention.waited ? 1 : 0;
+}
+
+template<typename AllocatorT, typename LockT>
+locked_allocator<AllocatorT, LockT>::guard::~guard()
+{
+    _owner._lock.unlock();
+}
+
+template<typename AllocatorT, typename LockT>
+constexpr std::size_t locked_allocator<AllocatorT, LockT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, typename LockT>
+const locked_allocator<AllocatorT, LockT>::allocator& locked_allocator<AllocatorT, LockT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, typename LockT>
+locked_allocator<AllocatorT, LockT>::allocator& locked_allocator<AllocatorT, LockT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, typename LockT>
+template<typename Initializer>
+void locked_allocator<AllocatorT, LockT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, typename LockT>
+memory_block locked_allocator<AllocatorT, LockT>::allocate(std::size_t size)
+{
+    guard lock{*this};
+    return _allocator.allocate(size);
+}
+
+template<typename AllocatorT, typename LockT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+bool locked_allocator<AllocatorT, LockT>::owns(const memory_block& block) const
+{
+    guard lock{*this};
+    return _allocator.owns(block);
+}
+
+template<typename AllocatorT, typename LockT>
+template<typename U>
+requires(allocator_traits::has_expand<U>)
+bool locked_allocator<AllocatorT, LockT>::expand(memory_block& block, std::size_t delta)
+{
+    guard lock{*this};
+    return _allocator.expand(block, delta);
+}
+
+template<typename AllocatorT, typename LockT>
+bool locked_allocator<AllocatorT, LockT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    guard lock{*this};
+    return _allocator.reallocate(block, new_size);
+}
+
+template<typename AllocatorT, typename LockT>
+void locked_allocator<AllocatorT, LockT>::deallocate(memory_block& block)
+{
+    guard lock{*this};
+    _allocator.deallocate(block);
+}
+
+template<typename AllocatorT, typename LockT>
+template<typename U>
+requires(allocator_traits::has_deallocate_all<U>)
+void locked_allocator<AllocatorT, LockT>::deallocate_all()
+{
+    guard lock{*this};
+    _allocator.deallocate_all();
+}
+
+template<typename AllocatorT, typename LockT>
+lock_stats locked_allocator<AllocatorT, LockT>::get_lock_stats() const
+{
+    // not counted, reading the counters would skew them
+    std::lock_guard lock{_lock};
+    return _stats;
+}
+
+template<typename AllocatorT, typename LockT>
+void locked_allocator<AllocatorT, LockT>::reset_lock_stats()
+{
+    std::lock_guard lock{_lock};
+    _stats = {};
+}
+
+} // namespace coal
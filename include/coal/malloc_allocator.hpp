@@ -4,6 +4,7 @@
 #include <cstdlib>
 
 #include <coal/alignment.hpp>
+#include <coal/details/usdt.hpp>
 #include <coal/memory_block.hpp>
 
 namespace coal {
@@ -38,11 +39,17 @@ constexpr void malloc_allocator::init(Initializer& initializer)
 
 constexpr memory_block malloc_allocator::allocate([[maybe_unused]] std::size_t size)
 {
-    return memory_block{std::malloc(size), size};
+    const memory_block block{std::malloc(size), size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
 }
 
 constexpr bool malloc_allocator::reallocate([[maybe_unused]] memory_block& block, [[maybe_unused]] std::size_t new_size)
 {
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
     if (void* ptr = std::realloc(block.ptr, new_size))
     {
         block.ptr = ptr;
@@ -55,6 +62,8 @@ constexpr bool malloc_allocator::reallocate([[maybe_unused]] memory_block& block
 
 constexpr void malloc_allocator::deallocate([[maybe_unused]] memory_block& block)
 {
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
     std::free(block.ptr);
 }
 
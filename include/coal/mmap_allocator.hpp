@@ -0,0 +1,406 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <coal/alignment.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/mapping_table.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+enum class mmap_options : std::uint32_t
+{
+    none = 0,
+
+    // fault every page in when mapping, MAP_POPULATE
+    populate = 1 << 0,
+
+    // ask for transparent huge pages with MADV_HUGEPAGE, mappings of a huge page or more are aligned to huge pages
+    transparent_huge_pages = 1 << 1,
+
+    // map from the hugetlbfs pool with MAP_HUGETLB, falls back to regular pages when the pool is empty
+    huge_tlb = 1 << 2
+};
+
+constexpr mmap_options operator|(mmap_options lhs, mmap_options rhs)
+{
+    return static_cast<mmap_options>(static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs));
+}
+
+constexpr mmap_options operator&(mmap_options lhs, mmap_options rhs)
+{
+    return static_cast<mmap_options>(static_cast<std::uint32_t>(lhs) & static_cast<std::uint32_t>(rhs));
+}
+
+constexpr bool has_mmap_option(mmap_options options, mmap_options option)
+{
+    return (options & option) == option;
+}
+
+namespace details {
+
+#if defined(MAP_POPULATE)
+inline constexpr int mmap_populate_flag = MAP_POPULATE;
+#else
+inline constexpr int mmap_populate_flag = 0;
+#endif
+
+} // namespace details
+
+// Leaf mapping each block directly from the kernel. Every block starts on a page, owns is exact since the mappings
+// are tracked, and reallocate moves pages with mremap instead of copying them. The mappings are released with the
+// allocator.
+template<mmap_options OptionsT = mmap_options::none>
+class mmap_allocator
+{
+public:
+    static constexpr mmap_options options = OptionsT;
+
+    // smallest page size of the supported platforms, the runtime page size may be larger
+    static constexpr std::size_t alignment = 0x1000;
+
+    static constexpr std::size_t huge_page_size = 0x200000;
+
+    [[nodiscard]] static std::size_t get_page_size();
+
+public:
+    mmap_allocator() = default;
+    ~mmap_allocator();
+
+    mmap_allocator(const mmap_allocator&) = delete;
+    mmap_allocator& operator=(const mmap_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // size rounded up to whole pages, huge pages with huge_tlb
+    [[nodiscard]] std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] std::size_t get_mapping_count() const;
+    [[nodiscard]] std::size_t get_mapped_bytes() const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+    [[nodiscard]] bool owns(const memory_block& block) const;
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+    void deallocate_all();
+
+private:
+    [[nodiscard]] static details::mapping map(std::size_t size);
+
+    // MAP_FAILED when the pages cannot be mapped
+    [[nodiscard]] static void* map_pages(std::size_t length, int flags);
+
+    // over-maps by a huge page then trims so the mapping starts on a huge page
+    [[nodiscard]] static void* map_huge_page_aligned(std::size_t length, int flags);
+
+    [[nodiscard]] static bool remap(details::mapping& mapping, std::size_t new_size, bool may_move);
+
+    details::mapping_table _mappings;
+};
+
+template<mmap_options OptionsT>
+std::size_t mmap_allocator<OptionsT>::get_page_size()
+{
+    static const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+template<mmap_options OptionsT>
+mmap_allocator<OptionsT>::~mmap_allocator()
+{
+    deallocate_all();
+}
+
+template<mmap_options OptionsT>
+constexpr std::size_t mmap_allocator<OptionsT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<mmap_options OptionsT>
+std::size_t mmap_allocator<OptionsT>::granted_size(std::size_t size) const
+{
+#if defined(MAP_HUGETLB)
+    if constexpr (has_mmap_option(OptionsT, mmap_options::huge_tlb))
+    {
+        return align_up(size, huge_page_size);
+    }
+#endif
+
+    return align_up(size, get_page_size());
+}
+
+template<mmap_options OptionsT>
+std::size_t mmap_allocator<OptionsT>::get_mapping_count() const
+{
+    return _mappings.size();
+}
+
+template<mmap_options OptionsT>
+std::size_t mmap_allocator<OptionsT>::get_mapped_bytes() const
+{
+    std::size_t bytes = 0;
+
+    for (const details::mapping& mapping : _mappings)
+    {
+        bytes += mapping.length;
+    }
+
+    return bytes;
+}
+
+template<mmap_options OptionsT>
+template<typename Initializer>
+constexpr void mmap_allocator<OptionsT>::init(Initializer& initializer)
+{
+    initializer.init(*this);
+}
+
+template<mmap_options OptionsT>
+memory_block mmap_allocator<OptionsT>::allocate(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    details::mapping mapping = map(size);
+
+    if (mapping.ptr == nullptr)
+    {
+        return nullblk;
+    }
+
+    if (!_mappings.insert(mapping))
+    {
+        munmap(mapping.ptr, mapping.length);
+        return nullblk;
+    }
+
+    const memory_block block{mapping.ptr, size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<mmap_options OptionsT>
+bool mmap_allocator<OptionsT>::owns(const memory_block& block) const
+{
+    return block && _mappings.find_containing(block.ptr, block.size) != nullptr;
+}
+
+template<mmap_options OptionsT>
+bool mmap_allocator<OptionsT>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    details::mapping* mapping = _mappings.find(block.ptr);
+
+    if (mapping == nullptr || !remap(*mapping, block.size + delta, false))
+    {
+        return false;
+    }
+
+    block.size += delta;
+    return true;
+}
+
+template<mmap_options OptionsT>
+bool mmap_allocator<OptionsT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    details::mapping* mapping = _mappings.find(block.ptr);
+
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    if (remap(*mapping, new_size, true))
+    {
+        // a moved mapping keeps the order of the table only if nothing was mapped between, so reinsert it
+        const details::mapping moved = *mapping;
+
+        _mappings.erase(mapping);
+        _mappings.insert(moved);
+
+        block = {moved.ptr, new_size};
+        return true;
+    }
+
+    return details::reallocate_with_new_allocator(*this, *this, block, new_size);
+}
+
+template<mmap_options OptionsT>
+void mmap_allocator<OptionsT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    if (details::mapping* mapping = _mappings.find(block.ptr))
+    {
+        munmap(mapping->ptr, mapping->length);
+        _mappings.erase(mapping);
+    }
+
+    block = nullblk;
+}
+
+template<mmap_options OptionsT>
+void mmap_allocator<OptionsT>::deallocate_all()
+{
+    for (const details::mapping& mapping : _mappings)
+    {
+        munmap(mapping.ptr, mapping.length);
+    }
+
+    _mappings.clear();
+}
+
+template<mmap_options OptionsT>
+details::mapping mmap_allocator<OptionsT>::map(std::size_t size)
+{
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    if constexpr (has_mmap_option(OptionsT, mmap_options::populate))
+    {
+        flags |= details::mmap_populate_flag;
+    }
+
+#if defined(MAP_HUGETLB)
+    if constexpr (has_mmap_option(OptionsT, mmap_options::huge_tlb))
+    {
+        const std::size_t length = align_up(size, huge_page_size);
+
+        if (void* ptr = map_pages(length, flags | MAP_HUGETLB); ptr != MAP_FAILED)
+        {
+            return {ptr, length};
+        }
+    }
+#endif
+
+    const std::size_t length = align_up(size, get_page_size());
+    void* ptr = MAP_FAILED;
+
+    if constexpr (has_mmap_option(OptionsT, mmap_options::transparent_huge_pages))
+    {
+        ptr = length >= huge_page_size ? map_huge_page_aligned(length, flags) : map_pages(length, flags);
+
+#if defined(MADV_HUGEPAGE)
+        if (ptr != MAP_FAILED)
+        {
+            // a hint, the kernel may have transparent huge pages disabled
+            madvise(ptr, length, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    else
+    {
+        ptr = map_pages(length, flags);
+    }
+
+    return ptr != MAP_FAILED ? details::mapping{ptr, length} : details::mapping{};
+}
+
+template<mmap_options OptionsT>
+void* mmap_allocator<OptionsT>::map_pages(std::size_t length, int flags)
+{
+    return mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+}
+
+template<mmap_options OptionsT>
+void* mmap_allocator<OptionsT>::map_huge_page_aligned(std::size_t length, int flags)
+{
+    // populate the trimmed mapping only
+    std::byte* ptr = static_cast<std::byte*>(map_pages(length + huge_page_size, flags & ~details::mmap_populate_flag));
+
+    if (ptr == MAP_FAILED)
+    {
+        return MAP_FAILED;
+    }
+
+    std::byte* aligned = reinterpret_cast<std::byte*>(align_up(reinterpret_cast<std::uintptr_t>(ptr), huge_page_size));
+
+    if (aligned != ptr)
+    {
+        munmap(ptr, static_cast<std::size_t>(aligned - ptr));
+    }
+
+    munmap(aligned + length, static_cast<std::size_t>(ptr + huge_page_size - aligned));
+
+#if defined(MADV_POPULATE_WRITE)
+    if ((flags & details::mmap_populate_flag) != 0)
+    {
+        madvise(aligned, length, MADV_POPULATE_WRITE);
+    }
+#endif
+
+    return aligned;
+}
+
+template<mmap_options OptionsT>
+bool mmap_allocator<OptionsT>::remap(details::mapping& mapping, std::size_t new_size, bool may_move)
+{
+    const std::size_t length = align_up(new_size, get_page_size());
+
+    if (length <= mapping.length)
+    {
+#if defined(__linux__)
+        // the pages past the new size go back to the kernel, a hugetlb mapping cannot be split and keeps them
+        if (length < mapping.length && mremap(mapping.ptr, mapping.length, length, 0) != MAP_FAILED)
+        {
+            mapping.length = length;
+        }
+#endif
+        return true;
+    }
+
+#if defined(__linux__)
+    void* ptr = mremap(mapping.ptr, mapping.length, length, may_move ? MREMAP_MAYMOVE : 0);
+
+    if (ptr == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mapping = {ptr, length};
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace coal
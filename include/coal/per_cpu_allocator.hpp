@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/current_cpu.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Thread-safe sharding of a single-threaded AllocatorT, one instance per CPU. A thread allocates from the instance of
+// the CPU it runs on, found with rseq, so threads only contend on an instance when they share a CPU or migrate in the
+// middle of a call. Each instance keeps a mutex for these cases. A block freed from another CPU goes back to the
+// instance which owns it. An instance out of memory falls back to the others.
+template<typename AllocatorT>
+class per_cpu_allocator
+{
+    static_assert(allocator_traits::has_owns<AllocatorT>, "Allocator must implement owns to route blocks back to their CPU.");
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+
+public:
+    // one shard per configured CPU
+    per_cpu_allocator();
+    explicit per_cpu_allocator(std::size_t shard_count);
+
+    per_cpu_allocator(const per_cpu_allocator&) = delete;
+    per_cpu_allocator& operator=(const per_cpu_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    [[nodiscard]] std::size_t get_shard_count() const;
+
+    // shard of the CPU the calling thread runs on
+    [[nodiscard]] std::size_t get_current_shard() const;
+
+    // not synchronized, only safe while no other thread uses the allocator
+    [[nodiscard]] const allocator& get_allocator(std::size_t shard) const;
+    [[nodiscard]] allocator& get_allocator(std::size_t shard);
+
+    template<typename Initializer>
+    void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+    [[nodiscard]] bool owns(const memory_block& block) const;
+
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_deallocate_all<U>)
+    void deallocate_all();
+
+private:
+    struct alignas(64) shard
+    {
+        std::mutex mutex;
+        allocator instance;
+    };
+
+    // calls function with the locked shard owning block, starting the search on the current CPU
+    template<typename Function>
+    bool with_owner(const memory_block& block, Function&& function) const;
+
+    std::size_t _shard_count;
+    std::unique_ptr<shard[]> _shards;
+};
+
+template<typename AllocatorT>
+per_cpu_allocator<AllocatorT>::per_cpu_allocator()
+    : per_cpu_allocator(details::cpu_count())
+{
+}
+
+template<typename AllocatorT>
+per_cpu_allocator<AllocatorT>::per_cpu_allocator(std::size_t shard_count)
+    : _shard_count{shard_count}
+    , _shards{std::make_unique<shard[]>(shard_count)}
+{
+    assert(shard_count > 0);
+}
+
+template<typename AllocatorT>
+constexpr std::size_t per_cpu_allocator<AllocatorT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT>
+std::size_t per_cpu_allocator<AllocatorT>::get_shard_count() const
+{
+    return _shard_count;
+}
+
+template<typename AllocatorT>
+std::size_t per_cpu_allocator<AllocatorT>::get_current_shard() const
+{
+    return details::current_cpu() % _shard_count;
+}
+
+template<typename AllocatorT>
+const per_cpu_allocator<AllocatorT>::allocator& per_cpu_allocator<AllocatorT>::get_allocator(std::size_t shard) const
+{
+    assert(shard < _shard_count);
+    return _shards[shard].instance;
+}
+
+template<typename AllocatorT>
+per_cpu_allocator<AllocatorT>::allocator& per_cpu_allocator<AllocatorT>::get_allocator(std::size_t shard)
+{
+    assert(shard < _shard_count);
+    return _shards[shard].instance;
+}
+
+template<typename AllocatorT>
+template<typename Initializer>
+void per_cpu_allocator<AllocatorT>::init(Initializer& initializer)
+{
+    for (std::size_t i = 0; i < _shard_count; ++i)
+    {
+        _shards[i].instance.init(initializer);
+    }
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT>
+memory_block per_cpu_allocator<AllocatorT>::allocate(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    const std::size_t current = get_current_shard();
+
+    for (std::size_t i = 0; i < _shard_count; ++i)
+    {
+        shard& shard = _shards[(current + i) % _shard_count];
+
+        std::lock_guard lock{shard.mutex};
+
+        if (memory_block block = shard.instance.allocate(size))
+        {
+            return block;
+        }
+    }
+
+    return nullblk;
+}
+
+template<typename AllocatorT>
+bool per_cpu_allocator<AllocatorT>::owns(const memory_block& block) const
+{
+    return block && with_owner(block, [](const allocator&) {});
+}
+
+template<typename AllocatorT>
+bool per_cpu_allocator<AllocatorT>::expand(memory_block& block, std::size_t delta)
+{
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    if constexpr (allocator_traits::has_expand<allocator>)
+    {
+        bool expanded = false;
+
+        with_owner(block, [&block, &expanded, delta](allocator& instance) { expanded = instance.expand(block, delta); });
+
+        return expanded;
+    }
+
+    return false;
+}
+
+template<typename AllocatorT>
+bool per_cpu_allocator<AllocatorT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    bool reallocated = false;
+
+    with_owner(block, [&block, &reallocated, new_size](allocator& instance) { reallocated = instance.reallocate(block, new_size); });
+
+    // the owner may be out of memory while another shard is not
+    return reallocated || details::reallocate_with_new_allocator(*this, *this, block, new_size);
+}
+
+template<typename AllocatorT>
+void per_cpu_allocator<AllocatorT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    const bool found = with_owner(block, [&block](allocator& instance) { instance.deallocate(block); });
+
+    assert(found && "Block not owned by any shard.");
+    (void)found;
+
+    block = nullblk;
+}
+
+template<typename AllocatorT>
+template<typename U>
+requires(allocator_traits::has_deallocate_all<U>)
+void per_cpu_allocator<AllocatorT>::deallocate_all()
+{
+    for (std::size_t i = 0; i < _shard_count; ++i)
+    {
+        std::lock_guard lock{_shards[i].mutex};
+        _shards[i].instance.deallocate_all();
+    }
+}
+
+template<typename AllocatorT>
+template<typename Function>
+bool per_cpu_allocator<AllocatorT>::with_owner(const memory_block& block, Function&& function) const
+{
+    const std::size_t current = get_current_shard();
+
+    for (std::size_t i = 0; i < _shard_count; ++i)
+    {
+        shard& shard = _shards[(current + i) % _shard_count];
+
+        std::lock_guard lock{shard.mutex};
+
+        if (shard.instance.owns(block))
+        {
+            function(shard.instance);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace coal
@@ -22,6 +22,11 @@ public:
 public:
     [[nodiscard]] constexpr std::size_t get_alignment() const;
 
+    // granted size of the outer block, size prefix included
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_granted_size<U>)
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     [[nodiscard]] constexpr const allocator& get_allocator() const;
     [[nodiscard]] constexpr allocator& get_allocator();
 
@@ -52,6 +57,14 @@ constexpr std::size_t prefixed_size_allocator<AllocatorT>::get_alignment() const
     return alignment;
 }
 
+template<typename AllocatorT>
+template<typename U>
+requires(allocator_traits::has_granted_size<U>)
+constexpr std::size_t prefixed_size_allocator<AllocatorT>::granted_size(std::size_t size) const
+{
+    return super::granted_size(size);
+}
+
 template<typename AllocatorT>
 constexpr const prefixed_size_allocator<AllocatorT>::allocator& prefixed_size_allocator<AllocatorT>::get_allocator() const
 {
@@ -22,6 +22,10 @@ public:
 
     [[nodiscard]] constexpr std::size_t get_alignment() const;
 
+    template<typename U = Allocator>
+    requires(allocator_traits::has_granted_size<U>)
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     [[nodiscard]] constexpr const allocator* get_allocator() const;
     [[nodiscard]] constexpr allocator* get_allocator();
     constexpr void set_allocator(allocator* allocator);
@@ -56,6 +60,15 @@ constexpr std::size_t proxy_allocator<Allocator>::get_alignment() const
     return _allocator->get_alignment();
 }
 
+template<typename Allocator>
+template<typename U>
+requires(allocator_traits::has_granted_size<U>)
+constexpr std::size_t proxy_allocator<Allocator>::granted_size(std::size_t size) const
+{
+    assert(_allocator);
+    return _allocator->granted_size(size);
+}
+
 template<typename Allocator>
 constexpr const proxy_allocator<Allocator>::allocator* proxy_allocator<Allocator>::get_allocator() const
 {
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <coal/allocator_traits.hpp>
+#include <coal/memory_block.hpp>
+#include <coal/trace/trace_recorder.hpp>
+
+namespace coal {
+
+// Forwards every call to the wrapped allocator and records it in a trace_recorder when one is set.
+template<typename AllocatorT>
+class recording_allocator
+{
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+
+public:
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    [[nodiscard]] constexpr trace_recorder* get_recorder() const;
+    constexpr void set_recorder(trace_recorder* recorder);
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_expand<U>)
+    constexpr bool expand(memory_block& block, std::size_t delta);
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_deallocate_all<U>)
+    constexpr void deallocate_all();
+
+private:
+    allocator _allocator;
+    trace_recorder* _recorder{nullptr};
+};
+
+template<typename AllocatorT>
+constexpr std::size_t recording_allocator<AllocatorT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT>
+constexpr const recording_allocator<AllocatorT>::allocator& recording_allocator<AllocatorT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT>
+constexpr recording_allocator<AllocatorT>::allocator& recording_allocator<AllocatorT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT>
+constexpr trace_recorder* recording_allocator<AllocatorT>::get_recorder() const
+{
+    return _recorder;
+}
+
+template<typename AllocatorT>
+constexpr void recording_allocator<AllocatorT>::set_recorder(trace_recorder* recorder)
+{
+    _recorder = recorder;
+}
+
+template<typename AllocatorT>
+template<typename Initializer>
+constexpr void recording_allocator<AllocatorT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT>
+constexpr memory_block recording_allocator<AllocatorT>::allocate(std::size_t size)
+{
+    memory_block block = _allocator.allocate(size);
+
+    if (_recorder && size > 0)
+    {
+        _recorder->record_allocate(block, size);
+    }
+
+    return block;
+}
+
+template<typename AllocatorT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+constexpr bool recording_allocator<AllocatorT>::owns(const memory_block& block) const
+{
+    return _allocator.owns(block);
+}
+
+template<typename AllocatorT>
+template<typename U>
+requires(allocator_traits::has_expand<U>)
+constexpr bool recording_allocator<AllocatorT>::expand(memory_block& block, std::size_t delta)
+{
+    const memory_block old_block = block;
+    const bool success = _allocator.expand(block, delta);
+
+    if (_recorder && delta > 0)
+    {
+        _recorder->record_expand(old_block, block, delta, success);
+    }
+
+    return success;
+}
+
+template<typename AllocatorT>
+constexpr bool recording_allocator<AllocatorT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    const memory_block old_block = block;
+    const bool success = _allocator.reallocate(block, new_size);
+
+    if (_recorder && (old_block || new_size > 0))
+    {
+        _recorder->record_reallocate(old_block, block, new_size, success);
+    }
+
+    return success;
+}
+
+template<typename AllocatorT>
+constexpr void recording_allocator<AllocatorT>::deallocate(memory_block& block)
+{
+    if (_recorder)
+    {
+        _recorder->record_deallocate(block);
+    }
+
+    _allocator.deallocate(block);
+}
+
+template<typename AllocatorT>
+template<typename U>
+requires(allocator_traits::has_deallocate_all<U>)
+constexpr void recording_allocator<AllocatorT>::deallocate_all()
+{
+    if (_recorder)
+    {
+        _recorder->record_deallocate_all();
+    }
+
+    _allocator.deallocate_all();
+}
+
+} // namespace coal
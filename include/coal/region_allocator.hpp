@@ -0,0 +1,310 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include <coal/alignment.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Bump allocator over a chain of chunks taken from AllocatorT. A chunk is linked when the current one is exhausted,
+// each one twice the size of the previous up to MaxChunkSizeT. Blocks are not reused individually, only the last
+// one can be given back, everything goes back to the parent with deallocate_all.
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT = ChunkSizeT * 64>
+class region_allocator
+{
+    struct chunk
+    {
+        chunk* previous{nullptr};
+        std::size_t size{0};
+    };
+
+    static constexpr std::size_t chunk_header_size = align_up(sizeof(chunk), AllocatorT::alignment);
+
+    static_assert(ChunkSizeT > chunk_header_size, "Chunk size must be greater than the chunk header.");
+    static_assert(MaxChunkSizeT >= ChunkSizeT, "Max chunk size must be greater or equal to chunk size.");
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t chunk_size = ChunkSizeT;
+    static constexpr std::size_t max_chunk_size = MaxChunkSizeT;
+
+public:
+    constexpr region_allocator() = default;
+    constexpr ~region_allocator();
+
+    region_allocator(const region_allocator&) = delete;
+    region_allocator& operator=(const region_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // size rounded up to the alignment, the region advances by that much
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    [[nodiscard]] constexpr std::size_t get_chunk_count() const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+    constexpr bool expand(memory_block& block, std::size_t delta);
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+    constexpr void deallocate_all();
+
+private:
+    [[nodiscard]] constexpr bool is_last_allocated_block(const memory_block& block) const;
+
+    // links a chunk holding at least size bytes past its header
+    constexpr bool acquire_chunk(std::size_t size);
+
+    chunk* _chunk{nullptr};
+    std::uint8_t* _ptr{nullptr};
+    std::uint8_t* _end{nullptr};
+    std::size_t _chunk_count{0};
+    std::size_t _next_chunk_size{ChunkSizeT};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::~region_allocator()
+{
+    deallocate_all();
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr std::size_t region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr std::size_t region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::granted_size(std::size_t size) const
+{
+    return align_up(size, alignment);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr const region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::allocator& region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::allocator& region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr std::size_t region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::get_chunk_count() const
+{
+    return _chunk_count;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+template<typename Initializer>
+constexpr void region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr memory_block region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::allocate(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    const std::size_t aligned_size = align_up(size, alignment);
+
+    if (static_cast<std::size_t>(_end - _ptr) < aligned_size && !acquire_chunk(aligned_size))
+    {
+        return nullblk;
+    }
+
+    memory_block block{_ptr, size};
+
+    _ptr += aligned_size;
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr bool region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::owns(const memory_block& block) const
+{
+    if (!block)
+    {
+        return false;
+    }
+
+    const std::uint8_t* ptr = block.as<const std::uint8_t>();
+
+    for (const chunk* current = _chunk; current; current = current->previous)
+    {
+        const std::uint8_t* begin = reinterpret_cast<const std::uint8_t*>(current);
+
+        if (ptr >= begin + chunk_header_size && ptr < begin + current->size)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr bool region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    if (!is_last_allocated_block(block))
+    {
+        return false;
+    }
+
+    std::uint8_t* new_ptr = block.as<std::uint8_t>() + align_up(block.size + delta, alignment);
+
+    if (new_ptr > _end)
+    {
+        return false;
+    }
+
+    _ptr = new_ptr;
+    block.size += delta;
+
+    return true;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr bool region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    const std::size_t aligned_new_size = align_up(new_size, alignment);
+
+    if (is_last_allocated_block(block) && block.as<std::uint8_t>() + aligned_new_size <= _end)
+    {
+        _ptr = block.as<std::uint8_t>() + aligned_new_size;
+        block.size = new_size;
+        return true;
+    }
+
+    if (aligned_new_size <= align_up(block.size, alignment))
+    {
+        block.size = new_size;
+        return true;
+    }
+
+    if (memory_block new_block = allocate(new_size))
+    {
+        std::memcpy(new_block.ptr, block.ptr, block.size);
+        block = new_block;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr void region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    if (is_last_allocated_block(block))
+    {
+        _ptr = block.as<std::uint8_t>();
+    }
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr void region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::deallocate_all()
+{
+    while (_chunk)
+    {
+        chunk* previous = _chunk->previous;
+
+        memory_block block{_chunk, _chunk->size};
+        _allocator.deallocate(block);
+
+        _chunk = previous;
+    }
+
+    _ptr = nullptr;
+    _end = nullptr;
+    _chunk_count = 0;
+    _next_chunk_size = ChunkSizeT;
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr bool region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::is_last_allocated_block(const memory_block& block) const
+{
+    return _ptr == block.as<std::uint8_t>() + align_up(block.size, alignment);
+}
+
+template<typename AllocatorT, std::size_t ChunkSizeT, std::size_t MaxChunkSizeT>
+constexpr bool region_allocator<AllocatorT, ChunkSizeT, MaxChunkSizeT>::acquire_chunk(std::size_t size)
+{
+    // a block larger than the next chunk gets a chunk of its own size, the growth is left as is
+    const std::size_t new_chunk_size = chunk_header_size + size > _next_chunk_size ? chunk_header_size + size : _next_chunk_size;
+
+    memory_block block = _allocator.allocate(new_chunk_size);
+
+    if (!block)
+    {
+        return false;
+    }
+
+    _chunk = ::new (block.ptr) chunk{_chunk, new_chunk_size};
+    _ptr = block.as<std::uint8_t>() + chunk_header_size;
+    _end = block.as<std::uint8_t>() + new_chunk_size;
+
+    ++_chunk_count;
+
+    if (new_chunk_size == _next_chunk_size)
+    {
+        _next_chunk_size = _next_chunk_size * 2 < MaxChunkSizeT ? _next_chunk_size * 2 : MaxChunkSizeT;
+    }
+
+    return true;
+}
+
+} // namespace coal
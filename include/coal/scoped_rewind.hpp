@@ -0,0 +1,52 @@
+#pragma once
+
+#include <coal/allocator_traits.hpp>
+
+namespace coal {
+
+// Marks the allocator on construction and rewinds it on destruction, freeing every block allocated in the scope.
+template<typename AllocatorT>
+requires(allocator_traits::has_mark<AllocatorT>)
+class scoped_rewind
+{
+public:
+    using allocator = AllocatorT;
+    using marker = typename allocator::marker;
+
+public:
+    constexpr explicit scoped_rewind(allocator& allocator);
+    constexpr ~scoped_rewind();
+
+    scoped_rewind(const scoped_rewind&) = delete;
+    scoped_rewind& operator=(const scoped_rewind&) = delete;
+
+    [[nodiscard]] constexpr const marker& get_marker() const;
+
+private:
+    allocator& _allocator;
+    marker _marker;
+};
+
+template<typename AllocatorT>
+requires(allocator_traits::has_mark<AllocatorT>)
+constexpr scoped_rewind<AllocatorT>::scoped_rewind(allocator& allocator)
+    : _allocator{allocator}
+    , _marker{allocator.mark()}
+{
+}
+
+template<typename AllocatorT>
+requires(allocator_traits::has_mark<AllocatorT>)
+constexpr scoped_rewind<AllocatorT>::~scoped_rewind()
+{
+    _allocator.rewind(_marker);
+}
+
+template<typename AllocatorT>
+requires(allocator_traits::has_mark<AllocatorT>)
+constexpr const scoped_rewind<AllocatorT>::marker& scoped_rewind<AllocatorT>::get_marker() const
+{
+    return _marker;
+}
+
+} // namespace coal
@@ -3,6 +3,7 @@
 #include <coal/alignment.hpp>
 #include <coal/allocator_traits.hpp>
 #include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/granted_size.hpp>
 #include <coal/memory_block.hpp>
 
 namespace coal {
@@ -20,6 +21,9 @@ public:
 public:
     [[nodiscard]] constexpr std::size_t get_alignment() const;
 
+    // granted size of the child serving size
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     [[nodiscard]] constexpr const small& get_small_allocator() const;
     [[nodiscard]] constexpr small& get_small_allocator();
 
@@ -61,6 +65,12 @@ constexpr std::size_t segregator_allocator<SmallAllocatorT, LargeAllocatorT, Thr
     return alignment;
 }
 
+template<typename SmallAllocatorT, typename LargeAllocatorT, std::size_t ThresholdT>
+constexpr std::size_t segregator_allocator<SmallAllocatorT, LargeAllocatorT, ThresholdT>::granted_size(std::size_t size) const
+{
+    return is_small(size) ? details::granted_size(_small, size) : details::granted_size(_large, size);
+}
+
 template<typename SmallAllocatorT, typename LargeAllocatorT, std::size_t ThresholdT>
 constexpr const segregator_allocator<SmallAllocatorT, LargeAllocatorT, ThresholdT>::small& segregator_allocator<SmallAllocatorT, LargeAllocatorT, ThresholdT>::get_small_allocator() const
 {
@@ -5,6 +5,7 @@
 
 #include <coal/allocator_traits.hpp>
 #include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/usdt.hpp>
 #include <coal/memory_block.hpp>
 
 namespace coal {
@@ -53,6 +54,9 @@ public:
 public:
     [[nodiscard]] constexpr std::size_t get_alignment() const;
 
+    // size of the slab serving size, size itself past max_size
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     [[nodiscard]] constexpr const allocator& get_allocator() const;
     [[nodiscard]] constexpr allocator& get_allocator();
 
@@ -105,6 +109,12 @@ constexpr std::size_t slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::
     return alignment;
 }
 
+template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
+constexpr std::size_t slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::granted_size(std::size_t size) const
+{
+    return size > 0 && size <= max_size ? size_at_index(index_for_size(size)) : size;
+}
+
 template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
 template<typename Initializer>
 constexpr void slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::init(Initializer& initializer)
@@ -153,6 +163,8 @@ constexpr bool slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::owns(co
 template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
 constexpr bool slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::expand(memory_block& block, std::size_t delta)
 {
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
     if (delta == 0)
     {
         return true;
@@ -179,13 +191,15 @@ constexpr bool slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::expand(
         return false;
     }
 
-    block.size = new_index;
+    block.size = new_size;
     return true;
 }
 
 template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
 constexpr bool slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::reallocate(memory_block& block, std::size_t new_size)
 {
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
     if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
     {
         return reallocated;
@@ -225,6 +239,8 @@ constexpr void slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::dealloc
         return;
     }
 
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
     _slabs[index].deallocate(block);
 
     block = nullblk;
@@ -253,6 +269,8 @@ void slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>::allocate_for_slab
     const std::size_t object_size = size_at_index(index);
     const std::size_t objects_count = block.size / object_size;
 
+    COAL_USDT_ALLOCATOR_PROBE(slab_refill, object_size, block.ptr, block.size);
+
     for (std::size_t i = 0; i < objects_count; ++i)
     {
         slab.deallocate_at(block, i * object_size);
@@ -271,9 +289,18 @@ constexpr memory_block slab_allocator<AllocatorT, SlabCapacityT, SlabSizesT...>:
     if (slab.first_free == nullptr)
     {
         allocate_for_slab(slab, index);
+
+        if (slab.first_free == nullptr)
+        {
+            return nullblk;
+        }
     }
 
-    return memory_block{slab.allocate(), size};
+    const memory_block block{slab.allocate(), size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
+    return block;
 }
 
 template<typename AllocatorT, std::size_t SlabCapacityT, std::size_t... SlabSizesT>
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+
 #include <coal/alignment.hpp>
 #include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/usdt.hpp>
 #include <coal/memory_block.hpp>
 
 namespace coal {
@@ -13,9 +17,18 @@ public:
     static constexpr std::size_t alignment = AlignmentT;
     static constexpr std::size_t max_size = SizeT;
 
+    // top of the stack, rewinding to it frees every block allocated since in one step
+    struct marker
+    {
+        std::uint8_t* ptr{nullptr};
+    };
+
 public:
     constexpr std::size_t get_alignment() const;
 
+    // size rounded up to the alignment, the stack advances by that much
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
     template<typename Initializer>
     constexpr void init(Initializer& initializer);
 
@@ -26,6 +39,11 @@ public:
     constexpr void deallocate(memory_block& block);
     constexpr void deallocate_all();
 
+    [[nodiscard]] constexpr marker mark() const;
+
+    // invalidates the markers taken after this one
+    constexpr void rewind(const marker& marker);
+
 private:
     constexpr bool is_last_allocated_unaligned_block(const memory_block& block) const;
 
@@ -40,6 +58,12 @@ constexpr std::size_t stack_allocator<SizeT, AlignmentT>::get_alignment() const
     return alignment;
 }
 
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr std::size_t stack_allocator<SizeT, AlignmentT>::granted_size(std::size_t size) const
+{
+    return align_up(size, alignment);
+}
+
 template<std::size_t SizeT, std::size_t AlignmentT>
 template<typename Initializer>
 constexpr void stack_allocator<SizeT, AlignmentT>::init(Initializer& initializer)
@@ -66,6 +90,8 @@ constexpr memory_block stack_allocator<SizeT, AlignmentT>::allocate(std::size_t
 
     _ptr += aligned_size;
 
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, block.ptr);
+
     return block;
 }
 
@@ -83,6 +109,8 @@ constexpr void stack_allocator<SizeT, AlignmentT>::deallocate(memory_block& bloc
         return;
     }
 
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
     if (is_last_allocated_unaligned_block(block))
     {
         _ptr = block.as<std::uint8_t>();
@@ -94,6 +122,8 @@ constexpr void stack_allocator<SizeT, AlignmentT>::deallocate(memory_block& bloc
 template<std::size_t SizeT, std::size_t AlignmentT>
 constexpr bool stack_allocator<SizeT, AlignmentT>::reallocate(memory_block& block, std::size_t new_size)
 {
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
     if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
     {
         return reallocated;
@@ -133,6 +163,8 @@ constexpr bool stack_allocator<SizeT, AlignmentT>::reallocate(memory_block& bloc
 template<std::size_t SizeT, std::size_t AlignmentT>
 constexpr bool stack_allocator<SizeT, AlignmentT>::expand(memory_block& block, std::size_t delta)
 {
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
     if (delta == 0)
     {
         return true;
@@ -168,6 +200,20 @@ constexpr void stack_allocator<SizeT, AlignmentT>::deallocate_all()
     _ptr = _data;
 }
 
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr stack_allocator<SizeT, AlignmentT>::marker stack_allocator<SizeT, AlignmentT>::mark() const
+{
+    return {_ptr};
+}
+
+template<std::size_t SizeT, std::size_t AlignmentT>
+constexpr void stack_allocator<SizeT, AlignmentT>::rewind(const marker& marker)
+{
+    assert(marker.ptr >= _data && marker.ptr <= _ptr);
+
+    _ptr = marker.ptr;
+}
+
 template<std::size_t SizeT, std::size_t AlignmentT>
 constexpr bool stack_allocator<SizeT, AlignmentT>::is_last_allocated_unaligned_block(const memory_block& block) const
 {
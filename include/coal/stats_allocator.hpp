@@ -0,0 +1,514 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/details/granted_size.hpp>
+#include <coal/details/size_histogram.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+enum class stats_options : std::uint32_t
+{
+    none = 0,
+
+    // calls per operation
+    calls = 1 << 0,
+
+    // failed allocate, reallocate and expand
+    failures = 1 << 1,
+
+    // bytes requested versus bytes granted, the latter rounded by the allocator granted_size when it has one
+    bytes = 1 << 2,
+
+    // current live bytes
+    live_bytes = 1 << 3,
+
+    // peak live bytes, the only metric not sharded per thread since a peak cannot be rebuilt from shards
+    peak_live_bytes = 1 << 4,
+
+    // log2 histogram of the sizes passed to each operation
+    size_histogram = 1 << 5,
+
+    all = calls | failures | bytes | live_bytes | peak_live_bytes | size_histogram
+};
+
+constexpr stats_options operator|(stats_options lhs, stats_options rhs)
+{
+    return static_cast<stats_options>(static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs));
+}
+
+constexpr stats_options operator&(stats_options lhs, stats_options rhs)
+{
+    return static_cast<stats_options>(static_cast<std::uint32_t>(lhs) & static_cast<std::uint32_t>(rhs));
+}
+
+constexpr bool has_stats_option(stats_options options, stats_options option)
+{
+    return (options & option) == option;
+}
+
+enum class stats_operation : std::uint8_t
+{
+    allocate,
+    deallocate,
+    reallocate,
+    expand,
+    owns,
+
+    count
+};
+
+// Aggregated view of a stats_allocator, disabled metrics stay at zero.
+struct allocator_stats
+{
+    static constexpr std::size_t operation_count = static_cast<std::size_t>(stats_operation::count);
+
+    // see details::size_histogram_bucket, bucket i counts sizes in [2^(i-1), 2^i)
+    static constexpr std::size_t histogram_bucket_count = 32;
+
+    static constexpr std::size_t histogram_bucket(std::size_t size);
+
+    [[nodiscard]] constexpr std::uint64_t get_calls(stats_operation operation) const;
+    [[nodiscard]] constexpr std::uint64_t get_failures(stats_operation operation) const;
+    [[nodiscard]] constexpr const std::array<std::uint64_t, histogram_bucket_count>& get_size_histogram(stats_operation operation) const;
+
+    std::array<std::uint64_t, operation_count> calls{};
+    std::array<std::uint64_t, operation_count> failures{};
+    std::uint64_t bytes_requested{0};
+    std::uint64_t bytes_granted{0};
+    std::int64_t live_bytes{0};
+    std::int64_t peak_live_bytes{0};
+    std::array<std::array<std::uint64_t, histogram_bucket_count>, operation_count> size_histograms{};
+};
+
+constexpr std::size_t allocator_stats::histogram_bucket(std::size_t size)
+{
+    return details::size_histogram_bucket<histogram_bucket_count>(size);
+}
+
+constexpr std::uint64_t allocator_stats::get_calls(stats_operation operation) const
+{
+    return calls[static_cast<std::size_t>(operation)];
+}
+
+constexpr std::uint64_t allocator_stats::get_failures(stats_operation operation) const
+{
+    return failures[static_cast<std::size_t>(operation)];
+}
+
+constexpr const std::array<std::uint64_t, allocator_stats::histogram_bucket_count>& allocator_stats::get_size_histogram(stats_operation operation) const
+{
+    return size_histograms[static_cast<std::size_t>(operation)];
+}
+
+namespace details {
+
+template<stats_options OptionT>
+struct disabled_stat
+{};
+
+// threads get consecutive indices so the first ShardCountT threads never share a shard
+inline std::size_t this_thread_stats_index()
+{
+    static std::atomic<std::size_t> next_index{0};
+    static thread_local const std::size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace details
+
+// Collects statistics on the calls made to the wrapped allocator.
+// Each metric is selected by OptionsT, disabled ones take no space and no instruction. Counters are spread over
+// ShardCountT cache-line sized shards indexed by thread and summed by get_stats(), so the allocator can stay
+// enabled on hot paths. The wrapped allocator itself is not made thread-safe.
+template<typename AllocatorT, stats_options OptionsT = stats_options::all, std::size_t ShardCountT = 16>
+class stats_allocator
+{
+    static_assert(ShardCountT > 0, "Shard count must be greater than zero.");
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr stats_options options = OptionsT;
+    static constexpr std::size_t shard_count = ShardCountT;
+
+    static constexpr bool has_option(stats_options option);
+
+public:
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] constexpr memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] constexpr bool owns(const memory_block& block) const;
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_expand<U>)
+    constexpr bool expand(memory_block& block, std::size_t delta);
+    constexpr bool reallocate(memory_block& block, std::size_t new_size);
+    constexpr void deallocate(memory_block& block);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_deallocate_all<U>)
+    constexpr void deallocate_all();
+
+    [[nodiscard]] allocator_stats get_stats() const;
+    void reset_stats();
+
+private:
+    using counter = std::atomic<std::uint64_t>;
+    using signed_counter = std::atomic<std::int64_t>;
+
+    // each disabled metric gets its own empty type so [[no_unique_address]] can overlap them
+    template<stats_options OptionT, typename T>
+    using optional_stat = std::conditional_t<has_option(OptionT), T, details::disabled_stat<OptionT>>;
+
+    static constexpr std::size_t operation_count = allocator_stats::operation_count;
+    static constexpr std::size_t histogram_bucket_count = allocator_stats::histogram_bucket_count;
+
+    struct alignas(64) shard
+    {
+        [[no_unique_address]] optional_stat<stats_options::calls, std::array<counter, operation_count>> calls{};
+        [[no_unique_address]] optional_stat<stats_options::failures, std::array<counter, operation_count>> failures{};
+        [[no_unique_address]] optional_stat<stats_options::bytes, std::array<counter, 2>> bytes{};
+        [[no_unique_address]] optional_stat<stats_options::live_bytes, signed_counter> live_bytes{};
+        [[no_unique_address]] optional_stat<stats_options::size_histogram, std::array<std::array<counter, histogram_bucket_count>, operation_count>> size_histograms{};
+    };
+
+    struct peak
+    {
+        signed_counter live_bytes{0};
+        signed_counter peak_live_bytes{0};
+    };
+
+    static constexpr bool has_shards = has_option(stats_options::calls) || has_option(stats_options::failures) || has_option(stats_options::bytes) || has_option(stats_options::live_bytes) || has_option(stats_options::size_histogram);
+
+    static void increment(counter& c, std::uint64_t value = 1);
+
+    shard& get_shard() const;
+
+    // bytes the wrapped allocator really takes for a block of size, zero for no block
+    [[nodiscard]] std::size_t granted_bytes(std::size_t size) const;
+
+    void record_call(stats_operation operation, std::size_t size) const;
+    void record_result(stats_operation operation, bool success, std::size_t requested, std::size_t granted);
+    void record_live_bytes(std::int64_t delta);
+
+    allocator _allocator;
+
+    [[no_unique_address]] mutable std::conditional_t<has_shards, std::array<shard, ShardCountT>, details::disabled_stat<stats_options::none>> _shards{};
+    [[no_unique_address]] optional_stat<stats_options::peak_live_bytes, peak> _peak{};
+};
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr bool stats_allocator<AllocatorT, OptionsT, ShardCountT>::has_option(stats_options option)
+{
+    return has_stats_option(OptionsT, option);
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr std::size_t stats_allocator<AllocatorT, OptionsT, ShardCountT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr const stats_allocator<AllocatorT, OptionsT, ShardCountT>::allocator& stats_allocator<AllocatorT, OptionsT, ShardCountT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr stats_allocator<AllocatorT, OptionsT, ShardCountT>::allocator& stats_allocator<AllocatorT, OptionsT, ShardCountT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+template<typename Initializer>
+constexpr void stats_allocator<AllocatorT, OptionsT, ShardCountT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr memory_block stats_allocator<AllocatorT, OptionsT, ShardCountT>::allocate(std::size_t size)
+{
+    record_call(stats_operation::allocate, size);
+
+    memory_block block = _allocator.allocate(size);
+
+    record_result(stats_operation::allocate, block || size == 0, size, granted_bytes(block.size));
+    record_live_bytes(static_cast<std::int64_t>(block.size));
+
+    return block;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+constexpr bool stats_allocator<AllocatorT, OptionsT, ShardCountT>::owns(const memory_block& block) const
+{
+    record_call(stats_operation::owns, block.size);
+
+    return _allocator.owns(block);
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+template<typename U>
+requires(allocator_traits::has_expand<U>)
+constexpr bool stats_allocator<AllocatorT, OptionsT, ShardCountT>::expand(memory_block& block, std::size_t delta)
+{
+    record_call(stats_operation::expand, delta);
+
+    const std::size_t old_size = block.size;
+    const bool success = _allocator.expand(block, delta);
+
+    record_result(stats_operation::expand, success, delta, success ? granted_bytes(block.size) - granted_bytes(old_size) : 0);
+    record_live_bytes(static_cast<std::int64_t>(block.size) - static_cast<std::int64_t>(old_size));
+
+    return success;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr bool stats_allocator<AllocatorT, OptionsT, ShardCountT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    record_call(stats_operation::reallocate, new_size);
+
+    const std::size_t old_size = block.size;
+    const bool success = _allocator.reallocate(block, new_size);
+
+    record_result(stats_operation::reallocate, success, new_size, success ? granted_bytes(block.size) : 0);
+    record_live_bytes(static_cast<std::int64_t>(block.size) - static_cast<std::int64_t>(old_size));
+
+    return success;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+constexpr void stats_allocator<AllocatorT, OptionsT, ShardCountT>::deallocate(memory_block& block)
+{
+    record_call(stats_operation::deallocate, block.size);
+    record_live_bytes(-static_cast<std::int64_t>(block.size));
+
+    _allocator.deallocate(block);
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+template<typename U>
+requires(allocator_traits::has_deallocate_all<U>)
+constexpr void stats_allocator<AllocatorT, OptionsT, ShardCountT>::deallocate_all()
+{
+    _allocator.deallocate_all();
+
+    if constexpr (has_option(stats_options::live_bytes))
+    {
+        for (shard& s : _shards)
+        {
+            s.live_bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    if constexpr (has_option(stats_options::peak_live_bytes))
+    {
+        _peak.live_bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+allocator_stats stats_allocator<AllocatorT, OptionsT, ShardCountT>::get_stats() const
+{
+    allocator_stats stats;
+
+    if constexpr (has_shards)
+    {
+        for (const shard& s : _shards)
+        {
+            for (std::size_t op = 0; op < operation_count; ++op)
+            {
+                if constexpr (has_option(stats_options::calls))
+                {
+                    stats.calls[op] += s.calls[op].load(std::memory_order_relaxed);
+                }
+
+                if constexpr (has_option(stats_options::failures))
+                {
+                    stats.failures[op] += s.failures[op].load(std::memory_order_relaxed);
+                }
+
+                if constexpr (has_option(stats_options::size_histogram))
+                {
+                    for (std::size_t bucket = 0; bucket < histogram_bucket_count; ++bucket)
+                    {
+                        stats.size_histograms[op][bucket] += s.size_histograms[op][bucket].load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            if constexpr (has_option(stats_options::bytes))
+            {
+                stats.bytes_requested += s.bytes[0].load(std::memory_order_relaxed);
+                stats.bytes_granted += s.bytes[1].load(std::memory_order_relaxed);
+            }
+
+            if constexpr (has_option(stats_options::live_bytes))
+            {
+                stats.live_bytes += s.live_bytes.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if constexpr (has_option(stats_options::peak_live_bytes))
+    {
+        if constexpr (!has_option(stats_options::live_bytes))
+        {
+            stats.live_bytes = _peak.live_bytes.load(std::memory_order_relaxed);
+        }
+
+        stats.peak_live_bytes = _peak.peak_live_bytes.load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+void stats_allocator<AllocatorT, OptionsT, ShardCountT>::reset_stats()
+{
+    if constexpr (has_shards)
+    {
+        for (shard& s : _shards)
+        {
+            // live bytes describe the allocator state, they survive a reset
+            if constexpr (has_option(stats_options::calls))
+            {
+                for (counter& c : s.calls) c.store(0, std::memory_order_relaxed);
+            }
+
+            if constexpr (has_option(stats_options::failures))
+            {
+                for (counter& c : s.failures) c.store(0, std::memory_order_relaxed);
+            }
+
+            if constexpr (has_option(stats_options::bytes))
+            {
+                for (counter& c : s.bytes) c.store(0, std::memory_order_relaxed);
+            }
+
+            if constexpr (has_option(stats_options::size_histogram))
+            {
+                for (auto& histogram : s.size_histograms)
+                {
+                    for (counter& c : histogram) c.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    if constexpr (has_option(stats_options::peak_live_bytes))
+    {
+        _peak.peak_live_bytes.store(_peak.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+void stats_allocator<AllocatorT, OptionsT, ShardCountT>::increment(counter& c, std::uint64_t value)
+{
+    c.fetch_add(value, std::memory_order_relaxed);
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+stats_allocator<AllocatorT, OptionsT, ShardCountT>::shard& stats_allocator<AllocatorT, OptionsT, ShardCountT>::get_shard() const
+{
+    if constexpr (ShardCountT == 1)
+    {
+        return _shards[0];
+    }
+    else
+    {
+        return _shards[details::this_thread_stats_index() % ShardCountT];
+    }
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+std::size_t stats_allocator<AllocatorT, OptionsT, ShardCountT>::granted_bytes(std::size_t size) const
+{
+    return size ? details::granted_size(_allocator, size) : 0;
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+void stats_allocator<AllocatorT, OptionsT, ShardCountT>::record_call(stats_operation operation, std::size_t size) const
+{
+    if constexpr (has_option(stats_options::calls) || has_option(stats_options::size_histogram))
+    {
+        shard& s = get_shard();
+        const std::size_t op = static_cast<std::size_t>(operation);
+
+        if constexpr (has_option(stats_options::calls))
+        {
+            increment(s.calls[op]);
+        }
+
+        if constexpr (has_option(stats_options::size_histogram))
+        {
+            increment(s.size_histograms[op][allocator_stats::histogram_bucket(size)]);
+        }
+    }
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+void stats_allocator<AllocatorT, OptionsT, ShardCountT>::record_result(stats_operation operation, bool success, std::size_t requested, std::size_t granted)
+{
+    if constexpr (has_option(stats_options::failures) || has_option(stats_options::bytes))
+    {
+        shard& s = get_shard();
+
+        if constexpr (has_option(stats_options::failures))
+        {
+            if (!success)
+            {
+                increment(s.failures[static_cast<std::size_t>(operation)]);
+            }
+        }
+
+        if constexpr (has_option(stats_options::bytes))
+        {
+            increment(s.bytes[0], requested);
+            increment(s.bytes[1], granted);
+        }
+    }
+}
+
+template<typename AllocatorT, stats_options OptionsT, std::size_t ShardCountT>
+void stats_allocator<AllocatorT, OptionsT, ShardCountT>::record_live_bytes(std::int64_t delta)
+{
+    if constexpr (has_option(stats_options::live_bytes))
+    {
+        get_shard().live_bytes.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    if constexpr (has_option(stats_options::peak_live_bytes))
+    {
+        const std::int64_t live_bytes = _peak.live_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+        std::int64_t peak_live_bytes = _peak.peak_live_bytes.load(std::memory_order_relaxed);
+
+        while (live_bytes > peak_live_bytes && !_peak.peak_live_bytes.compare_exchange_weak(peak_live_bytes, live_bytes, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+} // namespace coal
@@ -0,0 +1,548 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/bucketizer.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Thread-safe front-end over a single-threaded AllocatorT. Every thread keeps a cache of free blocks per bucket of
+// BucketPolicyT, a thread moves BatchSizeT blocks at once between its cache and the allocator, which is behind a
+// mutex. A thread flushes its caches on exit and leaves them to the next thread. Sizes above the buckets go to the
+// allocator directly.
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT = 32>
+class thread_cache_allocator
+{
+    struct cached_block
+    {
+        cached_block* next{nullptr};
+    };
+
+    static_assert(BucketPolicyT::bucket_count > 0, "Bucket policy must have at least one bucket.");
+    static_assert(BucketPolicyT::min_size >= sizeof(cached_block), "Each bucket size must hold a pointer.");
+    static_assert(details::are_bucket_sizes_aligned<BucketPolicyT>(AllocatorT::alignment), "Each bucket size must be a multiple of alignment.");
+    static_assert(BatchSizeT > 0, "Batch size must be greater than zero.");
+
+public:
+    using allocator = AllocatorT;
+    using bucket_policy = BucketPolicyT;
+
+    static constexpr std::size_t alignment = allocator::alignment;
+    static constexpr std::size_t bucket_count = bucket_policy::bucket_count;
+    static constexpr std::size_t max_size = bucket_policy::max_size;
+    static constexpr std::size_t batch_size = BatchSizeT;
+
+    // a bucket holding this many blocks flushes a batch back to the allocator
+    static constexpr std::size_t max_cached_count = BatchSizeT * 2;
+
+public:
+    thread_cache_allocator();
+    ~thread_cache_allocator();
+
+    thread_cache_allocator(const thread_cache_allocator&) = delete;
+    thread_cache_allocator& operator=(const thread_cache_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // not synchronized, only safe while no other thread uses the allocator
+    [[nodiscard]] const allocator& get_allocator() const;
+    [[nodiscard]] allocator& get_allocator();
+
+    // caches of the threads using the allocator plus the ones left by exited threads
+    [[nodiscard]] std::size_t get_cache_count() const;
+
+    // blocks in the cache of the calling thread, 0 when it has none yet
+    [[nodiscard]] std::size_t get_thread_cached_count() const;
+
+    template<typename Initializer>
+    void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+
+    template<typename U = AllocatorT>
+    requires(allocator_traits::has_owns<U>)
+    [[nodiscard]] bool owns(const memory_block& block) const;
+
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+
+    // returns the blocks cached by the calling thread to the allocator
+    void flush_thread_cache();
+
+private:
+    struct cached_list
+    {
+        cached_block* first{nullptr};
+        std::size_t count{0};
+    };
+
+    struct alignas(64) cache
+    {
+        std::array<cached_list, bucket_count> lists{};
+        cache* next{nullptr};
+        bool orphan{false};
+    };
+
+    // caches of the calling thread, one per allocator it used, flushed and orphaned when the thread exits
+    struct thread_caches
+    {
+        struct entry
+        {
+            std::uint64_t id{0};
+            cache* ptr{nullptr};
+        };
+
+        ~thread_caches();
+
+        std::uint64_t last_id{0};
+        cache* last_cache{nullptr};
+        std::vector<entry> entries;
+    };
+
+    // cache of the calling thread, nullptr when it has none for this allocator
+    [[nodiscard]] cache* find_cache() const;
+    [[nodiscard]] cache& get_cache();
+    [[nodiscard]] cache& acquire_cache();
+    void release_cache(cache& cache);
+
+    // both expect _mutex to be locked
+    void refill(cached_list& list, std::size_t index);
+    void flush(cached_list& list, std::size_t index, std::size_t count);
+
+    [[nodiscard]] static thread_cache_allocator* find_live(std::uint64_t id);
+
+    // live allocators, guards the registration of the caches of every thread, locked before any _mutex
+    inline static std::mutex _registry_mutex;
+    inline static std::vector<thread_cache_allocator*> _registry;
+    inline static std::atomic<std::uint64_t> _next_id{1};
+
+    inline static thread_local thread_caches _thread_caches;
+
+    const std::uint64_t _id{_next_id.fetch_add(1, std::memory_order_relaxed)};
+
+    // guards _allocator and _caches
+    mutable std::mutex _mutex;
+    cache* _caches{nullptr};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::thread_caches::~thread_caches()
+{
+    std::lock_guard lock{_registry_mutex};
+
+    for (const entry& entry : entries)
+    {
+        // the allocator may have been destroyed before the thread exits
+        if (thread_cache_allocator* allocator = find_live(entry.id))
+        {
+            allocator->release_cache(*entry.ptr);
+        }
+    }
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::thread_cache_allocator()
+{
+    std::lock_guard lock{_registry_mutex};
+    _registry.push_back(this);
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::~thread_cache_allocator()
+{
+    {
+        std::lock_guard lock{_registry_mutex};
+        std::erase(_registry, this);
+    }
+
+    // no thread can release a cache anymore, every cached block goes back to the allocator
+    while (_caches)
+    {
+        cache* next = _caches->next;
+
+        for (std::size_t index = 0; index < bucket_count; ++index)
+        {
+            flush(_caches->lists[index], index, _caches->lists[index].count);
+        }
+
+        delete _caches;
+        _caches = next;
+    }
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+constexpr std::size_t thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+const thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::allocator& thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::allocator& thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+std::size_t thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::get_cache_count() const
+{
+    std::lock_guard lock{_mutex};
+
+    std::size_t count = 0;
+
+    for (const cache* current = _caches; current; current = current->next)
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+std::size_t thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::get_thread_cached_count() const
+{
+    const cache* cache = find_cache();
+
+    if (!cache)
+    {
+        return 0;
+    }
+
+    std::size_t count = 0;
+
+    for (const cached_list& list : cache->lists)
+    {
+        count += list.count;
+    }
+
+    return count;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+template<typename Initializer>
+void thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+memory_block thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::allocate(std::size_t size)
+{
+    if (size == 0)
+    {
+        return nullblk;
+    }
+
+    if (size > max_size)
+    {
+        std::lock_guard lock{_mutex};
+        return _allocator.allocate(size);
+    }
+
+    const std::size_t index = bucket_policy::index_for_size(size);
+    cached_list& list = get_cache().lists[index];
+
+    if (!list.first)
+    {
+        std::lock_guard lock{_mutex};
+        refill(list, index);
+
+        if (!list.first)
+        {
+            return nullblk;
+        }
+    }
+
+    cached_block* block = list.first;
+
+    list.first = block->next;
+    --list.count;
+
+    return {block, size};
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+template<typename U>
+requires(allocator_traits::has_owns<U>)
+bool thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::owns(const memory_block& block) const
+{
+    if (!block)
+    {
+        return false;
+    }
+
+    std::lock_guard lock{_mutex};
+
+    if (block.size > max_size)
+    {
+        return _allocator.owns(block);
+    }
+
+    return _allocator.owns({block.ptr, bucket_policy::size_at_index(bucket_policy::index_for_size(block.size))});
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+bool thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::expand(memory_block& block, std::size_t delta)
+{
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    if (block.size > max_size)
+    {
+        if constexpr (allocator_traits::has_expand<allocator>)
+        {
+            std::lock_guard lock{_mutex};
+            return _allocator.expand(block, delta);
+        }
+
+        return false;
+    }
+
+    // a cached block cannot leave its bucket in place
+    if (new_size > max_size || bucket_policy::index_for_size(new_size) != bucket_policy::index_for_size(block.size))
+    {
+        return false;
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+bool thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::reallocate(memory_block& block, std::size_t new_size)
+{
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    if (block.size > max_size && new_size > max_size)
+    {
+        std::lock_guard lock{_mutex};
+        return _allocator.reallocate(block, new_size);
+    }
+
+    if (block.size <= max_size && new_size <= max_size && bucket_policy::index_for_size(new_size) == bucket_policy::index_for_size(block.size))
+    {
+        block.size = new_size;
+        return true;
+    }
+
+    return details::reallocate_with_new_allocator(*this, *this, block, new_size);
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+void thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    if (block.size > max_size)
+    {
+        std::lock_guard lock{_mutex};
+        _allocator.deallocate(block);
+    }
+    else
+    {
+        // the block goes to the cache of the calling thread, whichever thread allocated it
+        const std::size_t index = bucket_policy::index_for_size(block.size);
+        cached_list& list = get_cache().lists[index];
+
+        cached_block* cached = block.as<cached_block>();
+
+        cached->next = list.first;
+        list.first = cached;
+        ++list.count;
+
+        if (list.count >= max_cached_count)
+        {
+            std::lock_guard lock{_mutex};
+            flush(list, index, BatchSizeT);
+        }
+    }
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+void thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::flush_thread_cache()
+{
+    cache& cache = get_cache();
+
+    std::lock_guard lock{_mutex};
+
+    for (std::size_t index = 0; index < bucket_count; ++index)
+    {
+        flush(cache.lists[index], index, cache.lists[index].count);
+    }
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::cache* thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::find_cache() const
+{
+    thread_caches& caches = _thread_caches;
+
+    if (caches.last_id == _id)
+    {
+        return caches.last_cache;
+    }
+
+    for (const typename thread_caches::entry& entry : caches.entries)
+    {
+        if (entry.id == _id)
+        {
+            caches.last_id = entry.id;
+            caches.last_cache = entry.ptr;
+            return entry.ptr;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::cache& thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::get_cache()
+{
+    if (cache* cache = find_cache())
+    {
+        return *cache;
+    }
+
+    return acquire_cache();
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::cache& thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::acquire_cache()
+{
+    std::lock_guard registry_lock{_registry_mutex};
+
+    thread_caches& caches = _thread_caches;
+
+    // entries of destroyed allocators are dropped here since their allocator cannot reach this thread
+    std::erase_if(caches.entries, [](const typename thread_caches::entry& entry) { return find_live(entry.id) == nullptr; });
+
+    cache* acquired = nullptr;
+
+    {
+        std::lock_guard lock{_mutex};
+
+        for (cache* current = _caches; current && !acquired; current = current->next)
+        {
+            if (current->orphan)
+            {
+                acquired = current;
+            }
+        }
+
+        if (!acquired)
+        {
+            acquired = new cache{};
+            acquired->next = _caches;
+            _caches = acquired;
+        }
+
+        acquired->orphan = false;
+    }
+
+    caches.entries.push_back({_id, acquired});
+    caches.last_id = _id;
+    caches.last_cache = acquired;
+
+    return *acquired;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+void thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::release_cache(cache& cache)
+{
+    std::lock_guard lock{_mutex};
+
+    for (std::size_t index = 0; index < bucket_count; ++index)
+    {
+        flush(cache.lists[index], index, cache.lists[index].count);
+    }
+
+    cache.orphan = true;
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+void thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::refill(cached_list& list, std::size_t index)
+{
+    const std::size_t size = bucket_policy::size_at_index(index);
+
+    for (std::size_t i = 0; i < BatchSizeT; ++i)
+    {
+        memory_block block = _allocator.allocate(size);
+
+        if (!block)
+        {
+            break;
+        }
+
+        cached_block* cached = block.as<cached_block>();
+
+        cached->next = list.first;
+        list.first = cached;
+        ++list.count;
+    }
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+void thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::flush(cached_list& list, std::size_t index, std::size_t count)
+{
+    const std::size_t size = bucket_policy::size_at_index(index);
+
+    for (std::size_t i = 0; i < count && list.first; ++i)
+    {
+        cached_block* cached = list.first;
+
+        list.first = cached->next;
+        --list.count;
+
+        memory_block block{cached, size};
+        _allocator.deallocate(block);
+    }
+}
+
+template<typename AllocatorT, typename BucketPolicyT, std::size_t BatchSizeT>
+thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>* thread_cache_allocator<AllocatorT, BucketPolicyT, BatchSizeT>::find_live(std::uint64_t id)
+{
+    for (thread_cache_allocator* allocator : _registry)
+    {
+        if (allocator->_id == id)
+        {
+            return allocator;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace coal
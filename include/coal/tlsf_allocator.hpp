@@ -0,0 +1,588 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <coal/alignment.hpp>
+#include <coal/details/allocator_reallocation.hpp>
+#include <coal/details/usdt.hpp>
+#include <coal/memory_block.hpp>
+
+namespace coal {
+
+// Two-level segregated fit allocator over one pool of PoolSizeT bytes taken from the parent allocator, with constant
+// time allocate and deallocate. Free blocks are binned by the power of two of their size (first level) and by
+// 2^SecondLevelLog2T linear subdivisions of it (second level), a bitmap per level finds the first non-empty bin large
+// enough with two bit scans. Blocks are split on allocation, every block carries a header linking its physical
+// predecessor so a freed block merges with its free neighbours right away.
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T = 4>
+class tlsf_allocator
+{
+    struct block_header
+    {
+        static constexpr std::size_t free_bit = 1;
+
+        [[nodiscard]] std::size_t get_size() const { return size_and_flags & ~free_bit; }
+        [[nodiscard]] bool is_free() const { return size_and_flags & free_bit; }
+
+        // previous block in the pool, nullptr for the first one
+        block_header* previous_physical;
+
+        // payload size, its lowest bit tells whether the block is free
+        std::size_t size_and_flags;
+    };
+
+    // stored in the payload of free blocks
+    struct free_links
+    {
+        block_header* previous;
+        block_header* next;
+    };
+
+public:
+    using allocator = AllocatorT;
+
+    static constexpr std::size_t alignment = 16;
+    static constexpr std::size_t pool_size = PoolSizeT;
+    static constexpr std::size_t second_level_count = std::size_t{1} << SecondLevelLog2T;
+
+private:
+    static constexpr std::size_t header_size = align_up(sizeof(block_header), alignment);
+    static constexpr std::size_t min_block_size = align_up(sizeof(free_links), alignment);
+
+    // sizes below small_block_size all go to the first first-level bin, one second-level bin per alignment step
+    static constexpr std::size_t first_level_shift = SecondLevelLog2T + std::countr_zero(alignment);
+    static constexpr std::size_t small_block_size = std::size_t{1} << first_level_shift;
+    static constexpr std::size_t first_level_count = static_cast<std::size_t>(std::bit_width(PoolSizeT)) - first_level_shift + 1;
+
+    static_assert(SecondLevelLog2T > 0 && SecondLevelLog2T <= 5, "Second level must hold between 2 and 32 bins.");
+    static_assert(PoolSizeT >= small_block_size, "Pool size must be greater or equal to the small block size.");
+    static_assert(first_level_count <= 64, "First level count must fit in a 64-bit mask.");
+
+public:
+    // largest block the pool can serve when it holds nothing else
+    static constexpr std::size_t max_size = align_down(PoolSizeT - alignment, alignment) - 2 * header_size;
+
+public:
+    constexpr tlsf_allocator() = default;
+    ~tlsf_allocator();
+
+    tlsf_allocator(const tlsf_allocator&) = delete;
+    tlsf_allocator& operator=(const tlsf_allocator&) = delete;
+
+    [[nodiscard]] constexpr std::size_t get_alignment() const;
+
+    // payload size of the block serving size, its header excluded
+    [[nodiscard]] constexpr std::size_t granted_size(std::size_t size) const;
+
+    [[nodiscard]] constexpr const allocator& get_allocator() const;
+    [[nodiscard]] constexpr allocator& get_allocator();
+
+    // payload bytes of the free blocks, block headers excluded
+    [[nodiscard]] constexpr std::size_t get_free_size() const;
+    [[nodiscard]] constexpr std::size_t get_free_block_count() const;
+
+    template<typename Initializer>
+    constexpr void init(Initializer& initializer);
+
+    [[nodiscard]] memory_block allocate(std::size_t size);
+    [[nodiscard]] bool owns(const memory_block& block) const;
+    bool expand(memory_block& block, std::size_t delta);
+    bool reallocate(memory_block& block, std::size_t new_size);
+    void deallocate(memory_block& block);
+    void deallocate_all();
+
+private:
+    struct bin_index
+    {
+        std::size_t first;
+        std::size_t second;
+    };
+
+    static constexpr std::size_t adjust_size(std::size_t size);
+
+    // bin holding blocks of exactly size
+    static constexpr bin_index mapping_insert(std::size_t size);
+
+    // first bin whose blocks are all at least size, first is past the last bin when none is
+    static constexpr bin_index mapping_search(std::size_t size);
+
+    static std::uint8_t* payload_of(block_header* block);
+    static block_header* header_of(const memory_block& block);
+    static block_header* next_physical(block_header* block);
+    static free_links& links_of(block_header* block);
+
+    [[nodiscard]] block_header* find_free_block(bin_index index) const;
+
+    void insert_free(block_header* block);
+    void remove_free(block_header* block);
+
+    // cuts block down to size, the remainder becomes a free block merged with the following one when free
+    void trim(block_header* block, std::size_t size);
+
+    // merges block with the following block, which must be free and out of its bin
+    void absorb_next(block_header* block);
+
+    bool acquire_pool();
+
+    std::uint64_t _first_level_map{0};
+    std::array<std::uint32_t, first_level_count> _second_level_maps{};
+    std::array<std::array<block_header*, second_level_count>, first_level_count> _bins{};
+    std::size_t _free_size{0};
+    std::size_t _free_block_count{0};
+    std::uint8_t* _begin{nullptr};
+    std::uint8_t* _end{nullptr};
+    memory_block _pool{nullblk};
+    allocator _allocator;
+};
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::~tlsf_allocator()
+{
+    // the blocks still allocated go back with the pool
+    if (_pool)
+    {
+        _allocator.deallocate(_pool);
+    }
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr std::size_t tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::get_alignment() const
+{
+    return alignment;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr std::size_t tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::granted_size(std::size_t size) const
+{
+    return adjust_size(size);
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr const tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::allocator& tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::allocator& tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::get_allocator()
+{
+    return _allocator;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr std::size_t tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::get_free_size() const
+{
+    return _free_size;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr std::size_t tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::get_free_block_count() const
+{
+    return _free_block_count;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+template<typename Initializer>
+constexpr void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::init(Initializer& initializer)
+{
+    _allocator.init(initializer);
+
+    initializer.init(*this);
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+memory_block tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::allocate(std::size_t size)
+{
+    if (size == 0 || size > max_size)
+    {
+        return nullblk;
+    }
+
+    if (!_pool && !acquire_pool())
+    {
+        return nullblk;
+    }
+
+    const std::size_t adjusted_size = adjust_size(size);
+    block_header* block = find_free_block(mapping_search(adjusted_size));
+
+    if (!block)
+    {
+        // the bin of the size itself may still start with a large enough block, the last one the pool has
+        const bin_index index = mapping_insert(adjusted_size);
+        block = _bins[index.first][index.second];
+
+        if (!block || block->get_size() < adjusted_size)
+        {
+            return nullblk;
+        }
+    }
+
+    remove_free(block);
+    block->size_and_flags = block->get_size();
+
+    trim(block, adjusted_size);
+
+    const memory_block result{payload_of(block), size};
+
+    COAL_USDT_ALLOCATOR_PROBE(allocate, size, result.ptr);
+
+    return result;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+bool tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::owns(const memory_block& block) const
+{
+    return block && _pool && block.as<std::uint8_t>() >= _begin && block.as<std::uint8_t>() < _end;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+bool tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::expand(memory_block& block, std::size_t delta)
+{
+    COAL_USDT_EXPAND_SCOPE(block, delta);
+
+    if (delta == 0)
+    {
+        return true;
+    }
+
+    if (!block)
+    {
+        block = allocate(delta);
+        return block;
+    }
+
+    const std::size_t new_size = block.size + delta;
+
+    if (new_size > max_size)
+    {
+        return false;
+    }
+
+    block_header* header = header_of(block);
+    const std::size_t adjusted_size = adjust_size(new_size);
+
+    if (adjusted_size > header->get_size())
+    {
+        block_header* next = next_physical(header);
+
+        if (!next->is_free() || header->get_size() + header_size + next->get_size() < adjusted_size)
+        {
+            return false;
+        }
+
+        remove_free(next);
+        absorb_next(header);
+        trim(header, adjusted_size);
+    }
+
+    block.size = new_size;
+    return true;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+bool tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::reallocate(memory_block& block, std::size_t new_size)
+{
+    COAL_USDT_REALLOCATE_SCOPE(block, new_size);
+
+    if (auto [success, reallocated] = details::try_default_reallocate(*this, block, new_size); success)
+    {
+        return reallocated;
+    }
+
+    if (new_size > max_size)
+    {
+        return false;
+    }
+
+    if (new_size < block.size)
+    {
+        // shrinks in place, the tail goes back to the bins
+        trim(header_of(block), adjust_size(new_size));
+
+        block.size = new_size;
+        return true;
+    }
+
+    if (expand(block, new_size - block.size))
+    {
+        return true;
+    }
+
+    if (memory_block new_block = allocate(new_size))
+    {
+        std::memcpy(new_block.ptr, block.ptr, block.size);
+        deallocate(block);
+        block = new_block;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::deallocate(memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    COAL_USDT_ALLOCATOR_PROBE(deallocate, block.size, block.ptr);
+
+    assert(owns(block));
+
+    block_header* header = header_of(block);
+
+    if (block_header* previous = header->previous_physical; previous && previous->is_free())
+    {
+        remove_free(previous);
+        absorb_next(previous);
+        header = previous;
+    }
+
+    if (block_header* next = next_physical(header); next->is_free())
+    {
+        remove_free(next);
+        absorb_next(header);
+    }
+
+    insert_free(header);
+
+    block = nullblk;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::deallocate_all()
+{
+    if (!_pool)
+    {
+        return;
+    }
+
+    _first_level_map = 0;
+    _second_level_maps.fill(0);
+
+    for (auto& bins : _bins)
+    {
+        bins.fill(nullptr);
+    }
+
+    _free_size = 0;
+    _free_block_count = 0;
+
+    // one free block spanning the pool, then a used sentinel of size zero so every block has a next one
+    block_header* block = reinterpret_cast<block_header*>(_begin);
+    block->previous_physical = nullptr;
+    block->size_and_flags = static_cast<std::size_t>(_end - _begin) - 2 * header_size;
+
+    block_header* sentinel = next_physical(block);
+    sentinel->previous_physical = block;
+    sentinel->size_and_flags = 0;
+
+    insert_free(block);
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr std::size_t tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::adjust_size(std::size_t size)
+{
+    const std::size_t aligned_size = align_up(size, alignment);
+    return aligned_size < min_block_size ? min_block_size : aligned_size;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::bin_index tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::mapping_insert(std::size_t size)
+{
+    if (size < small_block_size)
+    {
+        return {0, size / (small_block_size / second_level_count)};
+    }
+
+    const std::size_t last_bit = static_cast<std::size_t>(std::bit_width(size)) - 1;
+
+    // the bits below the leading one select the linear subdivision
+    return {last_bit - first_level_shift + 1, (size >> (last_bit - SecondLevelLog2T)) ^ second_level_count};
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+constexpr tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::bin_index tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::mapping_search(std::size_t size)
+{
+    if (size >= small_block_size)
+    {
+        // rounds up to the next bin boundary, so any block of the bin found is large enough
+        size += (std::size_t{1} << (static_cast<std::size_t>(std::bit_width(size)) - 1 - SecondLevelLog2T)) - 1;
+    }
+
+    return mapping_insert(size);
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+std::uint8_t* tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::payload_of(block_header* block)
+{
+    return reinterpret_cast<std::uint8_t*>(block) + header_size;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::block_header* tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::header_of(const memory_block& block)
+{
+    return reinterpret_cast<block_header*>(block.as<std::uint8_t>() - header_size);
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::block_header* tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::next_physical(block_header* block)
+{
+    return reinterpret_cast<block_header*>(payload_of(block) + block->get_size());
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::free_links& tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::links_of(block_header* block)
+{
+    return *reinterpret_cast<free_links*>(payload_of(block));
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::block_header* tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::find_free_block(bin_index index) const
+{
+    if (index.first >= first_level_count)
+    {
+        return nullptr;
+    }
+
+    std::uint32_t second_level_map = _second_level_maps[index.first] & (~std::uint32_t{0} << index.second);
+
+    if (second_level_map == 0)
+    {
+        // no bin left in this first level, take the smallest non-empty one above
+        const std::uint64_t first_level_map = index.first + 1 < 64 ? _first_level_map & (~std::uint64_t{0} << (index.first + 1)) : 0;
+
+        if (first_level_map == 0)
+        {
+            return nullptr;
+        }
+
+        index.first = static_cast<std::size_t>(std::countr_zero(first_level_map));
+        second_level_map = _second_level_maps[index.first];
+    }
+
+    index.second = static_cast<std::size_t>(std::countr_zero(second_level_map));
+
+    return _bins[index.first][index.second];
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::insert_free(block_header* block)
+{
+    const bin_index index = mapping_insert(block->get_size());
+    block_header*& head = _bins[index.first][index.second];
+
+    links_of(block) = {nullptr, head};
+
+    if (head)
+    {
+        links_of(head).previous = block;
+    }
+
+    head = block;
+    block->size_and_flags |= block_header::free_bit;
+
+    _first_level_map |= std::uint64_t{1} << index.first;
+    _second_level_maps[index.first] |= std::uint32_t{1} << index.second;
+
+    _free_size += block->get_size();
+    ++_free_block_count;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::remove_free(block_header* block)
+{
+    assert(block->is_free());
+
+    const bin_index index = mapping_insert(block->get_size());
+    block_header*& head = _bins[index.first][index.second];
+    const free_links links = links_of(block);
+
+    (links.previous ? links_of(links.previous).next : head) = links.next;
+
+    if (links.next)
+    {
+        links_of(links.next).previous = links.previous;
+    }
+
+    if (!head)
+    {
+        _second_level_maps[index.first] &= ~(std::uint32_t{1} << index.second);
+
+        if (_second_level_maps[index.first] == 0)
+        {
+            _first_level_map &= ~(std::uint64_t{1} << index.first);
+        }
+    }
+
+    // the caller decides whether the block stays free, merged into another or is handed out
+    _free_size -= block->get_size();
+    --_free_block_count;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::trim(block_header* block, std::size_t size)
+{
+    const std::size_t block_size = block->get_size();
+
+    if (block_size < size + header_size + min_block_size)
+    {
+        return;
+    }
+
+    block->size_and_flags = size;
+
+    block_header* remainder = next_physical(block);
+    remainder->previous_physical = block;
+    remainder->size_and_flags = block_size - size - header_size;
+
+    block_header* next = next_physical(remainder);
+    next->previous_physical = remainder;
+
+    if (next->is_free())
+    {
+        remove_free(next);
+        absorb_next(remainder);
+    }
+
+    insert_free(remainder);
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+void tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::absorb_next(block_header* block)
+{
+    block_header* next = next_physical(block);
+
+    // the merged block is in no bin, it is flagged free again once inserted
+    block->size_and_flags = block->get_size() + header_size + next->get_size();
+
+    next_physical(block)->previous_physical = block;
+}
+
+template<typename AllocatorT, std::size_t PoolSizeT, std::size_t SecondLevelLog2T>
+bool tlsf_allocator<AllocatorT, PoolSizeT, SecondLevelLog2T>::acquire_pool()
+{
+    _pool = _allocator.allocate(PoolSizeT);
+
+    if (!_pool)
+    {
+        return false;
+    }
+
+    // the parent may align less than the payloads need
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(_pool.ptr);
+    _begin = _pool.as<std::uint8_t>() + (align_up(address, alignment) - address);
+    _end = _begin + align_down(static_cast<std::size_t>(_pool.as<std::uint8_t>() + PoolSizeT - _begin), alignment);
+
+    deallocate_all();
+    return true;
+}
+
+} // namespace coal
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace coal {
+
+enum class trace_event_type : std::uint8_t
+{
+    allocate,
+    deallocate,
+    reallocate,
+    expand,
+    deallocate_all
+};
+
+// object ids are recycled by the recorder so they stay dense, a replayer can index its live blocks with them
+struct trace_event
+{
+    trace_event_type type{trace_event_type::allocate};
+    bool success{true};
+    std::uint64_t object_id{0};
+    std::uint64_t size{0};
+
+    // new size of a reallocate or delta of an expand
+    std::uint64_t argument{0};
+};
+
+// binary layout: a header, then for each event a tag byte (type | success << 7) followed by LEB128 encoded
+// object id, size and, for reallocate and expand, argument
+namespace trace_format {
+
+inline static constexpr std::array<char, 8> magic{'C', 'O', 'A', 'L', 'T', 'R', 'C', '\0'};
+inline static constexpr std::uint32_t version = 1;
+
+inline static constexpr std::size_t max_varint_size = 10;
+inline static constexpr std::size_t max_event_size = 1 + 3 * max_varint_size;
+
+inline static constexpr std::uint8_t success_flag = 0x80;
+
+constexpr bool has_argument(trace_event_type type)
+{
+    return type == trace_event_type::reallocate || type == trace_event_type::expand;
+}
+
+constexpr std::size_t encode_varint(std::uint64_t value, std::uint8_t* buffer)
+{
+    std::size_t size = 0;
+
+    while (value >= 0x80)
+    {
+        buffer[size++] = static_cast<std::uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+
+    buffer[size++] = static_cast<std::uint8_t>(value);
+    return size;
+}
+
+constexpr std::size_t encode(const trace_event& event, std::uint8_t* buffer)
+{
+    std::size_t size = 0;
+
+    buffer[size++] = static_cast<std::uint8_t>(static_cast<std::uint8_t>(event.type) | (event.success ? success_flag : 0));
+    size += encode_varint(event.object_id, buffer + size);
+    size += encode_varint(event.size, buffer + size);
+
+    if (has_argument(event.type))
+    {
+        size += encode_varint(event.argument, buffer + size);
+    }
+
+    return size;
+}
+
+inline bool write_header(std::FILE* file)
+{
+    return std::fwrite(magic.data(), magic.size(), 1, file) == 1 && std::fwrite(&version, sizeof(version), 1, file) == 1;
+}
+
+inline bool read_header(std::FILE* file)
+{
+    std::array<char, magic.size()> file_magic{};
+    std::uint32_t file_version{0};
+
+    return std::fread(file_magic.data(), file_magic.size(), 1, file) == 1
+           && std::fread(&file_version, sizeof(file_version), 1, file) == 1
+           && file_magic == magic
+           && file_version == version;
+}
+
+inline bool read_varint(std::FILE* file, std::uint64_t& value)
+{
+    value = 0;
+
+    for (std::size_t shift = 0; shift < 64; shift += 7)
+    {
+        const int c = std::fgetc(file);
+
+        if (c == EOF)
+        {
+            return false;
+        }
+
+        value |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+
+        if ((c & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline bool read(std::FILE* file, trace_event& event)
+{
+    const int tag = std::fgetc(file);
+
+    if (tag == EOF)
+    {
+        return false;
+    }
+
+    const std::uint8_t type = static_cast<std::uint8_t>(tag) & ~success_flag;
+
+    if (type > static_cast<std::uint8_t>(trace_event_type::deallocate_all))
+    {
+        return false;
+    }
+
+    event.type = static_cast<trace_event_type>(type);
+    event.success = (tag & success_flag) != 0;
+    event.argument = 0;
+
+    if (!read_varint(file, event.object_id) || !read_varint(file, event.size))
+    {
+        return false;
+    }
+
+    return !has_argument(event.type) || read_varint(file, event.argument);
+}
+
+} // namespace trace_format
+
+} // namespace coal
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include <coal/memory_block.hpp>
+#include <coal/trace/trace_event.hpp>
+
+namespace coal {
+
+// Writes allocation events to a binary trace, see trace_event.hpp for the layout.
+// The recorder maps live pointers to object ids with the global heap, it must not be fed by the allocator behind operator new.
+class trace_recorder
+{
+public:
+    // the file is not owned and must outlive the recorder
+    explicit trace_recorder(std::FILE* file);
+    ~trace_recorder();
+
+    trace_recorder(const trace_recorder&) = delete;
+    trace_recorder& operator=(const trace_recorder&) = delete;
+
+    [[nodiscard]] bool is_valid() const;
+    [[nodiscard]] std::uint64_t get_event_count() const;
+    [[nodiscard]] std::size_t get_live_count() const;
+
+    void record_allocate(const memory_block& block, std::size_t size);
+    void record_deallocate(const memory_block& block);
+    void record_reallocate(const memory_block& old_block, const memory_block& new_block, std::size_t new_size, bool success);
+    void record_expand(const memory_block& old_block, const memory_block& new_block, std::size_t delta, bool success);
+    void record_deallocate_all();
+
+    void flush();
+
+private:
+    void record_resize(trace_event_type type, const memory_block& old_block, const memory_block& new_block, std::uint64_t argument, bool success);
+
+    [[nodiscard]] std::uint64_t acquire_id();
+    void release_id(std::uint64_t id);
+
+    void write(const trace_event& event);
+    void write_buffer();
+
+    std::FILE* _file{nullptr};
+    std::unordered_map<const void*, std::uint64_t> _ids;
+    std::vector<std::uint64_t> _free_ids;
+    std::uint64_t _next_id{0};
+    std::uint64_t _event_count{0};
+    bool _valid{false};
+
+    std::array<std::uint8_t, 4096> _buffer{};
+    std::size_t _buffer_size{0};
+};
+
+inline trace_recorder::trace_recorder(std::FILE* file)
+    : _file{file}
+    , _valid{file != nullptr && trace_format::write_header(file)}
+{
+}
+
+inline trace_recorder::~trace_recorder()
+{
+    flush();
+}
+
+inline bool trace_recorder::is_valid() const
+{
+    return _valid;
+}
+
+inline std::uint64_t trace_recorder::get_event_count() const
+{
+    return _event_count;
+}
+
+inline std::size_t trace_recorder::get_live_count() const
+{
+    return _ids.size();
+}
+
+inline void trace_recorder::record_allocate(const memory_block& block, std::size_t size)
+{
+    trace_event event{trace_event_type::allocate, static_cast<bool>(block), 0, size, 0};
+
+    if (block)
+    {
+        event.object_id = acquire_id();
+        _ids[block.ptr] = event.object_id;
+    }
+
+    write(event);
+}
+
+inline void trace_recorder::record_deallocate(const memory_block& block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    auto it = _ids.find(block.ptr);
+
+    if (it == _ids.end())
+    {
+        // allocated before the recorder was attached
+        return;
+    }
+
+    write(trace_event{trace_event_type::deallocate, true, it->second, block.size, 0});
+
+    release_id(it->second);
+    _ids.erase(it);
+}
+
+inline void trace_recorder::record_reallocate(const memory_block& old_block, const memory_block& new_block, std::size_t new_size, bool success)
+{
+    record_resize(trace_event_type::reallocate, old_block, new_block, new_size, success);
+}
+
+inline void trace_recorder::record_expand(const memory_block& old_block, const memory_block& new_block, std::size_t delta, bool success)
+{
+    record_resize(trace_event_type::expand, old_block, new_block, delta, success);
+}
+
+inline void trace_recorder::record_deallocate_all()
+{
+    write(trace_event{trace_event_type::deallocate_all, true, 0, 0, 0});
+
+    _ids.clear();
+    _free_ids.clear();
+    _next_id = 0;
+}
+
+inline void trace_recorder::flush()
+{
+    write_buffer();
+
+    if (_valid)
+    {
+        _valid = std::fflush(_file) == 0;
+    }
+}
+
+inline void trace_recorder::record_resize(trace_event_type type, const memory_block& old_block, const memory_block& new_block, std::uint64_t argument, bool success)
+{
+    trace_event event{type, success, 0, old_block.size, argument};
+
+    if (old_block)
+    {
+        auto it = _ids.find(old_block.ptr);
+
+        if (it == _ids.end())
+        {
+            return;
+        }
+
+        event.object_id = it->second;
+        write(event);
+
+        if (!success || old_block.ptr == new_block.ptr)
+        {
+            return;
+        }
+
+        _ids.erase(it);
+
+        if (new_block)
+        {
+            _ids[new_block.ptr] = event.object_id;
+        }
+        else
+        {
+            release_id(event.object_id);
+        }
+
+        return;
+    }
+
+    // resizing a nullblk is an allocation
+    if (success && new_block)
+    {
+        event.object_id = acquire_id();
+        _ids[new_block.ptr] = event.object_id;
+    }
+
+    write(event);
+}
+
+inline std::uint64_t trace_recorder::acquire_id()
+{
+    if (_free_ids.empty())
+    {
+        return _next_id++;
+    }
+
+    const std::uint64_t id = _free_ids.back();
+    _free_ids.pop_back();
+    return id;
+}
+
+inline void trace_recorder::release_id(std::uint64_t id)
+{
+    _free_ids.push_back(id);
+}
+
+inline void trace_recorder::write(const trace_event& event)
+{
+    if (_buffer_size + trace_format::max_event_size > _buffer.size())
+    {
+        write_buffer();
+    }
+
+    _buffer_size += trace_format::encode(event, _buffer.data() + _buffer_size);
+    ++_event_count;
+}
+
+inline void trace_recorder::write_buffer()
+{
+    if (_valid && _buffer_size > 0)
+    {
+        _valid = std::fwrite(_buffer.data(), _buffer_size, 1, _file) == 1;
+    }
+
+    _buffer_size = 0;
+}
+
+} // namespace coal
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include <coal/allocator_traits.hpp>
+#include <coal/memory_block.hpp>
+#include <coal/trace/trace_event.hpp>
+
+namespace coal {
+
+// Reads every event of a trace written by trace_recorder.
+inline bool read_trace(std::FILE* file, std::vector<trace_event>& events)
+{
+    if (file == nullptr || !trace_format::read_header(file))
+    {
+        return false;
+    }
+
+    trace_event event;
+
+    while (trace_format::read(file, event))
+    {
+        events.push_back(event);
+    }
+
+    return std::feof(file) != 0;
+}
+
+struct replay_result
+{
+    [[nodiscard]] constexpr double get_events_per_second() const;
+
+    std::uint64_t events{0};
+
+    // operations that succeeded when recorded but failed on replay
+    std::uint64_t failures{0};
+
+    // expand or deallocate_all events the allocator does not support
+    std::uint64_t unsupported{0};
+
+    std::uint64_t elapsed_ns{0};
+
+    // bytes requested by the live objects of the trace
+    std::uint64_t live_bytes{0};
+    std::uint64_t peak_live_bytes{0};
+};
+
+constexpr double replay_result::get_events_per_second() const
+{
+    return elapsed_ns ? static_cast<double>(events) * 1e9 / static_cast<double>(elapsed_ns) : 0.0;
+}
+
+// Drives an allocator with recorded events. Objects still alive at the end of the trace are deallocated
+// outside of the timed section.
+template<typename AllocatorT>
+class trace_replayer
+{
+public:
+    using allocator = AllocatorT;
+
+    explicit trace_replayer(allocator& allocator);
+
+    replay_result replay(std::span<const trace_event> events);
+
+private:
+    void replay_event(const trace_event& event);
+
+    void replay_allocate(const trace_event& event);
+    void replay_deallocate(const trace_event& event);
+    void replay_resize(const trace_event& event);
+    void replay_deallocate_all();
+
+    memory_block& get_block(std::uint64_t object_id);
+    void set_live_bytes(std::uint64_t live_bytes);
+
+    void release_all();
+
+    allocator& _allocator;
+    std::vector<memory_block> _blocks;
+    replay_result _result;
+};
+
+template<typename AllocatorT>
+trace_replayer<AllocatorT>::trace_replayer(allocator& allocator)
+    : _allocator{allocator}
+{
+}
+
+template<typename AllocatorT>
+replay_result trace_replayer<AllocatorT>::replay(std::span<const trace_event> events)
+{
+    _result = {};
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const trace_event& event : events)
+    {
+        replay_event(event);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    _result.events = events.size();
+    _result.elapsed_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+    const replay_result result = _result;
+
+    release_all();
+
+    return result;
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::replay_event(const trace_event& event)
+{
+    switch (event.type)
+    {
+    case trace_event_type::allocate: replay_allocate(event); break;
+    case trace_event_type::deallocate: replay_deallocate(event); break;
+    case trace_event_type::reallocate: replay_resize(event); break;
+    case trace_event_type::expand: replay_resize(event); break;
+    case trace_event_type::deallocate_all: replay_deallocate_all(); break;
+    }
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::replay_allocate(const trace_event& event)
+{
+    memory_block block = _allocator.allocate(event.size);
+
+    if (!event.success)
+    {
+        // the recorded program did not get a block, do not keep it alive
+        _allocator.deallocate(block);
+        return;
+    }
+
+    if (!block)
+    {
+        ++_result.failures;
+        return;
+    }
+
+    get_block(event.object_id) = block;
+    set_live_bytes(_result.live_bytes + block.size);
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::replay_deallocate(const trace_event& event)
+{
+    memory_block& block = get_block(event.object_id);
+
+    if (!block)
+    {
+        return;
+    }
+
+    set_live_bytes(_result.live_bytes - block.size);
+
+    _allocator.deallocate(block);
+    block = nullblk;
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::replay_resize(const trace_event& event)
+{
+    // a failed resize of a nullblk did not allocate an object, replay it on a temporary block
+    memory_block temporary_block = nullblk;
+    memory_block& block = event.success || event.size != 0 ? get_block(event.object_id) : temporary_block;
+
+    const std::uint64_t old_size = block.size;
+    bool success = false;
+
+    if (event.type == trace_event_type::reallocate)
+    {
+        success = _allocator.reallocate(block, event.argument);
+    }
+    else if constexpr (allocator_traits::has_expand<AllocatorT>)
+    {
+        success = _allocator.expand(block, event.argument);
+    }
+    else
+    {
+        ++_result.unsupported;
+    }
+
+    if (&block == &temporary_block)
+    {
+        _allocator.deallocate(temporary_block);
+        return;
+    }
+
+    if (!success && event.success)
+    {
+        ++_result.failures;
+    }
+
+    set_live_bytes(_result.live_bytes - old_size + block.size);
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::replay_deallocate_all()
+{
+    if constexpr (allocator_traits::has_deallocate_all<AllocatorT>)
+    {
+        _allocator.deallocate_all();
+        _blocks.clear();
+        set_live_bytes(0);
+    }
+    else
+    {
+        ++_result.unsupported;
+        release_all();
+    }
+}
+
+template<typename AllocatorT>
+memory_block& trace_replayer<AllocatorT>::get_block(std::uint64_t object_id)
+{
+    if (object_id >= _blocks.size())
+    {
+        _blocks.resize(object_id + 1);
+    }
+
+    return _blocks[object_id];
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::set_live_bytes(std::uint64_t live_bytes)
+{
+    _result.live_bytes = live_bytes;
+
+    if (live_bytes > _result.peak_live_bytes)
+    {
+        _result.peak_live_bytes = live_bytes;
+    }
+}
+
+template<typename AllocatorT>
+void trace_replayer<AllocatorT>::release_all()
+{
+    for (memory_block& block : _blocks)
+    {
+        if (block)
+        {
+            _allocator.deallocate(block);
+            block = nullblk;
+        }
+    }
+
+    _blocks.clear();
+    _result.live_bytes = 0;
+}
+
+} // namespace coal
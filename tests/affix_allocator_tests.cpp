@@ -210,4 +210,19 @@ TEMPLATE_LIST_TEST_CASE_METHOD(affix_allocator_fixture, "stack_allocator expand
     this->deallocate_and_check_is_nullblk(block);
 }
 
+TEMPLATE_LIST_TEST_CASE_METHOD(affix_allocator_fixture, "affix_allocator rewind forwards to the allocator", "[affix_allocator], [allocator]", affix_allocator_types)
+{
+    const typename TestType::marker marker = this->allocator.mark();
+
+    memory_block first = this->allocator.allocate(4);
+    [[maybe_unused]] memory_block second = this->allocator.allocate(4);
+
+    this->allocator.rewind(marker);
+
+    memory_block block = this->allocator.allocate(4);
+
+    CHECK(block.ptr == first.ptr);
+    this->check_affixes(block);
+}
+
 } // namespace coal
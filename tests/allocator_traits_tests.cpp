@@ -20,15 +20,28 @@ public:
     constexpr void deallocate_all() {}
 };
 
+class markable_allocator
+{
+public:
+    struct marker
+    {};
+
+    [[nodiscard]] constexpr marker mark() const { return {}; }
+    constexpr void rewind(const marker&) {}
+};
+
 TEST_CASE("allocator_traits", "[allocator_traits]")
 {
     STATIC_CHECK(has_owns<non_empty_allocator>);
     STATIC_CHECK(has_expand<non_empty_allocator>);
     STATIC_CHECK(has_deallocate_all<non_empty_allocator>);
+    STATIC_CHECK(has_mark<markable_allocator>);
 
     STATIC_CHECK_FALSE(has_owns<empty_allocator>);
     STATIC_CHECK_FALSE(has_expand<empty_allocator>);
     STATIC_CHECK_FALSE(has_deallocate_all<empty_allocator>);
+    STATIC_CHECK_FALSE(has_mark<empty_allocator>);
+    STATIC_CHECK_FALSE(has_mark<non_empty_allocator>);
 }
 
 } // namespace coal::allocator_traits
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/bitmapped_block.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+#include <allocator_mock.hpp>
+
+namespace coal {
+
+using bitmapped_block_basic_allocators = std::tuple<
+    bitmapped_block<stack_allocator<0x10000, 8>, 8, 0x1000>,
+    bitmapped_block<stack_allocator<0x10000, 16>, 32, 0x400>,
+    bitmapped_block<malloc_allocator, 64, 100>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "bitmapped_block basics", "[bitmapped_block], [allocator]", bitmapped_block_basic_allocators)
+{
+    this->test_basics();
+}
+
+using mock_bitmapped_block = bitmapped_block<mock::minimal_allocator, 64, 16>;
+
+struct bitmapped_block_fixture : allocator_fixture<mock_bitmapped_block>
+{
+    struct mock_initializer
+    {
+        void init([[maybe_unused]] mock_bitmapped_block& root)
+        {
+            ++init_count;
+        }
+
+        void init([[maybe_unused]] mock::minimal_allocator& a)
+        {
+            CHECK(init_count == 0);
+        }
+
+        std::size_t init_count{0};
+    };
+
+    bitmapped_block_fixture()
+    {
+        mock::minimal_allocator::reset_mock();
+    }
+};
+
+TEST_CASE_METHOD(bitmapped_block_fixture, "bitmapped_block init", "[bitmapped_block], [allocator]")
+{
+    mock_initializer initializer;
+    allocator.init(initializer);
+
+    CHECK(initializer.init_count == 1);
+    CHECK(mock::minimal_allocator::init_count == 1);
+}
+
+TEST_CASE_METHOD(bitmapped_block_fixture, "bitmapped_block takes a single block from the parent", "[bitmapped_block], [allocator]")
+{
+    alignas(64) static std::uint8_t region[64 * 16];
+    mock::minimal_allocator::allocate_block = {region, sizeof(region)};
+
+    memory_block block1 = allocator.allocate(64);
+    memory_block block2 = allocator.allocate(1);
+
+    CHECK(block1.ptr == region);
+    CHECK(block2.ptr == region + 64);
+    CHECK(mock::minimal_allocator::allocate_count == 1);
+
+    deallocate_and_check_is_nullblk(block1);
+    deallocate_and_check_is_nullblk(block2);
+}
+
+TEST_CASE_METHOD(bitmapped_block_fixture, "bitmapped_block allocate nullblk when the parent is out of memory", "[bitmapped_block], [allocator]")
+{
+    mock::minimal_allocator::will_allocate = false;
+
+    CHECK(allocator.allocate(64) == nullblk);
+    CHECK(allocator.get_free_block_count() == 16);
+}
+
+TEST_CASE("bitmapped_block allocate contiguous blocks", "[bitmapped_block], [allocator]")
+{
+    bitmapped_block<stack_allocator<0x1000>, 16, 256> allocator;
+
+    memory_block block1 = allocator.allocate(16);
+    memory_block block2 = allocator.allocate(40);
+    memory_block block3 = allocator.allocate(16);
+
+    REQUIRE(block1);
+    REQUIRE(block2);
+    REQUIRE(block3);
+
+    CHECK(block2.as<std::uint8_t>() == block1.as<std::uint8_t>() + 16);
+    CHECK(block3.as<std::uint8_t>() == block2.as<std::uint8_t>() + 48);
+    CHECK(block2.size == 40);
+    CHECK(allocator.get_free_block_count() == 256 - 5);
+
+    SECTION("a freed run is reused")
+    {
+        void* ptr = block2.ptr;
+        allocator.deallocate(block2);
+
+        memory_block block = allocator.allocate(17);
+        CHECK(block.ptr == ptr);
+
+        block = allocator.allocate(48);
+        CHECK(block.as<std::uint8_t>() == block3.as<std::uint8_t>() + 16);
+    }
+
+    SECTION("a run too large for the hole goes after")
+    {
+        allocator.deallocate(block2);
+
+        memory_block block = allocator.allocate(64);
+        CHECK(block.as<std::uint8_t>() == block3.as<std::uint8_t>() + 16);
+    }
+}
+
+TEST_CASE("bitmapped_block allocate every block", "[bitmapped_block], [allocator]")
+{
+    bitmapped_block<stack_allocator<0x1000 * 16>, 16, 1000> allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        blocks.push_back(allocator.allocate(16));
+        REQUIRE(blocks.back());
+        CHECK(allocator.owns(blocks.back()));
+    }
+
+    CHECK(allocator.get_free_block_count() == 0);
+    CHECK(allocator.allocate(1) == nullblk);
+
+    void* ptr300 = blocks[300].ptr;
+    void* ptr700 = blocks[700].ptr;
+
+    allocator.deallocate(blocks[700]);
+    allocator.deallocate(blocks[300]);
+
+    CHECK(allocator.allocate(32) == nullblk);
+    CHECK(allocator.allocate(16).ptr == ptr300);
+    CHECK(allocator.allocate(16).ptr == ptr700);
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.get_free_block_count() == 1000);
+    CHECK(allocator.allocate(16000).ptr == blocks[0].ptr);
+}
+
+TEST_CASE("bitmapped_block allocate nullblk with unsupported size", "[bitmapped_block], [allocator]")
+{
+    bitmapped_block<stack_allocator<0x1000>, 16, 64> allocator;
+
+    CHECK(allocator.allocate(0) == nullblk);
+    CHECK(allocator.allocate(16 * 64 + 1) == nullblk);
+}
+
+TEST_CASE("bitmapped_block owns", "[bitmapped_block], [allocator]")
+{
+    bitmapped_block<stack_allocator<0x1000>, 16, 64> allocator;
+    std::uint8_t other[16];
+
+    CHECK_FALSE(allocator.owns({other, sizeof(other)}));
+
+    memory_block block = allocator.allocate(16);
+
+    CHECK(allocator.owns(block));
+    CHECK_FALSE(allocator.owns({other, sizeof(other)}));
+    CHECK_FALSE(allocator.owns({block.as<std::uint8_t>() + 16 * 64, 16}));
+}
+
+TEST_CASE("bitmapped_block expand and reallocate in place", "[bitmapped_block], [allocator]")
+{
+    bitmapped_block<stack_allocator<0x1000>, 16, 64> allocator;
+
+    memory_block block = allocator.allocate(16);
+    void* ptr = block.ptr;
+
+    CHECK(allocator.expand(block, 20));
+    CHECK(block.ptr == ptr);
+    CHECK(block.size == 36);
+    CHECK(allocator.get_free_block_count() == 61);
+
+    memory_block next = allocator.allocate(16);
+
+    CHECK_FALSE(allocator.expand(block, 16));
+    CHECK(block.size == 36);
+
+    CHECK(allocator.reallocate(block, 8));
+    CHECK(block.ptr == ptr);
+    CHECK(allocator.get_free_block_count() == 62);
+
+    CHECK(allocator.reallocate(block, 48));
+    CHECK(block.ptr == ptr);
+
+    CHECK(allocator.reallocate(block, 64));
+    CHECK(block.ptr == next.as<std::uint8_t>() + 16);
+    CHECK(allocator.get_free_block_count() == 64 - 5);
+}
+
+} // namespace coal
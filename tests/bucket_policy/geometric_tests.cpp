@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/bucket_policy/geometric.hpp>
+
+namespace coal::bucket_policy {
+
+TEST_CASE("geometric buckets", "[geometric], [bucket_policy]")
+{
+    using policy = geometric<16, 256, 4>;
+
+    STATIC_CHECK(policy::bucket_count == 17);
+    STATIC_CHECK(policy::size_at_index(0) == 16);
+    STATIC_CHECK(policy::size_at_index(1) == 20);
+    STATIC_CHECK(policy::size_at_index(4) == 32);
+    STATIC_CHECK(policy::size_at_index(5) == 40);
+    STATIC_CHECK(policy::size_at_index(16) == 256);
+
+    STATIC_CHECK(policy::index_for_size(16) == 0);
+    STATIC_CHECK(policy::index_for_size(17) == 1);
+    STATIC_CHECK(policy::index_for_size(20) == 1);
+    STATIC_CHECK(policy::index_for_size(21) == 2);
+    STATIC_CHECK(policy::index_for_size(33) == 5);
+    STATIC_CHECK(policy::index_for_size(256) == 16);
+
+    STATIC_CHECK(geometric<8, 8, 1>::bucket_count == 1);
+    STATIC_CHECK(geometric<8, 64, 1>::size_at_index(3) == 64);
+}
+
+TEST_CASE("geometric index_for_size picks the smallest bucket holding the size", "[geometric], [bucket_policy]")
+{
+    using policy = geometric<16, 0x10000, 8>;
+
+    for (std::size_t size = 1; size <= policy::max_size; ++size)
+    {
+        const std::size_t index = policy::index_for_size(size);
+
+        if (index >= policy::bucket_count || policy::size_at_index(index) < size || (index > 0 && policy::size_at_index(index - 1) >= size))
+        {
+            FAIL("size " << size << " index " << index);
+        }
+    }
+
+    SUCCEED();
+}
+
+} // namespace coal::bucket_policy
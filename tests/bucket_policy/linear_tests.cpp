@@ -0,0 +1,40 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/bucket_policy/linear.hpp>
+
+namespace coal::bucket_policy {
+
+TEST_CASE("linear buckets", "[linear], [bucket_policy]")
+{
+    using policy = linear<16, 128, 16>;
+
+    STATIC_CHECK(policy::bucket_count == 8);
+    STATIC_CHECK(policy::size_at_index(0) == 16);
+    STATIC_CHECK(policy::size_at_index(7) == 128);
+
+    STATIC_CHECK(policy::index_for_size(1) == 0);
+    STATIC_CHECK(policy::index_for_size(16) == 0);
+    STATIC_CHECK(policy::index_for_size(17) == 1);
+    STATIC_CHECK(policy::index_for_size(32) == 1);
+    STATIC_CHECK(policy::index_for_size(128) == 7);
+
+    STATIC_CHECK(linear<64, 64, 8>::bucket_count == 1);
+}
+
+TEST_CASE("linear index_for_size picks the smallest bucket holding the size", "[linear], [bucket_policy]")
+{
+    using policy = linear<24, 1024, 8>;
+
+    for (std::size_t size = 1; size <= policy::max_size; ++size)
+    {
+        INFO("size " << size);
+
+        const std::size_t index = policy::index_for_size(size);
+
+        REQUIRE(index < policy::bucket_count);
+        CHECK(policy::size_at_index(index) >= size);
+        CHECK((index == 0 || policy::size_at_index(index - 1) < size));
+    }
+}
+
+} // namespace coal::bucket_policy
@@ -0,0 +1,159 @@
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/bucket_policy/geometric.hpp>
+#include <coal/bucket_policy/linear.hpp>
+#include <coal/bucketizer.hpp>
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+#include <allocator_mock.hpp>
+
+namespace coal {
+
+using bucketizer_basic_allocators = std::tuple<
+    bucketizer<free_list_allocator<stack_allocator<0x1000, 8>, free_list_strategy::first_fit>, bucket_policy::linear<16, 512, 16>>,
+    bucketizer<free_list_allocator<stack_allocator<0x1000, 16>, free_list_strategy::first_fit>, bucket_policy::geometric<64, 1024, 4>>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "bucketizer basics", "[bucketizer], [allocator]", bucketizer_basic_allocators)
+{
+    this->large_expand = false;
+
+    this->test_basics();
+}
+
+struct bucket_tag
+{};
+
+using mock_bucket = mock::basic_allocator<bucket_tag>;
+using mock_bucketizer = bucketizer<mock_bucket, bucket_policy::linear<16, 64, 16>>;
+
+struct bucketizer_fixture : allocator_fixture<mock_bucketizer>
+{
+    struct mock_initializer
+    {
+        void init([[maybe_unused]] mock_bucketizer& root)
+        {
+            ++init_count;
+        }
+
+        void init([[maybe_unused]] mock_bucket& a)
+        {
+            CHECK(init_count == 0);
+        }
+
+        std::size_t init_count{0};
+    };
+
+    bucketizer_fixture()
+    {
+        mock_bucket::reset_mock();
+    }
+};
+
+TEST_CASE_METHOD(bucketizer_fixture, "bucketizer init", "[bucketizer], [allocator]")
+{
+    mock_initializer initializer;
+    allocator.init(initializer);
+
+    CHECK(initializer.init_count == 1);
+    CHECK(mock_bucket::init_count == mock_bucketizer::bucket_count);
+}
+
+TEST_CASE_METHOD(bucketizer_fixture, "bucketizer owns", "[bucketizer], [allocator]")
+{
+    std::uint8_t data[64];
+
+    mock_bucket::will_owns = true;
+
+    CHECK(allocator.owns({data, 24}));
+    CHECK(mock_bucket::owns_count == 1);
+
+    CHECK_FALSE(allocator.owns({data, 65}));
+    CHECK_FALSE(allocator.owns(nullblk));
+    CHECK(mock_bucket::owns_count == 1);
+}
+
+TEST_CASE_METHOD(bucketizer_fixture, "bucketizer deallocate_all", "[bucketizer], [allocator]")
+{
+    allocator.deallocate_all();
+
+    CHECK(mock_bucket::deallocate_all_count == mock_bucketizer::bucket_count);
+}
+
+TEST_CASE("bucketizer reuses blocks within a bucket", "[bucketizer], [allocator]")
+{
+    bucketizer<free_list_allocator<stack_allocator<0x4000>, free_list_strategy::first_fit>, bucket_policy::geometric<32, 4096, 4>> allocator;
+
+    memory_block block = allocator.allocate(100);
+    REQUIRE(block);
+    CHECK(block.size == 100);
+
+    void* ptr = block.ptr;
+    allocator.deallocate(block);
+    CHECK(block == nullblk);
+
+    // 100 and 112 share the bucket of 112
+    block = allocator.allocate(112);
+    CHECK(block.ptr == ptr);
+    CHECK(block.size == 112);
+
+    memory_block other = allocator.allocate(113);
+    CHECK(other.ptr != ptr);
+
+    allocator.deallocate(block);
+    allocator.deallocate(other);
+}
+
+TEST_CASE("bucketizer expand and reallocate", "[bucketizer], [allocator]")
+{
+    bucketizer<free_list_allocator<stack_allocator<0x1000>, free_list_strategy::first_fit>, bucket_policy::linear<32, 256, 32>> allocator;
+
+    memory_block block = allocator.allocate(40);
+    void* ptr = block.ptr;
+
+    SECTION("expand within the bucket")
+    {
+        CHECK(allocator.expand(block, 24));
+        CHECK(block.size == 64);
+        CHECK(block.ptr == ptr);
+
+        CHECK_FALSE(allocator.expand(block, 1));
+        CHECK(block.size == 64);
+    }
+
+    SECTION("reallocate within the bucket")
+    {
+        CHECK(allocator.reallocate(block, 33));
+        CHECK(block.ptr == ptr);
+        CHECK(block.size == 33);
+    }
+
+    SECTION("reallocate to another bucket")
+    {
+        block.as<std::uint8_t>()[0] = 42;
+
+        CHECK(allocator.reallocate(block, 200));
+        CHECK(block.ptr != ptr);
+        CHECK(block.size == 200);
+        CHECK(block.as<std::uint8_t>()[0] == 42);
+
+        CHECK_FALSE(allocator.reallocate(block, 257));
+        CHECK(block.size == 200);
+    }
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("bucketizer allocate nullblk with unsupported size", "[bucketizer], [allocator]")
+{
+    bucketizer<free_list_allocator<stack_allocator<0x1000>, free_list_strategy::first_fit>, bucket_policy::linear<32, 256, 32>> allocator;
+
+    CHECK(allocator.allocate(0) == nullblk);
+    CHECK(allocator.allocate(257) == nullblk);
+}
+
+} // namespace coal
@@ -0,0 +1,234 @@
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/buddy_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using buddy_basic_allocators = std::tuple<
+    buddy_allocator<stack_allocator<0x10000, 8>, 4, 16>,
+    buddy_allocator<stack_allocator<0x10000, 16>, 5, 16>,
+    buddy_allocator<malloc_allocator, 4, 12>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "buddy_allocator basics", "[buddy_allocator], [allocator]", buddy_basic_allocators)
+{
+    this->test_basics();
+}
+
+using small_buddy = buddy_allocator<malloc_allocator, 4, 8>;
+
+TEST_CASE("buddy_allocator order_for_size", "[buddy_allocator], [allocator]")
+{
+    STATIC_CHECK(small_buddy::order_count == 5);
+    STATIC_CHECK(small_buddy::order_for_size(1) == 4);
+    STATIC_CHECK(small_buddy::order_for_size(16) == 4);
+    STATIC_CHECK(small_buddy::order_for_size(17) == 5);
+    STATIC_CHECK(small_buddy::order_for_size(32) == 5);
+    STATIC_CHECK(small_buddy::order_for_size(256) == 8);
+}
+
+TEST_CASE("buddy_allocator splits and merges buddies", "[buddy_allocator], [allocator]")
+{
+    small_buddy allocator;
+
+    CHECK(allocator.get_free_size() == 256);
+
+    memory_block block0 = allocator.allocate(16);
+
+    REQUIRE(block0);
+    CHECK(allocator.get_free_size() == 256 - 16);
+
+    // the whole region was halved down to 16 bytes, one free buddy at every order below the max
+    for (std::size_t order = 4; order < 8; ++order)
+    {
+        CHECK(allocator.get_free_block_count(order) == 1);
+    }
+
+    CHECK(allocator.get_free_block_count(8) == 0);
+
+    memory_block block1 = allocator.allocate(10);
+    memory_block block2 = allocator.allocate(64);
+
+    CHECK(block1.as<std::uint8_t>() == block0.as<std::uint8_t>() + 16);
+    CHECK(block2.as<std::uint8_t>() == block0.as<std::uint8_t>() + 64);
+    CHECK(allocator.get_free_size() == 256 - 16 - 16 - 64);
+
+    allocator.deallocate(block0);
+
+    // its buddy is allocated, no merge
+    CHECK(allocator.get_free_block_count(4) == 1);
+
+    allocator.deallocate(block1);
+
+    // merged with its buddy, then with the free 32 bytes following them
+    CHECK(allocator.get_free_block_count(4) == 0);
+    CHECK(allocator.get_free_block_count(5) == 0);
+    CHECK(allocator.get_free_block_count(6) == 1);
+
+    allocator.deallocate(block2);
+
+    CHECK(allocator.get_free_block_count(8) == 1);
+    CHECK(allocator.get_free_size() == 256);
+}
+
+TEST_CASE("buddy_allocator allocate nullblk when no block is large enough", "[buddy_allocator], [allocator]")
+{
+    small_buddy allocator;
+
+    CHECK(allocator.allocate(257) == nullblk);
+
+    memory_block block0 = allocator.allocate(128);
+    memory_block block1 = allocator.allocate(64);
+    memory_block block2 = allocator.allocate(64);
+
+    REQUIRE(block0);
+    REQUIRE(block1);
+    REQUIRE(block2);
+
+    CHECK(allocator.allocate(1) == nullblk);
+
+    void* ptr = block1.ptr;
+
+    allocator.deallocate(block1);
+
+    CHECK(allocator.allocate(128) == nullblk);
+    CHECK(allocator.allocate(64).ptr == ptr);
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.get_free_size() == 256);
+    CHECK(allocator.allocate(256));
+}
+
+TEST_CASE("buddy_allocator without parent memory", "[buddy_allocator], [allocator]")
+{
+    // too small for the region
+    buddy_allocator<stack_allocator<0x80>, 4, 8> allocator;
+
+    CHECK(allocator.allocate(16) == nullblk);
+    CHECK(allocator.get_free_size() == 256);
+}
+
+TEST_CASE("buddy_allocator expand into a free buddy", "[buddy_allocator], [allocator]")
+{
+    small_buddy allocator;
+
+    memory_block block0 = allocator.allocate(16);
+    memory_block block1 = allocator.allocate(16);
+
+    // within the order
+    CHECK(allocator.expand(block1, 0));
+
+    memory_block block2 = allocator.allocate(8);
+    CHECK(allocator.expand(block2, 8));
+    CHECK(block2.size == 16);
+
+    // second half of its parent block, cannot grow in place
+    CHECK_FALSE(allocator.expand(block1, 1));
+    CHECK(block1.size == 16);
+
+    allocator.deallocate(block1);
+
+    CHECK(allocator.expand(block0, 16));
+    CHECK(block0.size == 32);
+    CHECK(allocator.get_free_block_count(4) == 1);
+
+    // over the 32 bytes of block2 and its buddy, then over the free 128 bytes
+    CHECK_FALSE(allocator.expand(block0, 32));
+
+    allocator.deallocate(block2);
+
+    CHECK(allocator.expand(block0, 256 - 32));
+    CHECK(block0.size == 256);
+    CHECK(allocator.get_free_size() == 0);
+
+    CHECK_FALSE(allocator.expand(block0, 1));
+}
+
+TEST_CASE("buddy_allocator reallocate", "[buddy_allocator], [allocator]")
+{
+    small_buddy allocator;
+
+    memory_block block = allocator.allocate(40);
+    void* ptr = block.ptr;
+
+    std::memset(block.ptr, 0x5A, block.size);
+
+    SECTION("in place within the order")
+    {
+        CHECK(allocator.reallocate(block, 64));
+        CHECK(block.ptr == ptr);
+        CHECK(block.size == 64);
+        CHECK(allocator.get_free_size() == 256 - 64);
+    }
+
+    SECTION("in place to a lower order")
+    {
+        CHECK(allocator.reallocate(block, 16));
+        CHECK(block.ptr == ptr);
+        CHECK(allocator.get_free_size() == 256 - 16);
+
+        allocator.deallocate(block);
+
+        CHECK(allocator.get_free_block_count(8) == 1);
+    }
+
+    SECTION("moved when the buddy is taken")
+    {
+        memory_block buddy = allocator.allocate(64);
+
+        REQUIRE(buddy.as<std::uint8_t>() == block.as<std::uint8_t>() + 64);
+
+        CHECK(allocator.reallocate(block, 100));
+        CHECK(block.ptr != ptr);
+        CHECK(block.size == 100);
+
+        for (std::size_t i = 0; i < 40; ++i)
+        {
+            CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+        }
+    }
+}
+
+TEST_CASE("buddy_allocator merges everything back after random churn", "[buddy_allocator], [allocator]")
+{
+    buddy_allocator<malloc_allocator, 4, 16> allocator;
+
+    std::mt19937 random{42};
+    std::uniform_int_distribution<std::size_t> size_distribution{1, 2048};
+    std::vector<memory_block> blocks(64);
+
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+        memory_block& block = blocks[random() % blocks.size()];
+
+        if (block)
+        {
+            CHECK(block.as<std::uint8_t>()[block.size - 1] == static_cast<std::uint8_t>(block.size));
+            allocator.deallocate(block);
+        }
+        else if ((block = allocator.allocate(size_distribution(random))))
+        {
+            CHECK(allocator.owns(block));
+            std::memset(block.ptr, static_cast<int>(block.size), block.size);
+        }
+    }
+
+    for (memory_block& block : blocks)
+    {
+        allocator.deallocate(block);
+    }
+
+    CHECK(allocator.get_free_size() == allocator.max_size);
+    CHECK(allocator.get_free_block_count(allocator.max_order) == 1);
+}
+
+} // namespace coal
@@ -0,0 +1,162 @@
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/cascading_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/null_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using cascading_basic_allocators = std::tuple<
+    cascading_allocator<stack_allocator<0x1000, 8>>,
+    cascading_allocator<stack_allocator<0x1000, 16>>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "cascading_allocator basics", "[cascading_allocator], [allocator]", cascading_basic_allocators)
+{
+    this->test_basics();
+}
+
+using stats_malloc = stats_allocator<malloc_allocator>;
+
+TEST_CASE("cascading_allocator creates instances on demand", "[cascading_allocator], [allocator]")
+{
+    cascading_allocator<stack_allocator<0x100, 16>, stats_malloc> allocator;
+
+    CHECK(allocator.get_instance_count() == 0);
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+        memory_block block = allocator.allocate(0x80);
+
+        REQUIRE(block);
+        CHECK(allocator.owns(block));
+
+        std::memset(block.ptr, static_cast<int>(i), block.size);
+        blocks.push_back(block);
+    }
+
+    // two blocks per instance
+    CHECK(allocator.get_instance_count() == 5);
+
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        CHECK(blocks[i].as<std::uint8_t>()[0x7F] == static_cast<std::uint8_t>(i));
+    }
+
+    // too large for any instance
+    CHECK(allocator.allocate(0x200) == nullblk);
+    CHECK(allocator.get_instance_count() == 5);
+
+    stack_allocator<0x100, 16> other;
+    memory_block foreign = other.allocate(0x10);
+
+    CHECK_FALSE(allocator.owns(foreign));
+    CHECK_FALSE(allocator.owns(nullblk));
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.get_instance_count() == 0);
+    CHECK(allocator.get_parent_allocator().get_stats().live_bytes == 0);
+}
+
+TEST_CASE("cascading_allocator destroys empty instances but one", "[cascading_allocator], [allocator]")
+{
+    cascading_allocator<stack_allocator<0x100, 16>, stats_malloc> allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        blocks.push_back(allocator.allocate(0x80));
+    }
+
+    REQUIRE(allocator.get_instance_count() == 4);
+
+    // frees in allocation order, the stacks only give back their last block
+    for (memory_block& block : blocks)
+    {
+        allocator.deallocate(block);
+        CHECK(block == nullblk);
+    }
+
+    CHECK(allocator.get_instance_count() == 1);
+
+    // the instance kept was reset, it has room for two blocks again
+    memory_block first = allocator.allocate(0x80);
+    memory_block second = allocator.allocate(0x80);
+
+    CHECK(first);
+    CHECK(second);
+    CHECK(allocator.get_instance_count() == 1);
+
+    allocator.deallocate(first);
+    allocator.deallocate(second);
+
+    CHECK(allocator.get_instance_count() == 1);
+    CHECK(allocator.get_parent_allocator().get_stats().live_bytes > 0);
+}
+
+TEST_CASE("cascading_allocator oscillating around an instance capacity keeps its instances", "[cascading_allocator], [allocator]")
+{
+    cascading_allocator<stack_allocator<0x100, 16>, stats_malloc> allocator;
+
+    memory_block first = allocator.allocate(0x100);
+
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+        memory_block block = allocator.allocate(0x100);
+
+        REQUIRE(block);
+        CHECK(allocator.get_instance_count() == 2);
+
+        allocator.deallocate(block);
+    }
+
+    CHECK(allocator.get_parent_allocator().get_stats().get_calls(stats_operation::allocate) == 2);
+
+    allocator.deallocate(first);
+}
+
+TEST_CASE("cascading_allocator reallocate moves to an instance with room", "[cascading_allocator], [allocator]")
+{
+    cascading_allocator<stack_allocator<0x100, 16>> allocator;
+
+    memory_block block = allocator.allocate(0x80);
+    memory_block filler = allocator.allocate(0x80);
+
+    REQUIRE(allocator.get_instance_count() == 1);
+
+    std::memset(block.ptr, 0x5A, block.size);
+
+    REQUIRE(allocator.reallocate(block, 0xC0));
+
+    CHECK(block.size == 0xC0);
+    CHECK(allocator.get_instance_count() == 2);
+
+    for (std::size_t i = 0; i < 0x80; ++i)
+    {
+        CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+    }
+
+    allocator.deallocate(block);
+    allocator.deallocate(filler);
+}
+
+TEST_CASE("cascading_allocator without parent memory", "[cascading_allocator], [allocator]")
+{
+    cascading_allocator<stack_allocator<0x100, 16>, null_allocator> allocator;
+
+    CHECK(allocator.allocate(0x10) == nullblk);
+    CHECK(allocator.get_instance_count() == 0);
+}
+
+} // namespace coal
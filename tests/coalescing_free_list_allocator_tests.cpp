@@ -0,0 +1,273 @@
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/coalescing_free_list_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using coalescing_free_list_basic_allocators = std::tuple<
+    coalescing_free_list_allocator<stack_allocator<0x10000>, 0x1000>,
+    coalescing_free_list_allocator<malloc_allocator, 0x1000>,
+    coalescing_free_list_allocator<malloc_allocator, 0x400>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "coalescing_free_list_allocator basics", "[coalescing_free_list_allocator], [allocator]", coalescing_free_list_basic_allocators)
+{
+    this->test_basics();
+}
+
+using small_coalescing_free_list = coalescing_free_list_allocator<malloc_allocator, 0x1000>;
+
+// a chunk loses 24 bytes to its header and 16 to the tags bounding its blocks
+constexpr std::size_t chunk_free_size = 0x1000 - 40;
+
+TEST_CASE("coalescing_free_list_allocator splits and coalesces blocks", "[coalescing_free_list_allocator], [allocator]")
+{
+    small_coalescing_free_list allocator;
+
+    memory_block block0 = allocator.allocate(100);
+
+    REQUIRE(block0);
+    CHECK(allocator.get_chunk_count() == 1);
+    CHECK(allocator.get_free_block_count() == 1);
+    CHECK(allocator.get_free_size() == chunk_free_size - 120);
+
+    memory_block block1 = allocator.allocate(1);
+    memory_block block2 = allocator.allocate(200);
+
+    // blocks follow each other, each between two 8 byte tags
+    CHECK(block1.as<std::uint8_t>() == block0.as<std::uint8_t>() + 104 + 16);
+    CHECK(block2.as<std::uint8_t>() == block1.as<std::uint8_t>() + 16 + 16);
+
+    allocator.deallocate(block0);
+    allocator.deallocate(block2);
+
+    // block2 merged with the rest of the chunk, block0 stays apart
+    CHECK(allocator.get_free_block_count() == 2);
+
+    allocator.deallocate(block1);
+
+    CHECK(allocator.get_free_block_count() == 1);
+    CHECK(allocator.get_free_size() == chunk_free_size);
+
+    // the last chunk is kept
+    CHECK(allocator.get_chunk_count() == 1);
+}
+
+TEST_CASE("coalescing_free_list_allocator serves the lowest address first", "[coalescing_free_list_allocator], [allocator]")
+{
+    small_coalescing_free_list allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        blocks.push_back(allocator.allocate(48));
+    }
+
+    void* ptr1 = blocks[1].ptr;
+    void* ptr5 = blocks[5].ptr;
+
+    allocator.deallocate(blocks[5]);
+    allocator.deallocate(blocks[1]);
+
+    CHECK(allocator.get_free_block_count() == 3);
+
+    CHECK(allocator.allocate(40).ptr == ptr1);
+    CHECK(allocator.allocate(40).ptr == ptr5);
+}
+
+TEST_CASE("coalescing_free_list_allocator returns empty chunks", "[coalescing_free_list_allocator], [allocator]")
+{
+    small_coalescing_free_list allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 32; ++i)
+    {
+        blocks.push_back(allocator.allocate(1000));
+    }
+
+    CHECK(allocator.get_chunk_count() == 11);
+
+    for (memory_block& block : blocks)
+    {
+        allocator.deallocate(block);
+    }
+
+    CHECK(allocator.get_chunk_count() == 1);
+    CHECK(allocator.get_free_block_count() == 1);
+    CHECK(allocator.get_free_size() == chunk_free_size);
+
+    SECTION("a large block gets a chunk of its own")
+    {
+        memory_block small = allocator.allocate(16);
+        memory_block large = allocator.allocate(0x4000);
+
+        REQUIRE(large);
+        CHECK(allocator.get_chunk_count() == 2);
+
+        // kept, the other chunk is not empty
+        allocator.deallocate(large);
+        CHECK(allocator.get_chunk_count() == 2);
+
+        allocator.deallocate(small);
+        CHECK(allocator.get_chunk_count() == 1);
+    }
+
+    SECTION("deallocate_all")
+    {
+        allocator.deallocate_all();
+
+        CHECK(allocator.get_chunk_count() == 0);
+        CHECK(allocator.get_free_size() == 0);
+        CHECK(allocator.allocate(16));
+    }
+}
+
+TEST_CASE("coalescing_free_list_allocator expand over the next free block", "[coalescing_free_list_allocator], [allocator]")
+{
+    small_coalescing_free_list allocator;
+
+    memory_block block0 = allocator.allocate(64);
+    memory_block block1 = allocator.allocate(64);
+    memory_block block2 = allocator.allocate(64);
+
+    // within the aligned size
+    memory_block block3 = allocator.allocate(1);
+    CHECK(allocator.expand(block3, 7));
+    CHECK(block3.size == 8);
+
+    CHECK_FALSE(allocator.expand(block0, 1));
+
+    allocator.deallocate(block1);
+
+    // over the 64 bytes and tags of block1
+    CHECK(allocator.expand(block0, 80));
+    CHECK(block0.size == 144);
+    CHECK(allocator.get_free_block_count() == 1);
+
+    CHECK_FALSE(allocator.expand(block0, 1));
+
+    // the last block grows over the rest of the chunk
+    CHECK(allocator.expand(block3, 0x800));
+    CHECK(block3.size == 0x808);
+
+    allocator.deallocate(block0);
+    allocator.deallocate(block2);
+    allocator.deallocate(block3);
+
+    CHECK(allocator.get_free_block_count() == 1);
+    CHECK(allocator.get_free_size() == chunk_free_size);
+}
+
+TEST_CASE("coalescing_free_list_allocator reallocate", "[coalescing_free_list_allocator], [allocator]")
+{
+    small_coalescing_free_list allocator;
+
+    memory_block block = allocator.allocate(200);
+    void* ptr = block.ptr;
+
+    std::memset(block.ptr, 0x5A, block.size);
+
+    SECTION("shrinks in place")
+    {
+        const std::size_t free_size = allocator.get_free_size();
+
+        CHECK(allocator.reallocate(block, 50));
+        CHECK(block.ptr == ptr);
+        CHECK(block.size == 50);
+
+        // the tail merged with the free rest of the chunk
+        CHECK(allocator.get_free_size() == free_size + 216 - 72);
+        CHECK(allocator.get_free_block_count() == 1);
+    }
+
+    SECTION("grows in place")
+    {
+        CHECK(allocator.reallocate(block, 400));
+        CHECK(block.ptr == ptr);
+        CHECK(block.size == 400);
+    }
+
+    SECTION("moves when the next block is taken")
+    {
+        memory_block next = allocator.allocate(16);
+
+        CHECK(allocator.reallocate(block, 400));
+        CHECK(block.ptr != ptr);
+        CHECK(block.size == 400);
+
+        for (std::size_t i = 0; i < 200; ++i)
+        {
+            CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+        }
+
+        allocator.deallocate(next);
+    }
+}
+
+TEST_CASE("coalescing_free_list_allocator does not grow under steady churn", "[coalescing_free_list_allocator], [allocator]")
+{
+    coalescing_free_list_allocator<malloc_allocator, 0x10000> allocator;
+
+    std::mt19937 random{42};
+    std::uniform_int_distribution<std::size_t> size_distribution{1, 4096};
+    std::vector<memory_block> blocks(128);
+    std::size_t halfway_chunk_count = 0;
+
+    for (std::size_t i = 0; i < 40000; ++i)
+    {
+        memory_block& block = blocks[random() % blocks.size()];
+
+        if (block)
+        {
+            CHECK(block.as<std::uint8_t>()[block.size - 1] == static_cast<std::uint8_t>(block.size));
+
+            if (i % 3 == 0)
+            {
+                const std::size_t new_size = size_distribution(random);
+
+                if (allocator.reallocate(block, new_size))
+                {
+                    std::memset(block.ptr, static_cast<int>(block.size), block.size);
+                }
+            }
+            else
+            {
+                allocator.deallocate(block);
+            }
+        }
+        else if ((block = allocator.allocate(size_distribution(random))))
+        {
+            CHECK(allocator.owns(block));
+            CHECK(reinterpret_cast<std::uintptr_t>(block.ptr) % allocator.get_alignment() == 0);
+            std::memset(block.ptr, static_cast<int>(block.size), block.size);
+        }
+
+        if (i == 20000)
+        {
+            halfway_chunk_count = allocator.get_chunk_count();
+        }
+    }
+
+    // at most 128 live blocks of 4 KiB, merging keeps the chunks from piling up
+    CHECK(allocator.get_chunk_count() <= halfway_chunk_count + 2);
+
+    for (memory_block& block : blocks)
+    {
+        allocator.deallocate(block);
+    }
+
+    CHECK(allocator.get_chunk_count() == 1);
+    CHECK(allocator.get_free_block_count() == 1);
+}
+
+} // namespace coal
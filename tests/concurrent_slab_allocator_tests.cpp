@@ -0,0 +1,203 @@
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/concurrent_slab_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+#include <allocator_mock.hpp>
+
+namespace coal {
+
+using concurrent_slab_basic_allocators = std::tuple<
+    concurrent_slab_allocator<malloc_allocator, 0x1000, 32, 64, 128, 256, 512, 1024>,
+    concurrent_slab_allocator<stack_allocator<0x1000 * 6, 8>, 0x1000, 32, 64, 128, 256, 512, 1024>,
+    concurrent_slab_allocator<stack_allocator<0x1000 * 6, 16>, 0x1000, 32, 64, 128, 256, 512, 1024>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "concurrent_slab_allocator basics", "[concurrent_slab_allocator], [allocator]", concurrent_slab_basic_allocators)
+{
+    this->small_expand = false;
+    this->large_expand = false;
+
+    this->test_basics();
+}
+
+using mock_concurrent_slab_allocator = concurrent_slab_allocator<mock::minimal_allocator, 0x1000, 32, 64>;
+
+TEST_CASE("concurrent_slab_allocator init", "[concurrent_slab_allocator], [allocator]")
+{
+    struct mock_initializer
+    {
+        void init([[maybe_unused]] mock_concurrent_slab_allocator& root)
+        {
+            ++init_count;
+        }
+
+        void init([[maybe_unused]] mock::minimal_allocator& a)
+        {
+            CHECK(init_count == 0);
+        }
+
+        std::size_t init_count{0};
+    };
+
+    mock::minimal_allocator::reset_mock();
+
+    mock_concurrent_slab_allocator allocator;
+    mock_initializer initializer;
+    allocator.init(initializer);
+
+    CHECK(initializer.init_count == 1);
+    CHECK(mock::minimal_allocator::init_count == 1);
+}
+
+TEST_CASE("concurrent_slab_allocator carves a chunk per slab", "[concurrent_slab_allocator], [allocator]")
+{
+    concurrent_slab_allocator<stats_allocator<malloc_allocator, stats_options::calls | stats_options::live_bytes, 1>, 0x1000, 32, 64> allocator;
+
+    std::vector<memory_block> blocks;
+    std::set<void*> pointers;
+
+    // the chunk header takes one object of the chunk
+    const std::size_t objects_per_chunk = 0x1000 / 32 - 1;
+
+    for (std::size_t i = 0; i < objects_per_chunk; ++i)
+    {
+        blocks.push_back(allocator.allocate(32));
+        REQUIRE(blocks.back());
+        pointers.insert(blocks.back().ptr);
+    }
+
+    CHECK(pointers.size() == objects_per_chunk);
+    CHECK(allocator.get_chunk_count() == 1);
+
+    blocks.push_back(allocator.allocate(24));
+    blocks.push_back(allocator.allocate(64));
+
+    CHECK(allocator.get_chunk_count() == 3);
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::allocate) == 3);
+
+    SECTION("freed objects are reused first")
+    {
+        void* ptr = blocks.front().ptr;
+
+        allocator.deallocate(blocks.front());
+
+        CHECK(blocks.front() == nullblk);
+        CHECK(allocator.allocate(32).ptr == ptr);
+    }
+
+    SECTION("chunks go back to the allocator")
+    {
+        allocator.deallocate_all();
+
+        CHECK(allocator.get_chunk_count() == 0);
+        CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+    }
+}
+
+TEST_CASE("concurrent_slab_allocator allocate nullblk with unsupported size", "[concurrent_slab_allocator], [allocator]")
+{
+    concurrent_slab_allocator<malloc_allocator, 0x1000, 32, 64, 128> allocator;
+
+    CHECK(allocator.allocate(0) == nullblk);
+    CHECK(allocator.allocate(150) == nullblk);
+}
+
+TEST_CASE("concurrent_slab_allocator allocate nullblk when the parent is out of memory", "[concurrent_slab_allocator], [allocator]")
+{
+    // the parent stack is smaller than a chunk
+    concurrent_slab_allocator<stack_allocator<0x800, 16>, 0x1000, 32> allocator;
+
+    CHECK(allocator.allocate(32) == nullblk);
+    CHECK(allocator.get_chunk_count() == 0);
+}
+
+TEST_CASE("concurrent_slab_allocator reallocate keeps the content", "[concurrent_slab_allocator], [allocator]")
+{
+    concurrent_slab_allocator<malloc_allocator, 0x1000, 32, 64, 128> allocator;
+
+    memory_block block = allocator.allocate(24);
+    std::memset(block.ptr, 0x5A, block.size);
+
+    CHECK(allocator.expand(block, 8));
+    CHECK_FALSE(allocator.expand(block, 1));
+
+    REQUIRE(allocator.reallocate(block, 100));
+
+    CHECK(block.size == 100);
+
+    for (std::size_t i = 0; i < 24; ++i)
+    {
+        CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+    }
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("concurrent_slab_allocator shared between threads", "[concurrent_slab_allocator], [allocator]")
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iteration_count = 2000;
+    constexpr std::size_t live_count = 64;
+
+    concurrent_slab_allocator<malloc_allocator, 0x1000, 16, 32, 64, 128> allocator;
+
+    std::atomic<std::size_t> failure_count{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&allocator, &failure_count, i]() {
+            std::vector<memory_block> blocks(live_count);
+
+            for (std::size_t j = 0; j < iteration_count; ++j)
+            {
+                memory_block& block = blocks[(j * 13) % live_count];
+
+                if (block)
+                {
+                    // another thread holding the same object would have overwritten the pattern
+                    if (block.as<std::uint8_t>()[block.size - 1] != static_cast<std::uint8_t>(i))
+                    {
+                        ++failure_count;
+                    }
+
+                    allocator.deallocate(block);
+                }
+
+                block = allocator.allocate(1 + (i * 31 + j * 7) % 128);
+
+                if (!block)
+                {
+                    ++failure_count;
+                    continue;
+                }
+
+                std::memset(block.ptr, static_cast<int>(i), block.size);
+            }
+
+            for (memory_block& block : blocks)
+            {
+                allocator.deallocate(block);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(failure_count == 0);
+}
+
+} // namespace coal
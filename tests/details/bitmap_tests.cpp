@@ -0,0 +1,86 @@
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/details/bitmap.hpp>
+
+namespace coal::details {
+
+constexpr bool constexpr_bitmap_finds_run()
+{
+    bitmap<100> bits;
+    bits.set(10, 5);
+    bits.set(70, 20);
+
+    return bits.find_first_set(0) == 10 && bits.find_set_run(0, 6) == 70 && bits.find_first_reset(70) == 90;
+}
+
+TEMPLATE_TEST_CASE_SIG("bitmap find", "[bitmap]", ((std::size_t N), N), 1, 63, 64, 65, 200, 1000)
+{
+    bitmap<N> bits;
+
+    CHECK(bits.find_first_set(0) == bitmap<N>::npos);
+    CHECK(bits.find_first_reset(0) == 0);
+
+    bits.set_all();
+
+    CHECK(bits.find_first_set(0) == 0);
+    CHECK(bits.find_first_set(N - 1) == N - 1);
+    CHECK(bits.find_first_reset(0) == N);
+    CHECK(bits.find_set_run(0, N) == 0);
+
+    bits.reset(0, N - 1);
+
+    CHECK(bits.find_first_set(0) == N - 1);
+    CHECK(bits.find_first_reset(N - 1) == N);
+    CHECK(bits.test(N - 1));
+
+    bits.reset_all();
+
+    CHECK(bits.find_first_set(0) == bitmap<N>::npos);
+}
+
+TEST_CASE("bitmap set and reset across words", "[bitmap]")
+{
+    bitmap<300> bits;
+
+    bits.set(60, 140);
+
+    CHECK_FALSE(bits.test(59));
+    CHECK(bits.test(60));
+    CHECK(bits.test(199));
+    CHECK_FALSE(bits.test(200));
+
+    CHECK(bits.find_first_set(0) == 60);
+    CHECK(bits.find_first_set(130) == 130);
+    CHECK(bits.find_first_reset(60) == 200);
+    CHECK(bits.find_first_set(200) == bitmap<300>::npos);
+
+    bits.reset(64, 64);
+
+    CHECK(bits.find_first_set(61) == 61);
+    CHECK(bits.find_first_set(64) == 128);
+    CHECK(bits.find_first_reset(60) == 64);
+}
+
+TEST_CASE("bitmap find_set_run", "[bitmap]")
+{
+    bitmap<1000> bits;
+
+    bits.set(3, 2);
+    bits.set(10, 60);
+    bits.set(500, 300);
+
+    CHECK(bits.find_set_run(0, 1) == 3);
+    CHECK(bits.find_set_run(0, 2) == 3);
+    CHECK(bits.find_set_run(0, 3) == 10);
+    CHECK(bits.find_set_run(0, 60) == 10);
+    CHECK(bits.find_set_run(0, 61) == 500);
+    CHECK(bits.find_set_run(20, 50) == 20);
+    CHECK(bits.find_set_run(20, 51) == 500);
+    CHECK(bits.find_set_run(0, 300) == 500);
+    CHECK(bits.find_set_run(0, 301) == bitmap<1000>::npos);
+    CHECK(bits.find_set_run(0, 1000) == bitmap<1000>::npos);
+
+    STATIC_CHECK(constexpr_bitmap_finds_run());
+}
+
+} // namespace coal::details
@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/details/tagged_pointer.hpp>
+
+namespace coal::details {
+
+TEST_CASE("atomic_tagged_pointer bumps the tag on every exchange", "[tagged_pointer]")
+{
+    int values[2]{};
+
+    atomic_tagged_pointer<int> pointer;
+    pointer.store(&values[0], std::memory_order_relaxed);
+
+    tagged_pointer<int> expected = pointer.load(std::memory_order_relaxed);
+
+    CHECK(expected.ptr == &values[0]);
+    CHECK(expected.tag == 0);
+
+    REQUIRE(pointer.compare_exchange_weak(expected, &values[1], std::memory_order_relaxed, std::memory_order_relaxed));
+    CHECK(pointer.load(std::memory_order_relaxed) == tagged_pointer<int>{&values[1], 1});
+
+    expected = pointer.load(std::memory_order_relaxed);
+    REQUIRE(pointer.compare_exchange_weak(expected, &values[0], std::memory_order_relaxed, std::memory_order_relaxed));
+
+    SECTION("a stale tag fails and reloads the current value")
+    {
+        // same pointer as the current value, the tag tells them apart
+        tagged_pointer<int> stale{&values[0], 0};
+
+        CHECK_FALSE(pointer.compare_exchange_weak(stale, nullptr, std::memory_order_relaxed, std::memory_order_relaxed));
+        CHECK(stale == tagged_pointer<int>{&values[0], 2});
+    }
+
+    SECTION("the tag wraps around")
+    {
+        constexpr std::uintptr_t mask = atomic_tagged_pointer<int>::tag_mask;
+
+        // narrow tags wrap after a few thousand exchanges, wide ones are only checked for the first ones
+        const std::uintptr_t count = mask > 0x10000 ? 0x100 : mask + 1;
+
+        for (std::uintptr_t i = 0; i < count; ++i)
+        {
+            tagged_pointer<int> current = pointer.load(std::memory_order_relaxed);
+            while (!pointer.compare_exchange_weak(current, current.ptr, std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        CHECK(pointer.load(std::memory_order_relaxed) == tagged_pointer<int>{&values[0], (2 + count) & mask});
+    }
+}
+
+} // namespace coal::details
@@ -0,0 +1,16 @@
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/details/usdt.hpp>
+#include <coal/stack_allocator.hpp>
+
+namespace coal::details {
+
+TEST_CASE("usdt_type_name", "[usdt]")
+{
+    STATIC_CHECK(std::string_view{usdt_type_name<stack_allocator<0x1000, 8>>()}.starts_with("coal::stack_allocator"));
+    STATIC_CHECK(std::string_view{usdt_type_name<int>()} == "int");
+}
+
+} // namespace coal::details
@@ -0,0 +1,274 @@
+#include <cstring>
+#include <tuple>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/double_ended_stack_allocator.hpp>
+#include <coal/scoped_rewind.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using double_ended_stack_allocator_types = std::tuple<
+    double_ended_stack_allocator<0x1000, 4>,
+    double_ended_stack_allocator<0x1000, 8>,
+    double_ended_stack_allocator<0x1000, 16>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "double_ended_stack_allocator basics", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    this->test_basics();
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator allocate from both ends", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    memory_block low0 = this->allocator.allocate_low(1);
+    memory_block low1 = this->allocator.allocate(1);
+    memory_block high0 = this->allocator.allocate_high(1);
+    memory_block high1 = this->allocator.allocate_high(1);
+
+    REQUIRE(low0);
+    REQUIRE(low1);
+    REQUIRE(high0);
+    REQUIRE(high1);
+
+    CHECK(low1.as<std::uint8_t>() == low0.as<std::uint8_t>() + TestType::alignment);
+    CHECK(high0.as<std::uint8_t>() == low0.as<std::uint8_t>() + TestType::max_size - TestType::alignment);
+    CHECK(high1.as<std::uint8_t>() == high0.as<std::uint8_t>() - TestType::alignment);
+    CHECK(this->allocator.get_free_size() == TestType::max_size - 4 * TestType::alignment);
+
+    CHECK(this->allocator.owns(low0));
+    CHECK(this->allocator.owns(high0));
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator the ends share the buffer", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    memory_block low = this->allocator.allocate_low(TestType::max_size / 4);
+    memory_block high = this->allocator.allocate_high(TestType::max_size / 4 * 3);
+
+    REQUIRE(low);
+    REQUIRE(high);
+
+    CHECK(this->allocator.get_free_size() == 0);
+    CHECK(this->allocator.allocate_low(1) == nullblk);
+    CHECK(this->allocator.allocate_high(1) == nullblk);
+
+    this->allocator.deallocate(low);
+
+    CHECK(this->allocator.allocate_high(TestType::max_size / 4));
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator deallocate the last block of each end", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    memory_block low0 = this->allocator.allocate_low(8);
+    memory_block low1 = this->allocator.allocate_low(8);
+    memory_block high0 = this->allocator.allocate_high(8);
+    memory_block high1 = this->allocator.allocate_high(8);
+
+    void* low1_ptr = low1.ptr;
+    void* high1_ptr = high1.ptr;
+
+    SECTION("last blocks are reused")
+    {
+        this->deallocate_and_check_is_nullblk(low1);
+        this->deallocate_and_check_is_nullblk(high1);
+
+        CHECK(this->allocator.allocate_low(8).ptr == low1_ptr);
+        CHECK(this->allocator.allocate_high(8).ptr == high1_ptr);
+    }
+
+    SECTION("other blocks are not reused")
+    {
+        const std::size_t free_size = this->allocator.get_free_size();
+
+        this->deallocate_and_check_is_nullblk(low0);
+        this->deallocate_and_check_is_nullblk(high0);
+
+        CHECK(this->allocator.get_free_size() == free_size);
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator deallocate_all per end", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    memory_block low = this->allocator.allocate_low(8);
+    memory_block high = this->allocator.allocate_high(8);
+
+    SECTION("deallocate_all_low keeps the high end")
+    {
+        this->allocator.deallocate_all_low();
+
+        CHECK(this->allocator.allocate_low(8).ptr == low.ptr);
+        CHECK(static_cast<std::uint8_t*>(this->allocator.allocate_high(8).ptr) == high.as<std::uint8_t>() - align_up(8, TestType::alignment));
+    }
+
+    SECTION("deallocate_all_high keeps the low end")
+    {
+        this->allocator.deallocate_all_high();
+
+        CHECK(this->allocator.allocate_high(8).ptr == high.ptr);
+        CHECK(static_cast<std::uint8_t*>(this->allocator.allocate_low(8).ptr) == low.as<std::uint8_t>() + align_up(8, TestType::alignment));
+    }
+
+    SECTION("deallocate_all frees both ends")
+    {
+        this->allocator.deallocate_all();
+
+        CHECK(this->allocator.get_free_size() == TestType::max_size);
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator rewind per end", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    [[maybe_unused]] memory_block low0 = this->allocator.allocate_low(8);
+    [[maybe_unused]] memory_block high0 = this->allocator.allocate_high(8);
+
+    const typename TestType::low_marker low_marker = this->allocator.mark_low();
+    const typename TestType::high_marker high_marker = this->allocator.mark_high();
+
+    memory_block low1 = this->allocator.allocate_low(8);
+    [[maybe_unused]] memory_block low2 = this->allocator.allocate_low(8);
+    memory_block high1 = this->allocator.allocate_high(8);
+    [[maybe_unused]] memory_block high2 = this->allocator.allocate_high(8);
+
+    SECTION("rewind_low")
+    {
+        this->allocator.rewind_low(low_marker);
+
+        CHECK(this->allocator.allocate_low(8).ptr == low1.ptr);
+        CHECK(static_cast<std::uint8_t*>(this->allocator.allocate_high(8).ptr) == high2.as<std::uint8_t>() - align_up(8, TestType::alignment));
+    }
+
+    SECTION("rewind_high")
+    {
+        this->allocator.rewind_high(high_marker);
+
+        CHECK(this->allocator.allocate_high(8).ptr == high1.ptr);
+        CHECK(static_cast<std::uint8_t*>(this->allocator.allocate_low(8).ptr) == low2.as<std::uint8_t>() + align_up(8, TestType::alignment));
+    }
+
+    SECTION("rewind both")
+    {
+        this->allocator.rewind({low_marker, high_marker});
+
+        CHECK(this->allocator.allocate_low(8).ptr == low1.ptr);
+        CHECK(this->allocator.allocate_high(8).ptr == high1.ptr);
+    }
+}
+
+TEST_CASE("double_ended_stack_allocator scoped_rewind", "[double_ended_stack_allocator], [allocator]")
+{
+    double_ended_stack_allocator<0x1000> allocator;
+
+    memory_block low = allocator.allocate_low(8);
+    memory_block high = allocator.allocate_high(8);
+
+    {
+        scoped_rewind rewind{allocator};
+
+        [[maybe_unused]] memory_block scratch0 = allocator.allocate_high(64);
+        [[maybe_unused]] memory_block scratch1 = allocator.allocate_low(64);
+    }
+
+    CHECK(allocator.get_free_size() == 0x1000 - 16);
+    CHECK(allocator.owns(low));
+    CHECK(allocator.owns(high));
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator reallocate keeps the block on its end", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    memory_block high = this->allocator.allocate_high(8);
+    std::memset(high.ptr, 0x5A, high.size);
+
+    SECTION("last high block grows down")
+    {
+        std::uint8_t* end = high.as<std::uint8_t>() + align_up(high.size, TestType::alignment);
+
+        REQUIRE(this->allocator.reallocate(high, 64));
+
+        CHECK(high.as<std::uint8_t>() + align_up(high.size, TestType::alignment) == end);
+
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            CHECK(high.as<std::uint8_t>()[i] == 0x5A);
+        }
+    }
+
+    SECTION("last high block shrinks up")
+    {
+        REQUIRE(this->allocator.reallocate(high, 64));
+
+        std::uint8_t* end = high.as<std::uint8_t>() + align_up(high.size, TestType::alignment);
+
+        REQUIRE(this->allocator.reallocate(high, 4));
+
+        CHECK(high.as<std::uint8_t>() + align_up(high.size, TestType::alignment) == end);
+
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            CHECK(high.as<std::uint8_t>()[i] == 0x5A);
+        }
+
+        this->allocator.deallocate(high);
+
+        CHECK(this->allocator.get_free_size() == TestType::max_size);
+    }
+
+    SECTION("high block below the last one moves to the high end")
+    {
+        [[maybe_unused]] memory_block last = this->allocator.allocate_high(8);
+
+        REQUIRE(this->allocator.reallocate(high, 64));
+
+        CHECK(high.as<std::uint8_t>() < last.as<std::uint8_t>());
+        CHECK(this->allocator.allocate_low(8));
+
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            CHECK(high.as<std::uint8_t>()[i] == 0x5A);
+        }
+    }
+
+    SECTION("low block moves to the low end")
+    {
+        memory_block low = this->allocator.allocate_low(8);
+        [[maybe_unused]] memory_block last = this->allocator.allocate_low(8);
+
+        REQUIRE(this->allocator.reallocate(low, 64));
+
+        CHECK(low.as<std::uint8_t>() > last.as<std::uint8_t>());
+        CHECK(low.as<std::uint8_t>() < high.as<std::uint8_t>());
+    }
+
+    SECTION("last high block fails when out of memory")
+    {
+        const memory_block original = high;
+
+        CHECK_FALSE(this->allocator.reallocate(high, TestType::max_size + 1));
+        CHECK(high == original);
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "double_ended_stack_allocator expand", "[double_ended_stack_allocator], [allocator]", double_ended_stack_allocator_types)
+{
+    SECTION("the last low block expands up to the high end")
+    {
+        memory_block high = this->allocator.allocate_high(TestType::max_size / 2);
+        memory_block low = this->allocator.allocate_low(8);
+
+        CHECK(this->allocator.expand(low, TestType::max_size / 2 - 8));
+        CHECK_FALSE(this->allocator.expand(low, 1));
+        CHECK(this->allocator.get_free_size() == 0);
+
+        this->deallocate_and_check_is_nullblk(high);
+    }
+
+    SECTION("a high block does not expand")
+    {
+        memory_block high = this->allocator.allocate_high(8);
+
+        CHECK_FALSE(this->allocator.expand(high, 8));
+        CHECK(high.size == 8);
+    }
+}
+
+} // namespace coal
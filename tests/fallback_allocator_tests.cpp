@@ -1,6 +1,7 @@
 #include <catch2/catch_template_test_macros.hpp>
 
 #include <coal/fallback_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
 #include <coal/memory_block.hpp>
 #include <coal/stack_allocator.hpp>
 
@@ -135,4 +136,49 @@ TEST_CASE_METHOD(fallback_allocator_fixture, "fallback_allocator deallocate owne
     CHECK(mock_primary::deallocate_count == 0);
 }
 
+TEST_CASE("fallback_allocator mark requires a child with mark", "[fallback_allocator], [allocator]")
+{
+    STATIC_CHECK(allocator_traits::has_mark<fallback_allocator<stack_allocator<0x100>, stack_allocator<0x1000>>>);
+    STATIC_CHECK(allocator_traits::has_mark<fallback_allocator<stack_allocator<0x100>, malloc_allocator>>);
+    STATIC_CHECK(allocator_traits::has_mark<fallback_allocator<malloc_allocator, stack_allocator<0x100>>>);
+    STATIC_CHECK_FALSE(allocator_traits::has_mark<fallback_allocator<malloc_allocator, malloc_allocator>>);
+}
+
+TEST_CASE("fallback_allocator rewind both allocators", "[fallback_allocator], [allocator]")
+{
+    fallback_allocator<stack_allocator<0x40>, stack_allocator<0x1000>> allocator;
+
+    const auto marker = allocator.mark();
+
+    memory_block primary_block = allocator.allocate(0x40);
+    memory_block fallback_block = allocator.allocate(0x40);
+
+    REQUIRE(allocator.get_primary_allocator().owns(primary_block));
+    REQUIRE(allocator.get_fallback_allocator().owns(fallback_block));
+
+    allocator.rewind(marker);
+
+    CHECK(allocator.allocate(0x40).ptr == primary_block.ptr);
+    CHECK(allocator.allocate(0x40).ptr == fallback_block.ptr);
+}
+
+TEST_CASE("fallback_allocator rewind the primary allocator only", "[fallback_allocator], [allocator]")
+{
+    fallback_allocator<stack_allocator<0x40>, malloc_allocator> allocator;
+
+    const auto marker = allocator.mark();
+
+    memory_block primary_block = allocator.allocate(0x40);
+    memory_block fallback_block = allocator.allocate(0x40);
+
+    REQUIRE(allocator.get_primary_allocator().owns(primary_block));
+
+    allocator.rewind(marker);
+
+    // the blocks of the fallback stay allocated
+    CHECK(allocator.allocate(0x40).ptr == primary_block.ptr);
+
+    allocator.get_fallback_allocator().deallocate(fallback_block);
+}
+
 } // namespace coal
@@ -1,9 +1,12 @@
 #include <catch2/catch_template_test_macros.hpp>
 
 #include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/best_fit.hpp>
 #include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/free_list_strategy/instrumented.hpp>
 #include <coal/memory_block.hpp>
 #include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
 
 #include <allocator_fixture.hpp>
 #include <allocator_mock.hpp>
@@ -54,4 +57,68 @@ TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "free_list_allocator bas
     this->test_basics();
 }
 
-} // namespace coal
\ No newline at end of file
+TEST_CASE("free_list_allocator blocks smaller than a node can be cached", "[free_list_allocator], [allocator]")
+{
+    free_list_allocator<stack_allocator<0x1000, 4>, free_list_strategy::first_fit> allocator;
+
+    memory_block block0 = allocator.allocate(1);
+    memory_block block1 = allocator.allocate(1);
+
+    REQUIRE(block0);
+    REQUIRE(block1);
+    CHECK(static_cast<std::size_t>(block1.as<std::uint8_t>() - block0.as<std::uint8_t>()) >= sizeof(free_list_node));
+
+    void* ptr0 = block0.ptr;
+    allocator.deallocate(block0);
+
+    memory_block block2 = allocator.allocate(1);
+    CHECK(block2.ptr == ptr0);
+
+    allocator.deallocate(block1);
+    allocator.deallocate(block2);
+}
+
+TEST_CASE("free_list_allocator free list stats", "[free_list_allocator], [allocator]")
+{
+    free_list_allocator<stack_allocator<0x1000, 16>, free_list_strategy::instrumented<free_list_strategy::best_fit>> allocator;
+
+    memory_block block0 = allocator.allocate(64);
+    memory_block block1 = allocator.allocate(16);
+    memory_block block2 = allocator.allocate(256);
+    memory_block block3 = allocator.allocate(16);
+
+    allocator.deallocate(block0);
+    allocator.deallocate(block2);
+
+    free_list_stats stats = allocator.get_free_list_stats();
+
+    CHECK(stats.node_count == 2);
+    CHECK(stats.cached_bytes == 64 + 256);
+    CHECK(stats.largest_node_size == 256);
+    CHECK(stats.size_histogram[free_list_stats::histogram_bucket(64)] == 1);
+    CHECK(stats.size_histogram[free_list_stats::histogram_bucket(256)] == 1);
+
+    // buckets of allocator_stats, bucket 7 is [64, 128)
+    STATIC_CHECK(free_list_stats::histogram_bucket(64) == 7);
+    STATIC_CHECK(free_list_stats::histogram_bucket(127) == 7);
+    STATIC_CHECK(free_list_stats::histogram_bucket(256) == allocator_stats::histogram_bucket(256));
+    CHECK(stats.get_external_fragmentation() == 1.0 - 256.0 / (64.0 + 256.0));
+
+    // the two nodes are visited, the 64 bytes node is handed out whole
+    memory_block block4 = allocator.allocate(32);
+
+    stats = allocator.get_free_list_stats();
+
+    CHECK(stats.node_count == 1);
+    CHECK(stats.allocate_count == 1);
+    CHECK(stats.hit_count == 1);
+    CHECK(stats.max_search_length == 2);
+    CHECK(stats.get_average_search_length() == 2.0);
+    CHECK(stats.internal_waste_bytes == 64 - 32);
+
+    allocator.deallocate(block1);
+    allocator.deallocate(block3);
+    allocator.deallocate(block4);
+}
+
+} // namespace coal
@@ -0,0 +1,56 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/free_list_strategy/instrumented.hpp>
+#include <coal/memory_block.hpp>
+
+#include <free_list_mock.hpp>
+
+namespace coal::free_list_strategy {
+
+TEST_CASE("instrumented allocate", "[instrumented], [free_list_strategy]")
+{
+    instrumented<first_fit> strategy;
+
+    searched_free_list<mock::free_list> list;
+    list.add_node(10);
+    list.add_node(20);
+    list.add_node(30);
+
+    free_list_node* node = strategy.allocate(list, 15);
+
+    REQUIRE(node != nullptr);
+    CHECK(node->size == 20);
+    CHECK(list.search_length == 2);
+
+    CHECK(strategy.allocate(list, 40) == nullptr);
+    CHECK(list.search_length == 2);
+
+    free_list_stats stats;
+    strategy.collect_stats(stats);
+
+    CHECK(stats.allocate_count == 2);
+    CHECK(stats.hit_count == 1);
+    CHECK(stats.total_search_length == 4);
+    CHECK(stats.max_search_length == 2);
+    CHECK(stats.internal_waste_bytes == 5);
+
+    strategy.reset_stats();
+    strategy.collect_stats(stats);
+
+    CHECK(stats.allocate_count == 0);
+    CHECK(stats.internal_waste_bytes == 0);
+}
+
+TEST_CASE("instrumented deallocate", "[instrumented], [free_list_strategy]")
+{
+    instrumented<first_fit> strategy;
+    mock::free_list list;
+
+    memory_block block = list.new_node_block(8);
+
+    CHECK(strategy.deallocate(list, block));
+    CHECK(list.first_node == block.as<free_list_node>());
+}
+
+} // namespace coal::free_list_strategy
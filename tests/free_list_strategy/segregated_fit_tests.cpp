@@ -0,0 +1,162 @@
+#include <type_traits>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/limited_size.hpp>
+#include <coal/free_list_strategy/segregated_fit.hpp>
+#include <coal/memory_block.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <free_list_mock.hpp>
+
+namespace coal::free_list_strategy {
+
+namespace {
+using strategy_t = segregated_fit<4, 16>;
+} // namespace
+
+TEST_CASE("segregated_fit bin_index", "[segregated_fit], [free_list_strategy]")
+{
+    STATIC_CHECK(strategy_t::bin_index(1) == 0);
+    STATIC_CHECK(strategy_t::bin_index(16) == 0);
+    STATIC_CHECK(strategy_t::bin_index(17) == 1);
+    STATIC_CHECK(strategy_t::bin_index(48) == 2);
+    STATIC_CHECK(strategy_t::bin_index(49) == 3);
+    STATIC_CHECK(strategy_t::bin_index(0x1000) == 3);
+}
+
+TEST_CASE("segregated_fit deallocate", "[segregated_fit], [free_list_strategy]")
+{
+    strategy_t strategy;
+    strategy_t::list_type list;
+    mock::free_list nodes;
+
+    CHECK_FALSE(list);
+
+    memory_block block = nodes.new_node_block(32);
+
+    CHECK(strategy.deallocate(list, block));
+    CHECK(list);
+    CHECK(list.bins[1] == block.as<free_list_node>());
+    CHECK(list.bins[1]->size == 32);
+    CHECK(list.non_empty_bins == 0b0010);
+
+    block = nodes.new_node_block(100);
+
+    CHECK(strategy.deallocate(list, block));
+    CHECK(list.bins[3] == block.as<free_list_node>());
+    CHECK(list.non_empty_bins == 0b1010);
+}
+
+TEST_CASE("segregated_fit allocate", "[segregated_fit], [free_list_strategy]")
+{
+    strategy_t strategy;
+    searched_free_list<strategy_t::list_type> list;
+    mock::free_list nodes;
+
+    for (const std::size_t size : {32, 32, 48, 80, 64, 100})
+    {
+        memory_block block = nodes.new_node_block(size);
+        strategy.deallocate(list, block);
+    }
+
+    SECTION("exact hit")
+    {
+        free_list_node* node = strategy.allocate(list, 32);
+
+        REQUIRE(node != nullptr);
+        CHECK(node->size == 32);
+        CHECK(node->next == nullptr);
+        CHECK(list.search_length == 1);
+        CHECK(list.non_empty_bins == 0b1110);
+
+        CHECK(strategy.allocate(list, 32)->size == 32);
+        CHECK(list.non_empty_bins == 0b1100);
+    }
+
+    SECTION("larger bin")
+    {
+        free_list_node* node = strategy.allocate(list, 16);
+
+        REQUIRE(node != nullptr);
+        CHECK(node->size == 32);
+        CHECK(list.search_length == 1);
+    }
+
+    SECTION("coarse bin")
+    {
+        free_list_node* node = strategy.allocate(list, 40);
+
+        REQUIRE(node != nullptr);
+        CHECK(node->size == 48);
+    }
+
+    SECTION("best fit in the last bin")
+    {
+        free_list_node* node = strategy.allocate(list, 70);
+
+        REQUIRE(node != nullptr);
+        CHECK(node->size == 80);
+        CHECK(list.search_length == 3);
+
+        node = strategy.allocate(list, 64);
+
+        REQUIRE(node != nullptr);
+        CHECK(node->size == 64);
+        CHECK(list.search_length == 2);
+    }
+
+    SECTION("miss")
+    {
+        CHECK(strategy.allocate(list, 128) == nullptr);
+        CHECK(list.search_length == 3);
+    }
+}
+
+TEST_CASE("segregated_fit limited_size", "[segregated_fit], [free_list_strategy]")
+{
+    limited_size<strategy_t, 1> strategy;
+    strategy_t::list_type list;
+    mock::free_list nodes;
+
+    STATIC_CHECK(std::is_same_v<details::free_list_type_t<decltype(strategy)>, strategy_t::list_type>);
+
+    memory_block block = nodes.new_node_block(32);
+    CHECK(strategy.deallocate(list, block));
+
+    block = nodes.new_node_block(32);
+    CHECK_FALSE(strategy.deallocate(list, block));
+
+    CHECK(strategy.allocate(list, 32) != nullptr);
+    CHECK(strategy.allocate(list, 32) == nullptr);
+}
+
+TEST_CASE("segregated_fit free_list_allocator", "[segregated_fit], [free_list_strategy]")
+{
+    free_list_allocator<stack_allocator<0x1000>, segregated_fit<8>> allocator;
+
+    memory_block small = allocator.allocate(24);
+    memory_block large = allocator.allocate(200);
+    void* small_ptr = small.ptr;
+    void* large_ptr = large.ptr;
+
+    allocator.deallocate(small);
+    allocator.deallocate(large);
+
+    const free_list_stats stats = allocator.get_free_list_stats();
+
+    CHECK(stats.node_count == 2);
+    CHECK(stats.cached_bytes == 224);
+    CHECK(stats.largest_node_size == 200);
+
+    memory_block block = allocator.allocate(180);
+    CHECK(block.ptr == large_ptr);
+
+    block = allocator.allocate(20);
+    CHECK(block.ptr == small_ptr);
+
+    CHECK(allocator.get_free_list_stats().node_count == 0);
+}
+
+} // namespace coal::free_list_strategy
@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/latency/latency_histogram.hpp>
+
+namespace coal {
+
+TEST_CASE("latency_histogram buckets", "[latency_histogram]")
+{
+    STATIC_CHECK(latency_histogram::get_bucket_index(0) == 0);
+    STATIC_CHECK(latency_histogram::get_bucket_index(31) == 31);
+    STATIC_CHECK(latency_histogram::get_bucket_index(32) == 32);
+    STATIC_CHECK(latency_histogram::get_bucket_index(33) == 32);
+    STATIC_CHECK(latency_histogram::get_bucket_index(34) == 33);
+    STATIC_CHECK(latency_histogram::get_bucket_index(64) == 48);
+    STATIC_CHECK(latency_histogram::get_bucket_index(~std::uint64_t{0}) == latency_histogram::bucket_count - 1);
+
+    for (std::uint64_t value : {0ull, 1ull, 31ull, 32ull, 47ull, 1000ull, 123'456ull, 987'654'321ull, 1ull << 39})
+    {
+        INFO("value " << value);
+
+        const std::size_t index = latency_histogram::get_bucket_index(value);
+
+        CHECK(latency_histogram::get_bucket_lower_bound(index) <= value);
+        CHECK(latency_histogram::get_bucket_upper_bound(index) >= value);
+
+        // relative error of a bucket stays under 1/16
+        CHECK(latency_histogram::get_bucket_upper_bound(index) - latency_histogram::get_bucket_lower_bound(index) <= value / 16);
+    }
+}
+
+TEST_CASE("latency_histogram percentiles", "[latency_histogram]")
+{
+    latency_histogram histogram;
+
+    CHECK(histogram.get_value_at_percentile(50.0) == 0);
+
+    for (std::uint64_t i = 1; i <= 1000; ++i)
+    {
+        histogram.record(i);
+    }
+
+    CHECK(histogram.get_count() == 1000);
+    CHECK(histogram.get_min() == 1);
+    CHECK(histogram.get_max() == 1000);
+
+    const std::uint64_t p50 = histogram.get_value_at_percentile(50.0);
+    const std::uint64_t p99 = histogram.get_value_at_percentile(99.0);
+
+    CHECK(p50 >= 500);
+    CHECK(p50 <= 500 + 500 / 16);
+    CHECK(p99 >= 990);
+    CHECK(p99 <= 1000);
+    CHECK(histogram.get_value_at_percentile(100.0) == 1000);
+
+    latency_histogram other;
+    other.record(1'000'000);
+    histogram.merge(other);
+
+    CHECK(histogram.get_count() == 1001);
+    CHECK(histogram.get_max() == 1'000'000);
+    CHECK(histogram.get_value_at_percentile(100.0) == 1'000'000);
+
+    histogram.reset();
+
+    CHECK(histogram.get_count() == 0);
+    CHECK(histogram.get_max() == 0);
+}
+
+} // namespace coal
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/latency/latency_report.hpp>
+#include <coal/latency_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/segregator_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+namespace {
+
+// every read advances by the same step, each call lasts exactly one step
+struct step_clock
+{
+    static std::uint64_t now()
+    {
+        return value += step;
+    }
+
+    static double get_ns_per_tick()
+    {
+        return 2.0;
+    }
+
+    inline static std::uint64_t step{10};
+    inline static std::uint64_t value{0};
+};
+
+} // namespace
+
+TEST_CASE_METHOD(basic_allocator_fixture<latency_allocator<stack_allocator<0x1000>>>, "latency_allocator basics", "[latency_allocator], [allocator]")
+{
+    this->test_basics();
+}
+
+TEST_CASE("latency_allocator records each operation", "[latency_allocator], [allocator]")
+{
+    latency_allocator<stack_allocator<0x1000>, step_clock> allocator;
+
+    memory_block block = allocator.allocate(16);
+    CHECK(allocator.expand(block, 16));
+    CHECK(allocator.reallocate(block, 64));
+    allocator.deallocate(block);
+
+    for (latency_operation operation : {latency_operation::allocate, latency_operation::deallocate, latency_operation::reallocate, latency_operation::expand})
+    {
+        const latency_histogram& histogram = allocator.get_histogram(operation);
+
+        CHECK(histogram.get_count() == 1);
+        CHECK(histogram.get_max() == step_clock::step);
+    }
+
+    allocator.reset_histograms();
+
+    CHECK(allocator.get_histogram(latency_operation::allocate).get_count() == 0);
+}
+
+TEST_CASE("latency_allocator reports every layer of a composite", "[latency_allocator], [allocator]")
+{
+    using small_t = latency_allocator<stack_allocator<0x1000>, step_clock>;
+    using large_t = latency_allocator<malloc_allocator, step_clock>;
+    using allocator_t = latency_allocator<segregator_allocator<small_t, large_t, 64>, step_clock>;
+
+    allocator_t allocator;
+    allocator.set_name("segregator");
+    allocator.get_allocator().get_small_allocator().set_name("stack");
+    allocator.get_allocator().get_large_allocator().set_name("malloc");
+
+    memory_block small_block = allocator.allocate(32);
+    memory_block large_block = allocator.allocate(128);
+
+    allocator.deallocate(large_block);
+    allocator.deallocate(small_block);
+
+    const std::vector<latency_summary> summaries = collect_latencies(allocator);
+
+    REQUIRE(summaries.size() == 3);
+
+    CHECK(std::string_view{summaries[0].name} == "stack");
+    CHECK(std::string_view{summaries[1].name} == "malloc");
+    CHECK(std::string_view{summaries[2].name} == "segregator");
+
+    const latency_percentiles& stack = summaries[0].get_percentiles(latency_operation::allocate);
+
+    CHECK(stack.count == 1);
+    CHECK(stack.p50_ns == static_cast<double>(step_clock::step) * 2.0);
+    CHECK(stack.max_ns == static_cast<double>(step_clock::step) * 2.0);
+
+    // the outer layer includes the two clock reads of the inner layer
+    const latency_percentiles& segregator = summaries[2].get_percentiles(latency_operation::allocate);
+
+    CHECK(segregator.count == 2);
+    CHECK(segregator.max_ns == static_cast<double>(step_clock::step) * 3.0 * 2.0);
+
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    print_latency_report(file, summaries);
+    CHECK(std::ftell(file) > 0);
+
+    std::fclose(file);
+}
+
+} // namespace coal
@@ -0,0 +1,134 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/lock_policy/adaptive_lock.hpp>
+#include <coal/lock_policy/mutex.hpp>
+#include <coal/lock_policy/ticket_lock.hpp>
+#include <coal/lock_policy/ttas_spinlock.hpp>
+
+namespace coal::lock_policy {
+
+TEMPLATE_TEST_CASE("lock_policy try_lock fails while locked", "[lock_policy]", mutex, ttas_spinlock<>, ticket_lock<>, adaptive_lock<>)
+{
+    TestType lock;
+
+    const lock_contention contention = lock.lock();
+
+    CHECK_FALSE(contention.contended());
+    CHECK_FALSE(lock.try_lock());
+
+    lock.unlock();
+
+    REQUIRE(lock.try_lock());
+    lock.unlock();
+}
+
+TEMPLATE_TEST_CASE("lock_policy excludes other threads", "[lock_policy]", mutex, ttas_spinlock<>, ticket_lock<>, adaptive_lock<>, adaptive_lock<0>)
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iteration_count = 20000;
+
+    TestType lock;
+
+    // updated with separate loads and stores, an overlap of two critical sections loses increments
+    std::atomic<std::size_t> counter{0};
+    std::atomic<std::size_t> contended_count{0};
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&]() {
+            for (std::size_t j = 0; j < iteration_count; ++j)
+            {
+                const lock_contention contention = lock.lock();
+
+                counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+                lock.unlock();
+
+                if (contention.contended())
+                {
+                    contended_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(counter == thread_count * iteration_count);
+    CHECK(contended_count <= thread_count * iteration_count);
+}
+
+TEST_CASE("lock_policy reports how a contended lock was waited for", "[lock_policy]")
+{
+    const auto contend = []<typename LockT>(LockT& lock) {
+        lock.lock();
+
+        lock_contention contention;
+        std::atomic<bool> started{false};
+
+        std::thread thread{[&]() {
+            started = true;
+            contention = lock.lock();
+            lock.unlock();
+        }};
+
+        while (!started)
+        {
+        }
+
+        // leaves the thread time to find the lock taken
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+        lock.unlock();
+        thread.join();
+
+        return contention;
+    };
+
+    SECTION("mutex waits")
+    {
+        mutex lock;
+        const lock_contention contention = contend(lock);
+
+        CHECK(contention.waited);
+        CHECK(contention.spins == 0);
+    }
+
+    SECTION("ttas_spinlock spins")
+    {
+        ttas_spinlock<> lock;
+        const lock_contention contention = contend(lock);
+
+        CHECK_FALSE(contention.waited);
+        CHECK(contention.spins > 0);
+    }
+
+    SECTION("ticket_lock spins")
+    {
+        ticket_lock<> lock;
+        const lock_contention contention = contend(lock);
+
+        CHECK_FALSE(contention.waited);
+        CHECK(contention.spins > 0);
+    }
+
+    SECTION("adaptive_lock spins then waits")
+    {
+        adaptive_lock<16> lock;
+        const lock_contention contention = contend(lock);
+
+        CHECK(contention.waited);
+        CHECK(contention.spins == 16);
+    }
+}
+
+} // namespace coal::lock_policy
@@ -0,0 +1,130 @@
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/lock_policy/adaptive_lock.hpp>
+#include <coal/lock_policy/ticket_lock.hpp>
+#include <coal/lock_policy/ttas_spinlock.hpp>
+#include <coal/locked_allocator.hpp>
+#include <coal/proxy_allocator.hpp>
+#include <coal/segregator_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using locked_basic_allocators = std::tuple<
+    locked_allocator<stack_allocator<0x1000, 8>>,
+    locked_allocator<stack_allocator<0x1000, 16>, lock_policy::ttas_spinlock<>>,
+    locked_allocator<stack_allocator<0x1000, 16>, lock_policy::ticket_lock<>>,
+    locked_allocator<stack_allocator<0x1000, 16>, lock_policy::adaptive_lock<>>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "locked_allocator basics", "[locked_allocator], [allocator]", locked_basic_allocators)
+{
+    this->test_basics();
+}
+
+TEST_CASE("locked_allocator counts acquisitions", "[locked_allocator], [allocator]")
+{
+    locked_allocator<stack_allocator<0x1000>, lock_policy::ttas_spinlock<>> allocator;
+
+    memory_block block = allocator.allocate(16);
+
+    CHECK(allocator.owns(block));
+    CHECK(allocator.expand(block, 16));
+    CHECK(allocator.reallocate(block, 64));
+
+    allocator.deallocate(block);
+    allocator.deallocate_all();
+
+    lock_stats stats = allocator.get_lock_stats();
+
+    CHECK(stats.acquisitions == 6);
+    CHECK(stats.contended_acquisitions == 0);
+    CHECK(stats.spins == 0);
+    CHECK(stats.waits == 0);
+
+    allocator.reset_lock_stats();
+
+    stats = allocator.get_lock_stats();
+
+    CHECK(stats.acquisitions == 0);
+}
+
+TEMPLATE_TEST_CASE("locked_allocator shared between threads", "[locked_allocator], [allocator]", lock_policy::mutex, lock_policy::ttas_spinlock<>, lock_policy::ticket_lock<>, lock_policy::adaptive_lock<>)
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iteration_count = 2000;
+    constexpr std::size_t live_count = 16;
+
+    // only the large side is shared, each thread has its own small side
+    using shared = locked_allocator<free_list_allocator<stack_allocator<0x10000, 16>, free_list_strategy::first_fit>, TestType>;
+
+    shared allocator;
+
+    std::atomic<std::size_t> failure_count{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            segregator_allocator<free_list_allocator<stack_allocator<0x1000>, free_list_strategy::first_fit>, proxy_allocator<shared>, 64> local;
+            local.get_large_allocator().set_allocator(&allocator);
+
+            std::vector<memory_block> blocks(live_count);
+
+            for (std::size_t j = 0; j < iteration_count; ++j)
+            {
+                memory_block& block = blocks[(j * 7) % live_count];
+
+                if (block)
+                {
+                    if (block.as<std::uint8_t>()[block.size - 1] != static_cast<std::uint8_t>(i))
+                    {
+                        ++failure_count;
+                    }
+
+                    local.deallocate(block);
+                }
+
+                block = local.allocate(j % 2 ? 32 : 128);
+
+                if (!block)
+                {
+                    ++failure_count;
+                    continue;
+                }
+
+                std::memset(block.ptr, static_cast<int>(i), block.size);
+            }
+
+            for (memory_block& block : blocks)
+            {
+                local.deallocate(block);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(failure_count == 0);
+
+    const lock_stats stats = allocator.get_lock_stats();
+
+    // one allocation and one deallocation of 128 bytes every other iteration
+    CHECK(stats.acquisitions == thread_count * iteration_count);
+    CHECK(stats.contended_acquisitions <= stats.acquisitions);
+    CHECK(stats.waits <= stats.contended_acquisitions);
+}
+
+} // namespace coal
@@ -0,0 +1,250 @@
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <coal/mmap_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using mmap_basic_allocators = std::tuple<
+    mmap_allocator<>,
+    mmap_allocator<mmap_options::populate>,
+    mmap_allocator<mmap_options::transparent_huge_pages>,
+    mmap_allocator<mmap_options::huge_tlb>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "mmap_allocator basics", "[mmap_allocator], [allocator]", mmap_basic_allocators)
+{
+    // growing in place depends on the pages following the mapping being free
+    this->small_expand = false;
+    this->large_expand = false;
+
+    this->test_basics();
+}
+
+TEMPLATE_LIST_TEST_CASE("mmap_allocator allocate page aligned", "[mmap_allocator], [allocator]", mmap_basic_allocators)
+{
+    TestType allocator;
+
+    std::size_t size = GENERATE(1, 0x1000, 0x1001, 0x200000, 0x300000);
+
+    memory_block block = allocator.allocate(size);
+
+    REQUIRE(block);
+    CHECK(block.size == size);
+    CHECK(reinterpret_cast<std::uintptr_t>(block.ptr) % TestType::get_page_size() == 0);
+    CHECK(allocator.get_mapping_count() == 1);
+    CHECK(allocator.get_mapped_bytes() >= align_up(size, TestType::get_page_size()));
+
+    // every byte of the mapping is writable
+    std::memset(block.ptr, 0xA5, block.size);
+
+    allocator.deallocate(block);
+
+    CHECK(block == nullblk);
+    CHECK(allocator.get_mapping_count() == 0);
+    CHECK(allocator.get_mapped_bytes() == 0);
+}
+
+TEST_CASE("mmap_allocator granted size", "[mmap_allocator], [allocator]")
+{
+    const std::size_t page_size = mmap_allocator<>::get_page_size();
+
+    SECTION("whole pages")
+    {
+        mmap_allocator<> allocator;
+
+        std::size_t size = GENERATE(1, 0x1000, 0x1001, 0x200000);
+
+        CHECK(allocator.granted_size(size) == align_up(size, page_size));
+
+        memory_block block = allocator.allocate(size);
+
+        REQUIRE(block);
+        CHECK(allocator.get_mapped_bytes() == allocator.granted_size(size));
+
+        allocator.deallocate(block);
+    }
+
+#if defined(MAP_HUGETLB)
+    SECTION("whole huge pages with huge_tlb")
+    {
+        mmap_allocator<mmap_options::huge_tlb> allocator;
+
+        CHECK(allocator.granted_size(1) == mmap_allocator<mmap_options::huge_tlb>::huge_page_size);
+        CHECK(allocator.granted_size(0x200001) == 2 * mmap_allocator<mmap_options::huge_tlb>::huge_page_size);
+    }
+#endif
+}
+
+TEST_CASE("mmap_allocator transparent huge pages align large mappings", "[mmap_allocator], [allocator]")
+{
+    mmap_allocator<mmap_options::transparent_huge_pages> allocator;
+
+    memory_block block = allocator.allocate(0x200000);
+
+    REQUIRE(block);
+    CHECK(reinterpret_cast<std::uintptr_t>(block.ptr) % decltype(allocator)::huge_page_size == 0);
+    CHECK(allocator.get_mapped_bytes() == 0x200000);
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("mmap_allocator owns", "[mmap_allocator], [allocator]")
+{
+    mmap_allocator<> allocator;
+    const std::size_t page_size = mmap_allocator<>::get_page_size();
+
+    memory_block block = allocator.allocate(page_size * 2);
+    REQUIRE(block);
+
+    SECTION("owns the block")
+    {
+        CHECK(allocator.owns(block));
+    }
+
+    SECTION("owns a range inside the mapping")
+    {
+        CHECK(allocator.owns({block.as<std::uint8_t>() + page_size, page_size}));
+    }
+
+    SECTION("does not own a range past the mapping")
+    {
+        CHECK_FALSE(allocator.owns({block.as<std::uint8_t>() + page_size, page_size + 1}));
+        CHECK_FALSE(allocator.owns({block.as<std::uint8_t>() + page_size * 2, 1}));
+    }
+
+    SECTION("does not own memory it did not map")
+    {
+        static std::uint8_t foreign[16];
+
+        CHECK_FALSE(allocator.owns({foreign, sizeof(foreign)}));
+        CHECK_FALSE(allocator.owns(nullblk));
+    }
+
+    SECTION("does not own a deallocated block")
+    {
+        const memory_block copy = block;
+        allocator.deallocate(block);
+
+        CHECK_FALSE(allocator.owns(copy));
+    }
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("mmap_allocator owns with several mappings", "[mmap_allocator], [allocator]")
+{
+    mmap_allocator<> allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 600; ++i)
+    {
+        blocks.push_back(allocator.allocate(1 + i * 13));
+        REQUIRE(blocks.back());
+    }
+
+    CHECK(allocator.get_mapping_count() == blocks.size());
+
+    for (std::size_t i = 0; i < blocks.size(); i += 2)
+    {
+        allocator.deallocate(blocks[i]);
+    }
+
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        INFO("block #" << i);
+        CHECK(allocator.owns(blocks[i]) == (i % 2 == 1));
+    }
+
+    CHECK(allocator.get_mapping_count() == blocks.size() / 2);
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.get_mapping_count() == 0);
+}
+
+TEST_CASE("mmap_allocator reallocate keeps the content", "[mmap_allocator], [allocator]")
+{
+    mmap_allocator<> allocator;
+    const std::size_t page_size = mmap_allocator<>::get_page_size();
+
+    memory_block block = allocator.allocate(page_size);
+    REQUIRE(block);
+
+    std::memset(block.ptr, 0x5A, block.size);
+
+    // a neighbour mapping may force the pages to move
+    memory_block neighbour = allocator.allocate(page_size);
+
+    SECTION("grow")
+    {
+        REQUIRE(allocator.reallocate(block, page_size * 64));
+
+        CHECK(block.size == page_size * 64);
+        CHECK(allocator.owns(block));
+        CHECK(allocator.get_mapping_count() == 2);
+
+        for (std::size_t i = 0; i < page_size; ++i)
+        {
+            REQUIRE(block.as<std::uint8_t>()[i] == 0x5A);
+        }
+
+        // the new pages are writable
+        std::memset(block.as<std::uint8_t>() + page_size, 0, page_size * 63);
+    }
+
+    SECTION("shrink gives the tail pages back")
+    {
+        REQUIRE(allocator.reallocate(block, page_size * 64));
+        const std::size_t mapped_bytes = allocator.get_mapped_bytes();
+
+        REQUIRE(allocator.reallocate(block, page_size));
+
+        CHECK(block.size == page_size);
+        CHECK(allocator.get_mapped_bytes() == mapped_bytes - page_size * 63);
+        CHECK(block.as<std::uint8_t>()[page_size - 1] == 0x5A);
+    }
+
+    allocator.deallocate(neighbour);
+    allocator.deallocate(block);
+}
+
+TEST_CASE("mmap_allocator expand within the last page", "[mmap_allocator], [allocator]")
+{
+    mmap_allocator<> allocator;
+    const std::size_t page_size = mmap_allocator<>::get_page_size();
+
+    memory_block block = allocator.allocate(1);
+    REQUIRE(block);
+
+    CHECK(allocator.expand(block, page_size - 1));
+    CHECK(block.size == page_size);
+    CHECK(allocator.get_mapped_bytes() == page_size);
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("mmap_allocator deallocate a block it does not own", "[mmap_allocator], [allocator]")
+{
+    mmap_allocator<> allocator;
+
+    memory_block owned = allocator.allocate(1);
+    REQUIRE(owned);
+
+    static std::uint8_t foreign_storage[16];
+    memory_block foreign{foreign_storage, sizeof(foreign_storage)};
+
+    allocator.deallocate(foreign);
+
+    CHECK(foreign == nullblk);
+    CHECK(allocator.get_mapping_count() == 1);
+
+    allocator.deallocate(owned);
+}
+
+} // namespace coal
@@ -0,0 +1,190 @@
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/per_cpu_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using per_cpu_basic_allocators = std::tuple<
+    per_cpu_allocator<stack_allocator<0x10000, 8>>,
+    per_cpu_allocator<stack_allocator<0x10000, 16>>,
+    per_cpu_allocator<free_list_allocator<stack_allocator<0x10000, 16>, free_list_strategy::first_fit>>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "per_cpu_allocator basics", "[per_cpu_allocator], [allocator]", per_cpu_basic_allocators)
+{
+    this->test_basics();
+}
+
+TEST_CASE("per_cpu_allocator has a shard per cpu", "[per_cpu_allocator], [allocator]")
+{
+    per_cpu_allocator<stack_allocator<0x100, 16>> allocator;
+
+    CHECK(allocator.get_shard_count() >= 1);
+    CHECK(allocator.get_current_shard() < allocator.get_shard_count());
+}
+
+TEST_CASE("per_cpu_allocator routes a block back to its shard", "[per_cpu_allocator], [allocator]")
+{
+    per_cpu_allocator<stack_allocator<0x100, 16>> allocator{4};
+
+    REQUIRE(allocator.get_shard_count() == 4);
+
+    for (std::size_t shard = 0; shard < allocator.get_shard_count(); ++shard)
+    {
+        INFO("shard " << shard);
+
+        // a block of another cpu, as if the thread migrated since the allocation
+        memory_block block = allocator.get_allocator(shard).allocate(0x40);
+        void* ptr = block.ptr;
+
+        REQUIRE(block);
+        CHECK(allocator.owns(block));
+
+        allocator.deallocate(block);
+
+        CHECK(block == nullblk);
+
+        // the stack of the shard got its last block back
+        memory_block again = allocator.get_allocator(shard).allocate(0x40);
+        CHECK(again.ptr == ptr);
+
+        allocator.get_allocator(shard).deallocate(again);
+    }
+
+    stack_allocator<0x100, 16> other;
+    memory_block block = other.allocate(0x10);
+
+    CHECK_FALSE(allocator.owns(block));
+    CHECK_FALSE(allocator.owns(nullblk));
+}
+
+TEST_CASE("per_cpu_allocator falls back to the other shards", "[per_cpu_allocator], [allocator]")
+{
+    per_cpu_allocator<stack_allocator<0x100, 16>> allocator{2};
+
+    memory_block first = allocator.allocate(0x100);
+    memory_block second = allocator.allocate(0x100);
+
+    REQUIRE(first);
+    REQUIRE(second);
+    CHECK(allocator.allocate(0x10) == nullblk);
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.allocate(0x100));
+    CHECK(allocator.allocate(0x100));
+}
+
+TEST_CASE("per_cpu_allocator reallocate moves to a shard with room", "[per_cpu_allocator], [allocator]")
+{
+    per_cpu_allocator<stack_allocator<0x100, 16>> allocator{2};
+
+    memory_block block = allocator.get_allocator(0).allocate(0x80);
+    memory_block filler = allocator.get_allocator(0).allocate(0x80);
+
+    REQUIRE(block);
+    REQUIRE(filler);
+
+    std::memset(block.ptr, 0x5A, block.size);
+
+    REQUIRE(allocator.reallocate(block, 0xC0));
+
+    CHECK(block.size == 0xC0);
+    CHECK(allocator.get_allocator(1).owns(block));
+
+    for (std::size_t i = 0; i < 0x80; ++i)
+    {
+        CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+    }
+}
+
+TEST_CASE("per_cpu_allocator shared between threads", "[per_cpu_allocator], [allocator]")
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iteration_count = 2000;
+    constexpr std::size_t live_count = 32;
+
+    per_cpu_allocator<free_list_allocator<stack_allocator<0x10000, 16>, free_list_strategy::first_fit>> allocator{thread_count};
+
+    std::atomic<std::size_t> failure_count{0};
+
+    // each thread frees the blocks of the previous one, most frees cross shards
+    std::vector<std::vector<memory_block>> handoffs(thread_count, std::vector<memory_block>(live_count));
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            std::vector<memory_block> blocks(live_count);
+
+            for (std::size_t j = 0; j < iteration_count; ++j)
+            {
+                memory_block& block = blocks[(j * 7) % live_count];
+
+                if (block)
+                {
+                    if (block.as<std::uint8_t>()[0] != static_cast<std::uint8_t>(i))
+                    {
+                        ++failure_count;
+                    }
+
+                    allocator.deallocate(block);
+                }
+
+                block = allocator.allocate(64);
+
+                if (!block)
+                {
+                    ++failure_count;
+                    continue;
+                }
+
+                std::memset(block.ptr, static_cast<int>(i), block.size);
+            }
+
+            handoffs[i] = blocks;
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    threads.clear();
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            for (memory_block& block : handoffs[(i + 1) % thread_count])
+            {
+                allocator.deallocate(block);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(failure_count == 0);
+
+    // every block went back to its shard, each of them is free again
+    for (std::size_t shard = 0; shard < allocator.get_shard_count(); ++shard)
+    {
+        CHECK(allocator.get_allocator(shard).allocate(0x1000));
+    }
+}
+
+} // namespace coal
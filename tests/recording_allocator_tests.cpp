@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/recording_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/trace/trace_replayer.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+TEST_CASE_METHOD(basic_allocator_fixture<recording_allocator<stack_allocator<0x1000>>>, "recording_allocator basics", "[recording_allocator], [allocator]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    {
+        trace_recorder recorder{file};
+        allocator.set_recorder(&recorder);
+
+        this->test_basics();
+
+        allocator.set_recorder(nullptr);
+    }
+
+    std::fclose(file);
+}
+
+TEST_CASE("recording_allocator records every operation", "[recording_allocator], [allocator]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    recording_allocator<stack_allocator<0x1000>> allocator;
+
+    {
+        trace_recorder recorder{file};
+        REQUIRE(recorder.is_valid());
+
+        allocator.set_recorder(&recorder);
+
+        memory_block block0 = allocator.allocate(16);
+        memory_block block1 = allocator.allocate(8);
+
+        CHECK(recorder.get_live_count() == 2);
+
+        CHECK(allocator.expand(block1, 8));
+        CHECK(allocator.reallocate(block0, 64));
+
+        allocator.deallocate(block1);
+        allocator.deallocate(block0);
+
+        CHECK(recorder.get_live_count() == 0);
+
+        allocator.deallocate_all();
+
+        CHECK(recorder.get_event_count() == 7);
+    }
+
+    std::rewind(file);
+
+    std::vector<trace_event> events;
+    REQUIRE(read_trace(file, events));
+    REQUIRE(events.size() == 7);
+
+    CHECK(events[0].type == trace_event_type::allocate);
+    CHECK(events[0].object_id == 0);
+    CHECK(events[0].size == 16);
+
+    CHECK(events[1].type == trace_event_type::allocate);
+    CHECK(events[1].object_id == 1);
+    CHECK(events[1].size == 8);
+
+    CHECK(events[2].type == trace_event_type::expand);
+    CHECK(events[2].object_id == 1);
+    CHECK(events[2].size == 8);
+    CHECK(events[2].argument == 8);
+    CHECK(events[2].success);
+
+    CHECK(events[3].type == trace_event_type::reallocate);
+    CHECK(events[3].object_id == 0);
+    CHECK(events[3].size == 16);
+    CHECK(events[3].argument == 64);
+
+    CHECK(events[4].type == trace_event_type::deallocate);
+    CHECK(events[4].object_id == 1);
+
+    CHECK(events[5].type == trace_event_type::deallocate);
+    CHECK(events[5].object_id == 0);
+
+    CHECK(events[6].type == trace_event_type::deallocate_all);
+
+    std::fclose(file);
+}
+
+TEST_CASE("recording_allocator records failed allocation", "[recording_allocator], [allocator]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    recording_allocator<stack_allocator<0x100>> allocator;
+
+    {
+        trace_recorder recorder{file};
+        allocator.set_recorder(&recorder);
+
+        memory_block block = allocator.allocate(0x200);
+        CHECK(block == nullblk);
+        CHECK(recorder.get_live_count() == 0);
+    }
+
+    std::rewind(file);
+
+    std::vector<trace_event> events;
+    REQUIRE(read_trace(file, events));
+    REQUIRE(events.size() == 1);
+
+    CHECK(events[0].type == trace_event_type::allocate);
+    CHECK_FALSE(events[0].success);
+    CHECK(events[0].size == 0x200);
+
+    std::fclose(file);
+}
+
+} // namespace coal
@@ -0,0 +1,231 @@
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/malloc_allocator.hpp>
+#include <coal/region_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+#include <allocator_mock.hpp>
+
+namespace coal {
+
+using region_basic_allocators = std::tuple<
+    region_allocator<malloc_allocator, 0x1000>,
+    region_allocator<malloc_allocator, 0x400, 0x1000>,
+    region_allocator<stack_allocator<0x10000, 16>, 0x800>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "region_allocator basics", "[region_allocator], [allocator]", region_basic_allocators)
+{
+    this->test_basics();
+}
+
+struct region_tag
+{};
+
+using mock_region_parent = mock::basic_minimal_allocator<region_tag>;
+using mock_region = region_allocator<mock_region_parent, 0x100>;
+
+struct region_allocator_fixture : allocator_fixture<mock_region>
+{
+    struct mock_initializer
+    {
+        void init([[maybe_unused]] mock_region& root)
+        {
+            ++init_count;
+        }
+
+        void init([[maybe_unused]] mock_region_parent& a)
+        {
+            CHECK(init_count == 0);
+        }
+
+        std::size_t init_count{0};
+    };
+
+    region_allocator_fixture()
+    {
+        mock_region_parent::reset_mock();
+    }
+};
+
+TEST_CASE_METHOD(region_allocator_fixture, "region_allocator init", "[region_allocator], [allocator]")
+{
+    mock_initializer initializer;
+    allocator.init(initializer);
+
+    CHECK(initializer.init_count == 1);
+    CHECK(mock_region_parent::init_count == 1);
+}
+
+TEST_CASE_METHOD(region_allocator_fixture, "region_allocator allocate nullblk when the parent is out of memory", "[region_allocator], [allocator]")
+{
+    mock_region_parent::will_allocate = false;
+
+    CHECK(allocator.allocate(8) == nullblk);
+    CHECK(allocator.get_chunk_count() == 0);
+}
+
+TEST_CASE_METHOD(region_allocator_fixture, "region_allocator bumps within a chunk", "[region_allocator], [allocator]")
+{
+    alignas(16) static std::uint8_t chunk[0x100];
+    mock_region_parent::allocate_block = {chunk, sizeof(chunk)};
+
+    memory_block block1 = allocator.allocate(1);
+    memory_block block2 = allocator.allocate(8);
+
+    REQUIRE(block1);
+    REQUIRE(block2);
+
+    CHECK(block1.ptr > static_cast<void*>(chunk));
+    CHECK(block2.as<std::uint8_t>() == block1.as<std::uint8_t>() + align_up(block1.size, mock_region::alignment));
+    CHECK(block2.as<std::uint8_t>() == block1.as<std::uint8_t>() + allocator.granted_size(block1.size));
+    CHECK(mock_region_parent::allocate_count == 1);
+    CHECK(allocator.get_chunk_count() == 1);
+
+    allocator.deallocate_all();
+
+    CHECK(mock_region_parent::deallocate_count == 1);
+    CHECK(allocator.get_chunk_count() == 0);
+}
+
+TEST_CASE("region_allocator links chunks with geometric growth", "[region_allocator], [allocator]")
+{
+    using parent_t = stats_allocator<malloc_allocator, stats_options::calls | stats_options::bytes | stats_options::live_bytes, 1>;
+
+    region_allocator<parent_t, 0x100, 0x400> allocator;
+
+    // each allocation fills most of a chunk, so every one of them links a new chunk
+    const std::size_t sizes[] = {0xC0, 0x180, 0x300, 0x300, 0x300};
+
+    for (std::size_t size : sizes)
+    {
+        REQUIRE(allocator.allocate(size));
+    }
+
+    const allocator_stats stats = allocator.get_allocator().get_stats();
+
+    CHECK(allocator.get_chunk_count() == 5);
+    CHECK(stats.get_calls(stats_operation::allocate) == 5);
+    CHECK(stats.bytes_requested == 0x100 + 0x200 + 0x400 + 0x400 + 0x400);
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.get_chunk_count() == 0);
+    CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+}
+
+TEST_CASE("region_allocator allocate larger than a chunk", "[region_allocator], [allocator]")
+{
+    region_allocator<malloc_allocator, 0x100> allocator;
+
+    memory_block small = allocator.allocate(8);
+    memory_block large = allocator.allocate(0x1000);
+
+    REQUIRE(small);
+    REQUIRE(large);
+
+    CHECK(large.size == 0x1000);
+    CHECK(allocator.get_chunk_count() == 2);
+    CHECK(allocator.owns(small));
+    CHECK(allocator.owns(large));
+
+    std::memset(large.ptr, 0, large.size);
+}
+
+TEST_CASE("region_allocator owns", "[region_allocator], [allocator]")
+{
+    region_allocator<malloc_allocator, 0x100> allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 64; ++i)
+    {
+        blocks.push_back(allocator.allocate(24));
+        REQUIRE(blocks.back());
+    }
+
+    CHECK(allocator.get_chunk_count() > 1);
+
+    for (const memory_block& block : blocks)
+    {
+        CHECK(allocator.owns(block));
+    }
+
+    static std::uint8_t foreign[16];
+
+    CHECK_FALSE(allocator.owns({foreign, sizeof(foreign)}));
+    CHECK_FALSE(allocator.owns(nullblk));
+}
+
+TEST_CASE("region_allocator expand the last block", "[region_allocator], [allocator]")
+{
+    region_allocator<malloc_allocator, 0x100> allocator;
+
+    memory_block first = allocator.allocate(8);
+    memory_block last = allocator.allocate(8);
+
+    SECTION("expand the last block in place")
+    {
+        void* ptr = last.ptr;
+
+        CHECK(allocator.expand(last, 64));
+        CHECK(last.ptr == ptr);
+        CHECK(last.size == 72);
+
+        // the next allocation follows the expanded block
+        memory_block next = allocator.allocate(8);
+        CHECK(next.as<std::uint8_t>() == last.as<std::uint8_t>() + 72);
+    }
+
+    SECTION("expand a block which is not the last fails")
+    {
+        CHECK_FALSE(allocator.expand(first, 8));
+        CHECK(first.size == 8);
+    }
+
+    SECTION("expand past the chunk fails")
+    {
+        CHECK_FALSE(allocator.expand(last, 0x100));
+        CHECK(last.size == 8);
+    }
+}
+
+TEST_CASE("region_allocator deallocate the last block rewinds", "[region_allocator], [allocator]")
+{
+    region_allocator<malloc_allocator, 0x100> allocator;
+
+    [[maybe_unused]] memory_block first = allocator.allocate(8);
+    memory_block last = allocator.allocate(8);
+    void* ptr = last.ptr;
+
+    allocator.deallocate(last);
+
+    CHECK(last == nullblk);
+    CHECK(allocator.allocate(16).ptr == ptr);
+}
+
+TEST_CASE("region_allocator reallocate keeps the content", "[region_allocator], [allocator]")
+{
+    region_allocator<malloc_allocator, 0x100> allocator;
+
+    memory_block block = allocator.allocate(16);
+    std::memset(block.ptr, 0x5A, block.size);
+
+    [[maybe_unused]] memory_block other = allocator.allocate(8);
+
+    REQUIRE(allocator.reallocate(block, 0x200));
+
+    CHECK(block.size == 0x200);
+    CHECK(allocator.owns(block));
+
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+        CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+    }
+}
+
+} // namespace coal
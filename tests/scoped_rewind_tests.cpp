@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/affix_allocator.hpp>
+#include <coal/fallback_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/scoped_rewind.hpp>
+#include <coal/stack_allocator.hpp>
+
+namespace coal {
+
+TEST_CASE("scoped_rewind rewinds at the end of the scope", "[scoped_rewind]")
+{
+    stack_allocator<0x1000> allocator;
+
+    memory_block kept = allocator.allocate(8);
+    void* scope_ptr = nullptr;
+
+    {
+        scoped_rewind rewind{allocator};
+
+        scope_ptr = allocator.allocate(8).ptr;
+        [[maybe_unused]] memory_block other = allocator.allocate(64);
+
+        CHECK(rewind.get_marker().ptr == scope_ptr);
+    }
+
+    CHECK(allocator.allocate(8).ptr == scope_ptr);
+    CHECK(allocator.owns(kept));
+}
+
+TEST_CASE("scoped_rewind nested scopes", "[scoped_rewind]")
+{
+    stack_allocator<0x1000> allocator;
+
+    void* outer_ptr = nullptr;
+    void* inner_ptr = nullptr;
+
+    {
+        scoped_rewind outer{allocator};
+        outer_ptr = allocator.allocate(8).ptr;
+
+        {
+            scoped_rewind inner{allocator};
+            inner_ptr = allocator.allocate(8).ptr;
+        }
+
+        CHECK(allocator.allocate(8).ptr == inner_ptr);
+    }
+
+    CHECK(allocator.allocate(8).ptr == outer_ptr);
+}
+
+TEST_CASE("scoped_rewind over a composite", "[scoped_rewind]")
+{
+    using allocator_t = affix_allocator<fallback_allocator<stack_allocator<0x100>, malloc_allocator>, std::uint64_t>;
+
+    allocator_t allocator;
+    void* scope_ptr = nullptr;
+
+    {
+        scoped_rewind rewind{allocator};
+
+        scope_ptr = allocator.allocate(8).ptr;
+        [[maybe_unused]] memory_block other = allocator.allocate(64);
+    }
+
+    CHECK(allocator.allocate(8).ptr == scope_ptr);
+}
+
+} // namespace coal
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sizeclass/size_class_search.hpp>
+
+namespace coal::tools {
+
+namespace {
+
+size_profile make_profile(const std::vector<std::pair<std::size_t, std::uint64_t>>& counts)
+{
+    size_profile profile;
+
+    for (const auto& [size, count] : counts)
+    {
+        profile.add(size, count, 0);
+    }
+
+    return profile;
+}
+
+} // namespace
+
+TEST_CASE("small_size_table", "[size_class_search], [sizeclass]")
+{
+    const size_profile profile = make_profile({{1, 2}, {5, 3}, {12, 1}, {100, 7}});
+    const details::small_size_table table{profile.get_entries(), 64, 8};
+
+    // 1 and 5 share the aligned size 8, 100 is above the threshold, which ends the table
+    REQUIRE(table.get_size_count() == 3);
+    CHECK(table.get_size(0) == 8);
+    CHECK(table.get_size(1) == 16);
+    CHECK(table.get_size(2) == 64);
+
+    CHECK(table.get_weight(0, 3) == 6.0);
+    CHECK(table.get_rounding_waste(0, 1) == 0.0);
+    CHECK(table.get_rounding_waste(0, 2) == 5.0 * 8.0);
+    CHECK(table.get_rounding_waste(0, 3) == 5.0 * 56.0 + 1.0 * 48.0);
+}
+
+TEST_CASE("partition_sizes finds the optimal partitions", "[size_class_search], [sizeclass]")
+{
+    // weights 10, 10, 1 and 1, every partition worked out by hand:
+    //   2 classes: {8, 16} {24, 64} wastes 10 * 8 + 1 * 40 = 120, against 520 for {8} and 240 for {8, 16, 24}
+    //   3 classes: {8} {16} {24, 64} wastes 40, against 80 for the two others
+    const size_profile profile = make_profile({{8, 10}, {16, 10}, {24, 1}, {64, 1}});
+    const details::small_size_table table{profile.get_entries(), 64, 8};
+
+    const std::vector<std::vector<std::size_t>> partitions = details::partition_sizes(table, 16);
+
+    REQUIRE(partitions.size() == 4);
+    CHECK(partitions[0] == std::vector<std::size_t>{4});
+    CHECK(partitions[1] == std::vector<std::size_t>{2, 4});
+    CHECK(partitions[2] == std::vector<std::size_t>{1, 2, 4});
+    CHECK(partitions[3] == std::vector<std::size_t>{1, 2, 3, 4});
+
+    CHECK(table.get_rounding_waste(0, 2) + table.get_rounding_waste(2, 4) == 120.0);
+
+    SECTION("max_classes")
+    {
+        CHECK(details::partition_sizes(table, 2).size() == 2);
+    }
+}
+
+TEST_CASE("search_size_classes filters thresholds and capacities", "[size_class_search], [sizeclass]")
+{
+    const size_profile profile = make_profile({{8, 100}, {24, 100}, {40, 50}, {200, 10}});
+
+    search_options options;
+    options.alignment = 8;
+
+    SECTION("unaligned or zero thresholds and capacities are skipped")
+    {
+        // 60 is not a multiple of the alignment, 32 is below the threshold and 0x1001 unaligned
+        options.thresholds = {0, 60, 64};
+        options.slab_capacities = {32, 0x1001, 0x1000};
+
+        const size_class_configuration configuration = search_size_classes(profile, options);
+
+        CHECK(configuration.threshold == 64);
+        CHECK(configuration.slab_capacity == 0x1000);
+        REQUIRE_FALSE(configuration.size_classes.empty());
+        CHECK(configuration.size_classes.back() == 64);
+        CHECK(std::isfinite(configuration.cost));
+
+        // the 10 objects of 200 bytes go to the large free list
+        CHECK(configuration.large_cache_size == 16);
+    }
+
+    SECTION("a capacity below every threshold leaves no configuration")
+    {
+        options.thresholds = {64, 128};
+        options.slab_capacities = {32};
+
+        const size_class_configuration configuration = search_size_classes(profile, options);
+
+        CHECK(configuration.size_classes.empty());
+        CHECK(configuration.threshold == 0);
+        CHECK(std::isinf(configuration.cost));
+    }
+}
+
+} // namespace coal::tools
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/trace/trace_event.hpp>
+#include <coal/trace/trace_replayer.hpp>
+
+#include <sizeclass/size_profile.hpp>
+
+namespace coal::tools {
+
+TEST_CASE("size_profile load_histogram", "[size_profile], [sizeclass]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    std::fputs("# size count peak_live\n"
+               "16 10\n"
+               "\n"
+               "32 5 3\n"
+               "# sizes may repeat\n"
+               "16 2 7\n"
+               "0 4\n",
+               file);
+    std::rewind(file);
+
+    size_profile profile;
+    REQUIRE(profile.load_histogram(file));
+
+    const std::vector<size_profile_entry> entries = profile.get_entries();
+
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0].size == 16);
+    CHECK(entries[0].count == 12);
+    CHECK(entries[0].peak_live == 7);
+    CHECK(entries[0].get_weight() == 7);
+    CHECK(entries[1].size == 32);
+    CHECK(entries[1].count == 5);
+    CHECK(entries[1].get_weight() == 3);
+    CHECK(profile.get_allocation_count() == 17);
+
+    std::fclose(file);
+}
+
+TEST_CASE("size_profile load_histogram rejects malformed lines", "[size_profile], [sizeclass]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    std::fputs("16 10\n"
+               "32\n",
+               file);
+    std::rewind(file);
+
+    size_profile profile;
+    CHECK_FALSE(profile.load_histogram(file));
+    CHECK_FALSE(profile.load_histogram(nullptr));
+
+    std::fclose(file);
+}
+
+TEST_CASE("size_profile load_trace", "[size_profile], [sizeclass]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    const std::vector<trace_event> events = {
+        {trace_event_type::allocate, true, 0, 16, 0},
+        {trace_event_type::allocate, true, 1, 16, 0},
+        {trace_event_type::allocate, false, 2, 16, 0},
+        {trace_event_type::deallocate, true, 0, 16, 0},
+        {trace_event_type::allocate, true, 0, 16, 0},
+        {trace_event_type::reallocate, true, 1, 16, 48},
+        {trace_event_type::expand, true, 0, 16, 32},
+        {trace_event_type::deallocate_all, true, 0, 0, 0},
+        {trace_event_type::allocate, true, 0, 16, 0},
+    };
+
+    REQUIRE(trace_format::write_header(file));
+
+    for (const trace_event& event : events)
+    {
+        std::uint8_t buffer[trace_format::max_event_size];
+        const std::size_t size = trace_format::encode(event, buffer);
+
+        REQUIRE(std::fwrite(buffer, size, 1, file) == 1);
+    }
+
+    std::rewind(file);
+
+    size_profile profile;
+    REQUIRE(profile.load_trace(file));
+
+    const std::vector<size_profile_entry> entries = profile.get_entries();
+
+    // a resize counts as an allocation of the new size, failed allocations are left out
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0].size == 16);
+    CHECK(entries[0].count == 4);
+    CHECK(entries[0].peak_live == 2);
+    CHECK(entries[1].size == 48);
+    CHECK(entries[1].count == 2);
+    CHECK(entries[1].peak_live == 2);
+
+    std::fclose(file);
+}
+
+} // namespace coal::tools
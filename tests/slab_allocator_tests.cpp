@@ -124,6 +124,23 @@ TEST_CASE("slab_allocator deallocate nullblk", "[slab_allocator], [allocator]")
     CHECK(block == nullblk);
 }
 
+TEST_CASE("slab_allocator expand within the same slab size", "[slab_allocator], [allocator]")
+{
+    slab_allocator<stack_allocator<0x1000 * 3>, 0x1000, 32, 64, 128> allocator;
+
+    memory_block block = allocator.allocate(40);
+    REQUIRE(block);
+
+    CHECK(allocator.expand(block, 8));
+    CHECK(block.size == 48);
+
+    CHECK_FALSE(allocator.expand(block, 32));
+    CHECK(block.size == 48);
+
+    allocator.deallocate(block);
+    CHECK(block == nullblk);
+}
+
 TEST_CASE("slab_allocator fragmentation handling with 'random' deallocation", "[slab_allocator], [allocator]")
 {
     constexpr std::size_t allocation_count = 10;
@@ -176,4 +193,19 @@ TEST_CASE("slab_allocator stress test with delayed deallocation", "[slab_allocat
     }
 }
 
+TEST_CASE("slab_allocator allocate returns nullblk when the parent is out of memory", "[slab_allocator], [allocator]")
+{
+    slab_allocator<stack_allocator<0x1000, 16>, 0x1000, 32> allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 0x1000 / 32; ++i)
+    {
+        blocks.push_back(allocator.allocate(32));
+        REQUIRE(blocks.back());
+    }
+
+    CHECK(allocator.allocate(32) == nullblk);
+}
+
 } // namespace coal
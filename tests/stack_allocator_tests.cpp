@@ -227,4 +227,44 @@ TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "stack_allocator expand over c
     this->deallocate_and_check_is_nullblk(block);
 }
 
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "stack_allocator rewind frees every block allocated since the marker", "[stack_allocator], [allocator]", stack_allocator_types)
+{
+    memory_block kept = this->allocator.allocate(4);
+
+    const typename TestType::marker marker = this->allocator.mark();
+
+    memory_block first = this->allocator.allocate(4);
+    [[maybe_unused]] memory_block second = this->allocator.allocate(TestType::alignment + 1);
+    [[maybe_unused]] memory_block third = this->allocator.allocate(1);
+
+    this->allocator.rewind(marker);
+
+    CHECK(this->allocator.allocate(4).ptr == first.ptr);
+    CHECK(this->allocator.owns(kept));
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "stack_allocator rewind nested markers", "[stack_allocator], [allocator]", stack_allocator_types)
+{
+    const typename TestType::marker outer = this->allocator.mark();
+    memory_block outer_block = this->allocator.allocate(4);
+
+    const typename TestType::marker inner = this->allocator.mark();
+    memory_block inner_block = this->allocator.allocate(4);
+
+    this->allocator.rewind(inner);
+    CHECK(this->allocator.allocate(4).ptr == inner_block.ptr);
+
+    this->allocator.rewind(outer);
+    CHECK(this->allocator.allocate(4).ptr == outer_block.ptr);
+}
+
+TEMPLATE_LIST_TEST_CASE_METHOD(allocator_fixture, "stack_allocator rewind to a marker of the current top does nothing", "[stack_allocator], [allocator]", stack_allocator_types)
+{
+    memory_block block = this->allocator.allocate(4);
+
+    this->allocator.rewind(this->allocator.mark());
+
+    CHECK(this->allocator.allocate(4).ptr == block.as<std::uint8_t>() + align_up(4, TestType::alignment));
+}
+
 } // namespace coal
@@ -0,0 +1,228 @@
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/affix_allocator.hpp>
+#include <coal/fallback_allocator.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/null_allocator.hpp>
+#include <coal/prefixed_size_allocator.hpp>
+#include <coal/proxy_allocator.hpp>
+#include <coal/segregator_allocator.hpp>
+#include <coal/slab_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+TEST_CASE_METHOD(basic_allocator_fixture<stats_allocator<stack_allocator<0x1000>>>, "stats_allocator basics", "[stats_allocator], [allocator]")
+{
+    this->test_basics();
+}
+
+TEST_CASE("stats_allocator counts every operation", "[stats_allocator], [allocator]")
+{
+    stats_allocator<stack_allocator<0x1000>> allocator;
+
+    memory_block block0 = allocator.allocate(16);
+    memory_block block1 = allocator.allocate(100);
+
+    CHECK(allocator.owns(block0));
+    CHECK(allocator.expand(block1, 28));
+
+    // the reallocation copies the block, the old block is released before returning
+    CHECK(allocator.reallocate(block0, 60));
+
+    allocator_stats stats = allocator.get_stats();
+
+    CHECK(stats.get_calls(stats_operation::allocate) == 2);
+    CHECK(stats.get_calls(stats_operation::owns) == 1);
+    CHECK(stats.get_calls(stats_operation::expand) == 1);
+    CHECK(stats.get_calls(stats_operation::reallocate) == 1);
+    CHECK(stats.get_calls(stats_operation::deallocate) == 0);
+    CHECK(stats.bytes_requested == 16 + 100 + 28 + 60);
+
+    // the stack rounds every block to its 8 byte alignment
+    CHECK(stats.bytes_granted == 16 + 104 + (128 - 104) + 64);
+    CHECK(stats.live_bytes == 60 + 128);
+    CHECK(stats.peak_live_bytes == 128 + 60);
+
+    CHECK(stats.get_size_histogram(stats_operation::allocate)[allocator_stats::histogram_bucket(16)] == 1);
+    CHECK(stats.get_size_histogram(stats_operation::allocate)[allocator_stats::histogram_bucket(100)] == 1);
+    CHECK(stats.get_size_histogram(stats_operation::expand)[allocator_stats::histogram_bucket(28)] == 1);
+
+    allocator.deallocate(block0);
+    allocator.deallocate(block1);
+
+    stats = allocator.get_stats();
+
+    CHECK(stats.get_calls(stats_operation::deallocate) == 2);
+    CHECK(stats.live_bytes == 0);
+    CHECK(stats.peak_live_bytes == 128 + 60);
+
+    allocator.reset_stats();
+
+    stats = allocator.get_stats();
+
+    CHECK(stats.get_calls(stats_operation::allocate) == 0);
+    CHECK(stats.bytes_requested == 0);
+    CHECK(stats.peak_live_bytes == 0);
+}
+
+TEST_CASE("stats_allocator bytes granted by the child serving the block", "[stats_allocator], [allocator]")
+{
+    stats_allocator<segregator_allocator<slab_allocator<stack_allocator<0x1000>, 0x400, 16, 32, 64>, stack_allocator<0x1000>, 64>> allocator;
+
+    memory_block small = allocator.allocate(20);
+    memory_block large = allocator.allocate(100);
+
+    REQUIRE(small);
+    REQUIRE(large);
+
+    const allocator_stats stats = allocator.get_stats();
+
+    CHECK(stats.bytes_requested == 20 + 100);
+    CHECK(stats.bytes_granted == 32 + 104);
+
+    allocator.deallocate(large);
+    allocator.deallocate(small);
+}
+
+TEST_CASE("stats_allocator bytes granted through wrappers", "[stats_allocator], [allocator]")
+{
+    using stack_t = stack_allocator<0x1000, 8>;
+
+    STATIC_CHECK(allocator_traits::has_granted_size<proxy_allocator<stack_t>>);
+    STATIC_CHECK(allocator_traits::has_granted_size<fallback_allocator<stack_t, stack_t>>);
+    STATIC_CHECK_FALSE(allocator_traits::has_granted_size<fallback_allocator<stack_t, malloc_allocator>>);
+    STATIC_CHECK_FALSE(allocator_traits::has_granted_size<affix_allocator<malloc_allocator, std::uint32_t>>);
+
+    SECTION("affix_allocator adds its affixes")
+    {
+        stats_allocator<affix_allocator<stack_t, std::uint32_t, std::uint64_t>> allocator;
+
+        memory_block block = allocator.allocate(20);
+        REQUIRE(block);
+
+        const allocator_stats stats = allocator.get_stats();
+
+        CHECK(stats.bytes_requested == 20);
+        CHECK(stats.bytes_granted == 24 + 8 + 8);
+
+        allocator.deallocate(block);
+    }
+
+    SECTION("prefixed_size_allocator adds its size prefix")
+    {
+        stats_allocator<prefixed_size_allocator<stack_t>> allocator;
+
+        memory_block block = allocator.allocate(20);
+        REQUIRE(block);
+
+        const allocator_stats stats = allocator.get_stats();
+
+        CHECK(stats.bytes_requested == 20);
+        CHECK(stats.bytes_granted == 24 + sizeof(std::size_t));
+
+        allocator.deallocate(block);
+    }
+
+    SECTION("proxy_allocator forwards to its allocator")
+    {
+        stack_t stack;
+        stats_allocator<proxy_allocator<stack_t>> allocator;
+        allocator.get_allocator().set_allocator(&stack);
+
+        memory_block block = allocator.allocate(20);
+        REQUIRE(block);
+
+        CHECK(allocator.get_stats().bytes_granted == 24);
+
+        allocator.deallocate(block);
+    }
+}
+
+TEST_CASE("stats_allocator counts failures", "[stats_allocator], [allocator]")
+{
+    stats_allocator<null_allocator> allocator;
+
+    memory_block block = allocator.allocate(8);
+    CHECK_FALSE(allocator.reallocate(block, 16));
+
+    const allocator_stats stats = allocator.get_stats();
+
+    CHECK(stats.get_failures(stats_operation::allocate) == 1);
+    CHECK(stats.get_failures(stats_operation::reallocate) == 1);
+    CHECK(stats.bytes_requested == 8 + 16);
+    CHECK(stats.bytes_granted == 0);
+    CHECK(stats.live_bytes == 0);
+}
+
+TEST_CASE("stats_allocator disabled metrics take no space", "[stats_allocator], [allocator]")
+{
+    using allocator_t = stack_allocator<0x100>;
+
+    STATIC_CHECK(sizeof(stats_allocator<allocator_t, stats_options::none>) == sizeof(allocator_t));
+
+    stats_allocator<allocator_t, stats_options::calls> allocator;
+
+    memory_block block = allocator.allocate(8);
+    allocator.deallocate(block);
+
+    const allocator_stats stats = allocator.get_stats();
+
+    CHECK(stats.get_calls(stats_operation::allocate) == 1);
+    CHECK(stats.get_calls(stats_operation::deallocate) == 1);
+    CHECK(stats.bytes_requested == 0);
+    CHECK(stats.peak_live_bytes == 0);
+}
+
+TEST_CASE("stats_allocator histogram buckets", "[stats_allocator], [allocator]")
+{
+    STATIC_CHECK(allocator_stats::histogram_bucket(0) == 0);
+    STATIC_CHECK(allocator_stats::histogram_bucket(1) == 1);
+    STATIC_CHECK(allocator_stats::histogram_bucket(2) == 2);
+    STATIC_CHECK(allocator_stats::histogram_bucket(3) == 2);
+    STATIC_CHECK(allocator_stats::histogram_bucket(4) == 3);
+    STATIC_CHECK(allocator_stats::histogram_bucket(std::size_t{1} << 40) == allocator_stats::histogram_bucket_count - 1);
+}
+
+TEST_CASE("stats_allocator aggregates shards of every thread", "[stats_allocator], [allocator]")
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t allocation_count = 1000;
+
+    stats_allocator<malloc_allocator, stats_options::all, 2> allocator;
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&allocator]() {
+            for (std::size_t j = 0; j < allocation_count; ++j)
+            {
+                memory_block block = allocator.allocate(32);
+                allocator.deallocate(block);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const allocator_stats stats = allocator.get_stats();
+
+    CHECK(stats.get_calls(stats_operation::allocate) == thread_count * allocation_count);
+    CHECK(stats.get_calls(stats_operation::deallocate) == thread_count * allocation_count);
+    CHECK(stats.bytes_requested == thread_count * allocation_count * 32);
+    CHECK(stats.live_bytes == 0);
+    CHECK(stats.peak_live_bytes >= 32);
+    CHECK(stats.peak_live_bytes <= static_cast<std::int64_t>(thread_count * 32));
+}
+
+} // namespace coal
@@ -0,0 +1,310 @@
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/bucket_policy/geometric.hpp>
+#include <coal/bucket_policy/linear.hpp>
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/stats_allocator.hpp>
+#include <coal/thread_cache_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using thread_cache_stats_t = stats_allocator<malloc_allocator, stats_options::calls | stats_options::live_bytes, 1>;
+using thread_cache_t = thread_cache_allocator<thread_cache_stats_t, bucket_policy::linear<16, 256, 16>, 4>;
+
+using thread_cache_basic_allocators = std::tuple<
+    thread_cache_allocator<stack_allocator<0x10000, 16>, bucket_policy::linear<16, 256, 16>>,
+    thread_cache_allocator<free_list_allocator<stack_allocator<0x10000, 16>, free_list_strategy::first_fit>, bucket_policy::geometric<64, 1024, 4>, 8>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "thread_cache_allocator basics", "[thread_cache_allocator], [allocator]", thread_cache_basic_allocators)
+{
+    this->large_expand = false;
+
+    this->test_basics();
+}
+
+TEST_CASE("thread_cache_allocator refills a batch from the allocator", "[thread_cache_allocator], [allocator]")
+{
+    thread_cache_t allocator;
+
+    std::vector<memory_block> blocks;
+
+    blocks.push_back(allocator.allocate(20));
+
+    REQUIRE(blocks.back());
+    CHECK(blocks.back().size == 20);
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::allocate) == thread_cache_t::batch_size);
+    CHECK(allocator.get_thread_cached_count() == thread_cache_t::batch_size - 1);
+
+    // the next allocations of the bucket come from the cache
+    for (std::size_t i = 1; i < thread_cache_t::batch_size; ++i)
+    {
+        blocks.push_back(allocator.allocate(32));
+        CHECK(blocks.back());
+    }
+
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::allocate) == thread_cache_t::batch_size);
+    CHECK(allocator.get_thread_cached_count() == 0);
+
+    // another bucket refills its own batch
+    blocks.push_back(allocator.allocate(64));
+    CHECK(blocks.back());
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::allocate) == thread_cache_t::batch_size * 2);
+
+    for (memory_block& block : blocks)
+    {
+        allocator.deallocate(block);
+    }
+}
+
+TEST_CASE("thread_cache_allocator flushes a batch when the cache is full", "[thread_cache_allocator], [allocator]")
+{
+    thread_cache_t allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < thread_cache_t::max_cached_count; ++i)
+    {
+        blocks.push_back(allocator.allocate(16));
+        REQUIRE(blocks.back());
+    }
+
+    for (std::size_t i = 0; i + 1 < blocks.size(); ++i)
+    {
+        allocator.deallocate(blocks[i]);
+        CHECK(blocks[i] == nullblk);
+    }
+
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::deallocate) == 0);
+
+    allocator.deallocate(blocks.back());
+
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::deallocate) == thread_cache_t::batch_size);
+    CHECK(allocator.get_thread_cached_count() == thread_cache_t::max_cached_count - thread_cache_t::batch_size);
+
+    allocator.flush_thread_cache();
+
+    CHECK(allocator.get_thread_cached_count() == 0);
+    CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+}
+
+TEST_CASE("thread_cache_allocator sizes above the buckets go to the allocator", "[thread_cache_allocator], [allocator]")
+{
+    thread_cache_t allocator;
+
+    memory_block block = allocator.allocate(thread_cache_t::max_size + 1);
+
+    REQUIRE(block);
+    CHECK(allocator.get_allocator().get_stats().get_calls(stats_operation::allocate) == 1);
+
+    SECTION("deallocate")
+    {
+        allocator.deallocate(block);
+
+        CHECK(block == nullblk);
+        CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+    }
+
+    SECTION("reallocate to a bucket")
+    {
+        std::memset(block.ptr, 0x5A, block.size);
+
+        REQUIRE(allocator.reallocate(block, 32));
+
+        CHECK(block.size == 32);
+        CHECK(block.as<std::uint8_t>()[31] == 0x5A);
+
+        allocator.deallocate(block);
+    }
+}
+
+TEST_CASE("thread_cache_allocator owns", "[thread_cache_allocator], [allocator]")
+{
+    thread_cache_allocator<stack_allocator<0x1000, 16>, bucket_policy::linear<16, 256, 16>, 4> allocator;
+
+    memory_block small = allocator.allocate(20);
+    memory_block large = allocator.allocate(0x200);
+
+    CHECK(allocator.owns(small));
+    CHECK(allocator.owns(large));
+
+    static std::uint8_t foreign[16];
+
+    CHECK_FALSE(allocator.owns({foreign, sizeof(foreign)}));
+    CHECK_FALSE(allocator.owns(nullblk));
+}
+
+TEST_CASE("thread_cache_allocator expand within the bucket", "[thread_cache_allocator], [allocator]")
+{
+    thread_cache_t allocator;
+
+    memory_block block = allocator.allocate(20);
+    void* ptr = block.ptr;
+
+    CHECK(allocator.expand(block, 12));
+    CHECK(block.ptr == ptr);
+    CHECK(block.size == 32);
+
+    CHECK_FALSE(allocator.expand(block, 1));
+    CHECK(block.size == 32);
+
+    CHECK(allocator.reallocate(block, 48));
+    CHECK(block.size == 48);
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("thread_cache_allocator flushes the cache on thread exit", "[thread_cache_allocator], [allocator]")
+{
+    thread_cache_t allocator;
+
+    std::thread thread{[&allocator]() {
+        memory_block block = allocator.allocate(16);
+        allocator.deallocate(block);
+    }};
+
+    thread.join();
+
+    CHECK(allocator.get_cache_count() == 1);
+    CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+
+    SECTION("the cache of an exited thread is reused")
+    {
+        std::thread other{[&allocator]() {
+            memory_block block = allocator.allocate(16);
+            allocator.deallocate(block);
+        }};
+
+        other.join();
+
+        CHECK(allocator.get_cache_count() == 1);
+        CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+    }
+
+    SECTION("a running thread gets its own cache")
+    {
+        memory_block block = allocator.allocate(16);
+
+        CHECK(allocator.get_cache_count() == 1);
+
+        std::size_t cache_count = 0;
+
+        std::thread other{[&allocator, &block, &cache_count]() {
+            // a block freed by another thread goes to the cache of that thread
+            allocator.deallocate(block);
+            cache_count = allocator.get_cache_count();
+        }};
+
+        other.join();
+
+        CHECK(cache_count == 2);
+        CHECK(allocator.get_cache_count() == 2);
+    }
+
+    SECTION("querying a thread without a cache does not create one")
+    {
+        std::size_t cached_count = 1;
+
+        std::thread other{[&allocator, &cached_count]() {
+            cached_count = std::as_const(allocator).get_thread_cached_count();
+        }};
+
+        other.join();
+
+        CHECK(cached_count == 0);
+        CHECK(allocator.get_cache_count() == 1);
+    }
+}
+
+TEST_CASE("thread_cache_allocator destroyed before the thread exits", "[thread_cache_allocator], [allocator]")
+{
+    {
+        thread_cache_t allocator;
+
+        memory_block block = allocator.allocate(16);
+        allocator.deallocate(block);
+    }
+
+    // the thread still holds the cache of the destroyed allocator and must not reuse it
+    thread_cache_t allocator;
+
+    memory_block block = allocator.allocate(16);
+
+    CHECK(block);
+    CHECK(allocator.get_cache_count() == 1);
+    CHECK(allocator.get_thread_cached_count() == thread_cache_t::batch_size - 1);
+
+    allocator.deallocate(block);
+}
+
+TEST_CASE("thread_cache_allocator concurrent allocations", "[thread_cache_allocator], [allocator]")
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iteration_count = 1000;
+
+    thread_cache_t allocator;
+
+    std::atomic<std::size_t> failure_count{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&allocator, &failure_count, i]() {
+            std::vector<memory_block> blocks;
+
+            for (std::size_t j = 0; j < iteration_count; ++j)
+            {
+                const std::size_t size = 1 + (i * 31 + j * 7) % 300;
+
+                memory_block block = allocator.allocate(size);
+
+                if (!block)
+                {
+                    ++failure_count;
+                    continue;
+                }
+
+                std::memset(block.ptr, static_cast<int>(i), block.size);
+                blocks.push_back(block);
+
+                if (j % 3 == 0)
+                {
+                    if (block.as<std::uint8_t>()[size - 1] != i)
+                    {
+                        ++failure_count;
+                    }
+
+                    allocator.deallocate(blocks.back());
+                    blocks.pop_back();
+                }
+            }
+
+            for (memory_block& block : blocks)
+            {
+                allocator.deallocate(block);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(failure_count == 0);
+    CHECK(allocator.get_cache_count() <= thread_count);
+    CHECK(allocator.get_allocator().get_stats().live_bytes == 0);
+}
+
+} // namespace coal
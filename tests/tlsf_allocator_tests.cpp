@@ -0,0 +1,246 @@
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/segregator_allocator.hpp>
+#include <coal/stack_allocator.hpp>
+#include <coal/tlsf_allocator.hpp>
+
+#include <allocator_fixture.hpp>
+
+namespace coal {
+
+using tlsf_basic_allocators = std::tuple<
+    tlsf_allocator<stack_allocator<0x10000, 8>, 0x10000>,
+    tlsf_allocator<stack_allocator<0x10000, 16>, 0x8000, 5>,
+    tlsf_allocator<malloc_allocator, 0x1000, 2>>;
+
+TEMPLATE_LIST_TEST_CASE_METHOD(basic_allocator_fixture, "tlsf_allocator basics", "[tlsf_allocator], [allocator]", tlsf_basic_allocators)
+{
+    this->test_basics();
+}
+
+using small_tlsf = tlsf_allocator<malloc_allocator, 0x1000>;
+
+TEST_CASE("tlsf_allocator splits and coalesces blocks", "[tlsf_allocator], [allocator]")
+{
+    small_tlsf allocator;
+
+    memory_block block0 = allocator.allocate(100);
+
+    REQUIRE(block0);
+    REQUIRE(allocator.get_free_block_count() == 1);
+
+    const std::size_t pool_free_size = allocator.get_free_size() + 112 + 16;
+
+    memory_block block1 = allocator.allocate(1);
+    memory_block block2 = allocator.allocate(200);
+
+    // blocks follow each other, each behind a 16 byte header
+    CHECK(block1.as<std::uint8_t>() == block0.as<std::uint8_t>() + 112 + 16);
+    CHECK(block2.as<std::uint8_t>() == block1.as<std::uint8_t>() + 16 + 16);
+    CHECK(allocator.get_free_block_count() == 1);
+
+    allocator.deallocate(block0);
+    allocator.deallocate(block2);
+
+    // block2 merged with the rest of the pool, block0 stays apart
+    CHECK(allocator.get_free_block_count() == 2);
+
+    allocator.deallocate(block1);
+
+    CHECK(allocator.get_free_block_count() == 1);
+    CHECK(allocator.get_free_size() == pool_free_size);
+
+    CHECK(allocator.allocate(small_tlsf::max_size));
+}
+
+TEST_CASE("tlsf_allocator reuses a freed block of the same size", "[tlsf_allocator], [allocator]")
+{
+    small_tlsf allocator;
+
+    std::vector<memory_block> blocks;
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        blocks.push_back(allocator.allocate(48));
+    }
+
+    void* ptr = blocks[3].ptr;
+
+    allocator.deallocate(blocks[3]);
+
+    CHECK(allocator.allocate(40).ptr == ptr);
+}
+
+TEST_CASE("tlsf_allocator allocate nullblk when the pool is full", "[tlsf_allocator], [allocator]")
+{
+    small_tlsf allocator;
+
+    CHECK(allocator.allocate(small_tlsf::max_size + 1) == nullblk);
+
+    memory_block block = allocator.allocate(small_tlsf::max_size);
+
+    REQUIRE(block);
+    CHECK(allocator.get_free_size() == 0);
+    CHECK(allocator.allocate(1) == nullblk);
+
+    allocator.deallocate_all();
+
+    CHECK(allocator.allocate(small_tlsf::max_size));
+}
+
+TEST_CASE("tlsf_allocator expand over the next free block", "[tlsf_allocator], [allocator]")
+{
+    small_tlsf allocator;
+
+    memory_block block0 = allocator.allocate(64);
+    memory_block block1 = allocator.allocate(64);
+    memory_block block2 = allocator.allocate(64);
+
+    // within the aligned size
+    memory_block block3 = allocator.allocate(1);
+    CHECK(allocator.expand(block3, 15));
+    CHECK(block3.size == 16);
+
+    CHECK_FALSE(allocator.expand(block0, 1));
+
+    allocator.deallocate(block1);
+
+    // over the 64 bytes and header of block1
+    CHECK(allocator.expand(block0, 80));
+    CHECK(block0.size == 144);
+    CHECK(allocator.get_free_block_count() == 1);
+
+    CHECK_FALSE(allocator.expand(block0, 1));
+
+    // the last block grows over the rest of the pool
+    CHECK(allocator.expand(block3, 0x800));
+    CHECK(block3.size == 0x810);
+
+    allocator.deallocate(block0);
+    allocator.deallocate(block2);
+    allocator.deallocate(block3);
+
+    CHECK(allocator.get_free_block_count() == 1);
+}
+
+TEST_CASE("tlsf_allocator reallocate", "[tlsf_allocator], [allocator]")
+{
+    small_tlsf allocator;
+
+    memory_block block = allocator.allocate(200);
+    void* ptr = block.ptr;
+
+    std::memset(block.ptr, 0x5A, block.size);
+
+    SECTION("shrinks in place")
+    {
+        const std::size_t free_size = allocator.get_free_size();
+
+        CHECK(allocator.reallocate(block, 50));
+        CHECK(block.ptr == ptr);
+        CHECK(block.size == 50);
+
+        // the tail merged with the free rest of the pool
+        CHECK(allocator.get_free_size() == free_size + 208 - 64);
+        CHECK(allocator.get_free_block_count() == 1);
+    }
+
+    SECTION("grows in place")
+    {
+        CHECK(allocator.reallocate(block, 400));
+        CHECK(block.ptr == ptr);
+        CHECK(block.size == 400);
+    }
+
+    SECTION("moves when the next block is taken")
+    {
+        memory_block next = allocator.allocate(16);
+
+        CHECK(allocator.reallocate(block, 400));
+        CHECK(block.ptr != ptr);
+        CHECK(block.size == 400);
+
+        for (std::size_t i = 0; i < 200; ++i)
+        {
+            CHECK(block.as<std::uint8_t>()[i] == 0x5A);
+        }
+
+        allocator.deallocate(next);
+    }
+}
+
+TEST_CASE("tlsf_allocator coalesces everything back after random churn", "[tlsf_allocator], [allocator]")
+{
+    tlsf_allocator<malloc_allocator, 0x100000> allocator;
+
+    std::mt19937 random{42};
+    std::uniform_int_distribution<std::size_t> size_distribution{1, 4096};
+    std::vector<memory_block> blocks(128);
+
+    for (std::size_t i = 0; i < 20000; ++i)
+    {
+        memory_block& block = blocks[random() % blocks.size()];
+
+        if (block)
+        {
+            CHECK(block.as<std::uint8_t>()[block.size - 1] == static_cast<std::uint8_t>(block.size));
+
+            if (i % 3 == 0)
+            {
+                const std::size_t new_size = size_distribution(random);
+
+                if (allocator.reallocate(block, new_size))
+                {
+                    std::memset(block.ptr, static_cast<int>(block.size), block.size);
+                }
+            }
+            else
+            {
+                allocator.deallocate(block);
+            }
+        }
+        else if ((block = allocator.allocate(size_distribution(random))))
+        {
+            CHECK(allocator.owns(block));
+            CHECK(reinterpret_cast<std::uintptr_t>(block.ptr) % allocator.get_alignment() == 0);
+            std::memset(block.ptr, static_cast<int>(block.size), block.size);
+        }
+    }
+
+    for (memory_block& block : blocks)
+    {
+        allocator.deallocate(block);
+    }
+
+    CHECK(allocator.get_free_block_count() == 1);
+    CHECK(allocator.allocate(allocator.max_size));
+}
+
+TEST_CASE("tlsf_allocator as the large side of a segregator_allocator", "[tlsf_allocator], [allocator]")
+{
+    segregator_allocator<free_list_allocator<stack_allocator<0x1000>, free_list_strategy::first_fit>, tlsf_allocator<malloc_allocator, 0x10000>, 128> allocator;
+
+    memory_block small = allocator.allocate(64);
+    memory_block large = allocator.allocate(1000);
+
+    CHECK(allocator.get_small_allocator().owns(small));
+    CHECK(allocator.get_large_allocator().owns(large));
+
+    CHECK(allocator.reallocate(large, 2000));
+    CHECK(allocator.get_large_allocator().owns(large));
+
+    allocator.deallocate(small);
+    allocator.deallocate(large);
+
+    CHECK(allocator.get_large_allocator().get_free_block_count() == 1);
+}
+
+} // namespace coal
@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <coal/stack_allocator.hpp>
+#include <coal/trace/trace_event.hpp>
+#include <coal/trace/trace_recorder.hpp>
+#include <coal/trace/trace_replayer.hpp>
+
+namespace coal {
+
+TEST_CASE("trace_format encode and read back events", "[trace_format], [trace]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    const std::vector<trace_event> expected_events = {
+        {trace_event_type::allocate, true, 0, 1, 0},
+        {trace_event_type::allocate, false, 0, 0xFFFFFFFFFFFF, 0},
+        {trace_event_type::reallocate, true, 300, 128, 0x10000},
+        {trace_event_type::expand, false, 1, 128, 8},
+        {trace_event_type::deallocate, true, 300, 0x10000, 0},
+        {trace_event_type::deallocate_all, true, 0, 0, 0},
+    };
+
+    REQUIRE(trace_format::write_header(file));
+
+    for (const trace_event& event : expected_events)
+    {
+        std::uint8_t buffer[trace_format::max_event_size];
+        const std::size_t size = trace_format::encode(event, buffer);
+
+        CHECK(size <= trace_format::max_event_size);
+        REQUIRE(std::fwrite(buffer, size, 1, file) == 1);
+    }
+
+    std::rewind(file);
+
+    std::vector<trace_event> events;
+    REQUIRE(read_trace(file, events));
+    REQUIRE(events.size() == expected_events.size());
+
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        INFO("event #" << i);
+
+        CHECK(events[i].type == expected_events[i].type);
+        CHECK(events[i].success == expected_events[i].success);
+        CHECK(events[i].object_id == expected_events[i].object_id);
+        CHECK(events[i].size == expected_events[i].size);
+        CHECK(events[i].argument == expected_events[i].argument);
+    }
+
+    std::fclose(file);
+}
+
+TEST_CASE("trace_format rejects unknown file", "[trace_format], [trace]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    std::fputs("not a trace", file);
+    std::rewind(file);
+
+    std::vector<trace_event> events;
+    CHECK_FALSE(read_trace(file, events));
+
+    std::fclose(file);
+}
+
+TEST_CASE("trace_recorder recycles object ids", "[trace_recorder], [trace]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    std::uint64_t objects[3]{};
+
+    {
+        trace_recorder recorder{file};
+
+        recorder.record_allocate(memory_block{&objects[0], 8}, 8);
+        recorder.record_allocate(memory_block{&objects[1], 8}, 8);
+        recorder.record_deallocate(memory_block{&objects[0], 8});
+        recorder.record_allocate(memory_block{&objects[2], 8}, 8);
+    }
+
+    std::rewind(file);
+
+    std::vector<trace_event> events;
+    REQUIRE(read_trace(file, events));
+    REQUIRE(events.size() == 4);
+
+    CHECK(events[0].object_id == 0);
+    CHECK(events[1].object_id == 1);
+    CHECK(events[2].object_id == 0);
+    CHECK(events[3].object_id == 0);
+
+    std::fclose(file);
+}
+
+TEST_CASE("trace_replayer replays events", "[trace_replayer], [trace]")
+{
+    const std::vector<trace_event> events = {
+        {trace_event_type::allocate, true, 0, 16, 0},
+        {trace_event_type::allocate, true, 1, 32, 0},
+        {trace_event_type::expand, true, 1, 32, 16},
+        {trace_event_type::reallocate, true, 0, 16, 64},
+        {trace_event_type::deallocate, true, 1, 48, 0},
+        {trace_event_type::allocate, true, 1, 8, 0},
+    };
+
+    stack_allocator<0x1000> allocator;
+    trace_replayer<stack_allocator<0x1000>> replayer{allocator};
+
+    const replay_result result = replayer.replay(events);
+
+    CHECK(result.events == events.size());
+    CHECK(result.failures == 0);
+    CHECK(result.unsupported == 0);
+    CHECK(result.live_bytes == 64 + 8);
+    CHECK(result.peak_live_bytes == 64 + 48);
+}
+
+TEST_CASE("trace_replayer counts failures", "[trace_replayer], [trace]")
+{
+    const std::vector<trace_event> events = {
+        {trace_event_type::allocate, true, 0, 0x80, 0},
+        {trace_event_type::allocate, true, 1, 0x80, 0},
+        {trace_event_type::allocate, false, 0, 0x80, 0},
+    };
+
+    stack_allocator<0x80> allocator;
+    trace_replayer<stack_allocator<0x80>> replayer{allocator};
+
+    const replay_result result = replayer.replay(events);
+
+    CHECK(result.failures == 1);
+    CHECK(result.peak_live_bytes == 0x80);
+}
+
+} // namespace coal
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+#include <coal/memory_block.hpp>
+
+namespace coal::tools {
+
+// Leaf wrapper that counts the bytes held from the parent by every instance, a composite may contain several leaves.
+template<typename AllocatorT>
+class footprint_allocator : public AllocatorT
+{
+public:
+    [[nodiscard]] memory_block allocate(std::size_t size)
+    {
+        memory_block block = AllocatorT::allocate(size);
+        add(block.size);
+        return block;
+    }
+
+    bool reallocate(memory_block& block, std::size_t new_size)
+    {
+        const std::size_t old_size = block.size;
+
+        if (!AllocatorT::reallocate(block, new_size))
+        {
+            return false;
+        }
+
+        remove(old_size);
+        add(block.size);
+        return true;
+    }
+
+    void deallocate(memory_block& block)
+    {
+        if (block)
+        {
+            remove(block.size);
+        }
+
+        AllocatorT::deallocate(block);
+    }
+
+    static void reset()
+    {
+        bytes = 0;
+        peak_bytes = 0;
+    }
+
+    inline static std::uint64_t bytes{0};
+    inline static std::uint64_t peak_bytes{0};
+
+private:
+    static void add(std::size_t size)
+    {
+        bytes += size;
+        peak_bytes = bytes > peak_bytes ? bytes : peak_bytes;
+    }
+
+    static void remove(std::size_t size)
+    {
+        bytes -= size;
+    }
+};
+
+} // namespace coal::tools
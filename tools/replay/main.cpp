@@ -0,0 +1,209 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <coal/free_list_allocator.hpp>
+#include <coal/free_list_strategy/best_fit.hpp>
+#include <coal/free_list_strategy/first_fit.hpp>
+#include <coal/free_list_strategy/limited_size.hpp>
+#include <coal/malloc_allocator.hpp>
+#include <coal/prefixed_size_allocator.hpp>
+#include <coal/segregator_allocator.hpp>
+#include <coal/slab_allocator.hpp>
+#include <coal/trace/trace_replayer.hpp>
+
+#include <replay/footprint_allocator.hpp>
+
+namespace coal::tools {
+
+using leaf_t = footprint_allocator<malloc_allocator>;
+
+namespace candidates {
+
+using malloc_t = leaf_t;
+using slab_t = slab_allocator<leaf_t, 0x10000, 16, 32, 64, 128, 256, 512, 1024>;
+using large_t = free_list_allocator<prefixed_size_allocator<leaf_t>, free_list_strategy::limited_size<free_list_strategy::best_fit, 64>>;
+
+using segregator_256_t = segregator_allocator<slab_allocator<leaf_t, 0x10000, 16, 32, 64, 128, 256>, large_t, 256>;
+using segregator_1024_t = segregator_allocator<slab_t, large_t, 1024>;
+using segregator_fine_t = segregator_allocator<slab_allocator<leaf_t, 0x10000, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024>, large_t, 1024>;
+
+using free_list_first_fit_t = free_list_allocator<leaf_t, free_list_strategy::first_fit>;
+using free_list_best_fit_t = free_list_allocator<leaf_t, free_list_strategy::best_fit>;
+
+} // namespace candidates
+
+enum class output_format
+{
+    table,
+    csv,
+    json
+};
+
+struct options
+{
+    std::string trace{};
+    std::string filter{};
+    output_format format{output_format::table};
+};
+
+struct candidate_result
+{
+    std::string name;
+    replay_result replay;
+    std::uint64_t peak_footprint_bytes{0};
+
+    // share of the peak footprint that never held live data
+    [[nodiscard]] double get_fragmentation() const
+    {
+        return peak_footprint_bytes ? 1.0 - static_cast<double>(replay.peak_live_bytes) / static_cast<double>(peak_footprint_bytes) : 0.0;
+    }
+};
+
+template<typename AllocatorT>
+void replay_candidate(std::vector<candidate_result>& results, const options& options, std::string_view name, const std::vector<trace_event>& events)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    leaf_t::reset();
+
+    auto allocator = std::make_unique<AllocatorT>();
+    trace_replayer<AllocatorT> replayer{*allocator};
+
+    candidate_result result;
+    result.name = name;
+    result.replay = replayer.replay(events);
+    result.peak_footprint_bytes = leaf_t::peak_bytes;
+
+    results.push_back(std::move(result));
+}
+
+void replay_all(std::vector<candidate_result>& results, const options& options, const std::vector<trace_event>& events)
+{
+    using namespace candidates;
+
+    replay_candidate<malloc_t>(results, options, "malloc", events);
+    replay_candidate<segregator_256_t>(results, options, "segregator_slab_256", events);
+    replay_candidate<segregator_1024_t>(results, options, "segregator_slab_1024", events);
+    replay_candidate<segregator_fine_t>(results, options, "segregator_slab_fine_1024", events);
+    replay_candidate<free_list_first_fit_t>(results, options, "free_list_first_fit", events);
+    replay_candidate<free_list_best_fit_t>(results, options, "free_list_best_fit", events);
+}
+
+void report(const std::vector<candidate_result>& results, output_format format)
+{
+    if (format == output_format::table)
+    {
+        std::printf("%-28s %12s %10s %12s %14s %16s %18s %14s\n", "allocator", "events", "failures", "unsupported", "events/s", "peak live bytes", "peak footprint", "fragmentation");
+    }
+    else if (format == output_format::csv)
+    {
+        std::printf("allocator,events,failures,unsupported,elapsed_ns,events_per_second,peak_live_bytes,peak_footprint_bytes,fragmentation\n");
+    }
+    else
+    {
+        std::printf("[");
+    }
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const candidate_result& r = results[i];
+        const replay_result& replay = r.replay;
+
+        switch (format)
+        {
+        case output_format::table:
+            std::printf("%-28s %12llu %10llu %12llu %14.0f %16llu %18llu %14.4f\n", r.name.c_str(), static_cast<unsigned long long>(replay.events), static_cast<unsigned long long>(replay.failures), static_cast<unsigned long long>(replay.unsupported), replay.get_events_per_second(), static_cast<unsigned long long>(replay.peak_live_bytes), static_cast<unsigned long long>(r.peak_footprint_bytes), r.get_fragmentation());
+            break;
+
+        case output_format::csv:
+            std::printf("%s,%llu,%llu,%llu,%llu,%.0f,%llu,%llu,%.6f\n", r.name.c_str(), static_cast<unsigned long long>(replay.events), static_cast<unsigned long long>(replay.failures), static_cast<unsigned long long>(replay.unsupported), static_cast<unsigned long long>(replay.elapsed_ns), replay.get_events_per_second(), static_cast<unsigned long long>(replay.peak_live_bytes), static_cast<unsigned long long>(r.peak_footprint_bytes), r.get_fragmentation());
+            break;
+
+        case output_format::json:
+            std::printf("%s\n  {\"allocator\": \"%s\", \"events\": %llu, \"failures\": %llu, \"unsupported\": %llu, \"elapsed_ns\": %llu, \"events_per_second\": %.0f, \"peak_live_bytes\": %llu, \"peak_footprint_bytes\": %llu, \"fragmentation\": %.6f}", i ? "," : "", r.name.c_str(), static_cast<unsigned long long>(replay.events), static_cast<unsigned long long>(replay.failures), static_cast<unsigned long long>(replay.unsupported), static_cast<unsigned long long>(replay.elapsed_ns), replay.get_events_per_second(), static_cast<unsigned long long>(replay.peak_live_bytes), static_cast<unsigned long long>(r.peak_footprint_bytes), r.get_fragmentation());
+            break;
+        }
+    }
+
+    if (format == output_format::json)
+    {
+        std::printf("\n]\n");
+    }
+}
+
+bool parse_arguments(options& options, int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+
+        if (arg.starts_with("--filter="))
+        {
+            options.filter = arg.substr(9);
+        }
+        else if (arg == "--format=table")
+        {
+            options.format = output_format::table;
+        }
+        else if (arg == "--format=csv")
+        {
+            options.format = output_format::csv;
+        }
+        else if (arg == "--format=json")
+        {
+            options.format = output_format::json;
+        }
+        else if (!arg.starts_with("--") && options.trace.empty())
+        {
+            options.trace = arg;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !options.trace.empty();
+}
+
+} // namespace coal::tools
+
+int main(int argc, char** argv)
+{
+    coal::tools::options options;
+
+    if (!coal::tools::parse_arguments(options, argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s <trace> [--filter=allocator] [--format=table|csv|json]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::FILE* file = std::fopen(options.trace.c_str(), "rb");
+    std::vector<coal::trace_event> events;
+
+    const bool read = coal::read_trace(file, events);
+
+    if (file != nullptr)
+    {
+        std::fclose(file);
+    }
+
+    if (!read)
+    {
+        std::fprintf(stderr, "cannot read trace %s\n", options.trace.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::vector<coal::tools::candidate_result> results;
+    coal::tools::replay_all(results, options, events);
+    coal::tools::report(results, options.format);
+
+    return EXIT_SUCCESS;
+}
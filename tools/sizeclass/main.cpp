@@ -0,0 +1,178 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sizeclass/size_class_search.hpp>
+#include <sizeclass/size_profile.hpp>
+
+namespace coal::tools {
+
+enum class input_format
+{
+    trace,
+    histogram
+};
+
+struct options
+{
+    std::string input{};
+    std::string output{};
+    std::string name{"allocator_t"};
+    input_format format{input_format::trace};
+    search_options search{};
+};
+
+std::vector<std::size_t> parse_sizes(std::string_view list)
+{
+    std::vector<std::size_t> sizes;
+
+    while (!list.empty())
+    {
+        const std::size_t comma = list.find(',');
+        const std::string value{list.substr(0, comma)};
+
+        sizes.push_back(std::strtoull(value.c_str(), nullptr, 0));
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+    }
+
+    return sizes;
+}
+
+bool parse_arguments(options& options, int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--histogram")
+        {
+            options.format = input_format::histogram;
+        }
+        else if (arg.starts_with("--output="))
+        {
+            options.output = arg.substr(9);
+        }
+        else if (arg.starts_with("--name="))
+        {
+            options.name = arg.substr(7);
+        }
+        else if (arg.starts_with("--alignment="))
+        {
+            options.search.alignment = std::strtoull(argv[i] + 12, nullptr, 0);
+        }
+        else if (arg.starts_with("--max-classes="))
+        {
+            options.search.max_classes = std::strtoull(argv[i] + 14, nullptr, 0);
+        }
+        else if (arg.starts_with("--thresholds="))
+        {
+            options.search.thresholds = parse_sizes(arg.substr(13));
+        }
+        else if (arg.starts_with("--capacities="))
+        {
+            options.search.slab_capacities = parse_sizes(arg.substr(13));
+        }
+        else if (arg.starts_with("--refill-cost="))
+        {
+            options.search.refill_cost = std::strtod(argv[i] + 14, nullptr);
+        }
+        else if (!arg.starts_with("--") && options.input.empty())
+        {
+            options.input = arg;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    const std::size_t alignment = options.search.alignment;
+
+    return !options.input.empty() && alignment > 0 && (alignment & (alignment - 1)) == 0 && options.search.max_classes > 0;
+}
+
+void emit_header(std::FILE* file, const options& options, const size_profile& profile, const size_class_configuration& configuration)
+{
+    std::fprintf(file, "#pragma once\n\n");
+    std::fprintf(file, "// generated by sizeclass from %s, %llu allocations\n", options.input.c_str(), static_cast<unsigned long long>(profile.get_allocation_count()));
+    std::fprintf(file, "// expected at peak: %.0f wasted bytes, %.0f refills\n\n", configuration.wasted_bytes, configuration.refills);
+
+    std::fprintf(file, "#include <coal/free_list_allocator.hpp>\n");
+    std::fprintf(file, "#include <coal/free_list_strategy/best_fit.hpp>\n");
+    std::fprintf(file, "#include <coal/free_list_strategy/limited_size.hpp>\n");
+    std::fprintf(file, "#include <coal/malloc_allocator.hpp>\n");
+    std::fprintf(file, "#include <coal/prefixed_size_allocator.hpp>\n");
+    std::fprintf(file, "#include <coal/segregator_allocator.hpp>\n");
+    std::fprintf(file, "#include <coal/slab_allocator.hpp>\n\n");
+
+    std::fprintf(file, "using %s = coal::segregator_allocator<\n", options.name.c_str());
+    std::fprintf(file, "    coal::slab_allocator<coal::malloc_allocator, 0x%zx", configuration.slab_capacity);
+
+    for (std::size_t size : configuration.size_classes)
+    {
+        std::fprintf(file, ", %zu", size);
+    }
+
+    std::fprintf(file, ">,\n");
+    std::fprintf(file, "    coal::free_list_allocator<coal::prefixed_size_allocator<coal::malloc_allocator>, coal::free_list_strategy::limited_size<coal::free_list_strategy::best_fit, %zu>>,\n", configuration.large_cache_size);
+    std::fprintf(file, "    %zu>;\n", configuration.threshold);
+}
+
+} // namespace coal::tools
+
+int main(int argc, char** argv)
+{
+    coal::tools::options options;
+
+    if (!coal::tools::parse_arguments(options, argc, argv))
+    {
+        std::fprintf(stderr,
+                     "usage: %s <trace|histogram> [--histogram] [--output=file] [--name=allocator_t]\n"
+                     "          [--alignment=N] [--max-classes=N] [--thresholds=a,b,...] [--capacities=a,b,...] [--refill-cost=bytes]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::FILE* input = std::fopen(options.input.c_str(), options.format == coal::tools::input_format::trace ? "rb" : "r");
+    coal::tools::size_profile profile;
+
+    const bool read = options.format == coal::tools::input_format::trace ? profile.load_trace(input) : profile.load_histogram(input);
+
+    if (input != nullptr)
+    {
+        std::fclose(input);
+    }
+
+    if (!read)
+    {
+        std::fprintf(stderr, "cannot read profile %s\n", options.input.c_str());
+        return EXIT_FAILURE;
+    }
+
+    const coal::tools::size_class_configuration configuration = coal::tools::search_size_classes(profile, options.search);
+
+    if (configuration.size_classes.empty())
+    {
+        std::fprintf(stderr, "no configuration fits the thresholds and capacities\n");
+        return EXIT_FAILURE;
+    }
+
+    std::FILE* output = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "w");
+
+    if (output == nullptr)
+    {
+        std::fprintf(stderr, "cannot open %s\n", options.output.c_str());
+        return EXIT_FAILURE;
+    }
+
+    coal::tools::emit_header(output, options, profile, configuration);
+
+    if (output != stdout)
+    {
+        std::fclose(output);
+    }
+
+    return EXIT_SUCCESS;
+}
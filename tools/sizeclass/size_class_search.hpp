@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <coal/alignment.hpp>
+
+#include <sizeclass/size_profile.hpp>
+
+namespace coal::tools {
+
+struct search_options
+{
+    // alignment of the leaf allocator, every size class and the threshold are multiples of it
+    std::size_t alignment{default_alignment};
+    std::size_t max_classes{16};
+
+    std::vector<std::size_t> thresholds{64, 128, 256, 512, 1024, 2048, 4096};
+    std::vector<std::size_t> slab_capacities{0x1000, 0x4000, 0x10000, 0x40000};
+
+    // price of one call to the leaf allocator, in wasted bytes
+    double refill_cost{256.0};
+
+    // bookkeeping of the leaf allocator for each large object, the size prefix excluded
+    std::size_t leaf_overhead{16};
+
+    // upper bound of the free nodes kept by the large free list
+    std::size_t max_large_cache_size{1024};
+};
+
+// A segregator between a slab allocator and a size prefixed free list, with its expected cost at peak.
+struct size_class_configuration
+{
+    std::vector<std::size_t> size_classes;
+    std::size_t slab_capacity{0};
+    std::size_t threshold{0};
+    std::size_t large_cache_size{0};
+
+    // rounding to size classes, slab space not holding objects at peak and per object overhead of large objects
+    double wasted_bytes{0.0};
+
+    // slabs to allocate to hold the peak plus large objects not served from the free list
+    double refills{0.0};
+
+    double cost{std::numeric_limits<double>::infinity()};
+};
+
+namespace details {
+
+// Weighted sizes served by the slab allocator, in ascending order. Prefix sums give the rounding waste of any
+// range of sizes in constant time.
+class small_size_table
+{
+public:
+    small_size_table(const std::vector<size_profile_entry>& entries, std::size_t threshold, std::size_t alignment);
+
+    [[nodiscard]] std::size_t get_size_count() const;
+    [[nodiscard]] std::size_t get_size(std::size_t index) const;
+
+    // bytes lost rounding the sizes in [first, last) up to the size at last - 1
+    [[nodiscard]] double get_rounding_waste(std::size_t first, std::size_t last) const;
+    [[nodiscard]] double get_weight(std::size_t first, std::size_t last) const;
+
+private:
+    std::vector<std::size_t> _sizes;
+    std::vector<double> _weights;
+    std::vector<double> _bytes;
+};
+
+inline small_size_table::small_size_table(const std::vector<size_profile_entry>& entries, std::size_t threshold, std::size_t alignment)
+    : _weights{0.0}
+    , _bytes{0.0}
+{
+    const std::size_t min_size = align_up(sizeof(void*), alignment);
+
+    for (const size_profile_entry& entry : entries)
+    {
+        if (entry.size > threshold)
+        {
+            break;
+        }
+
+        const std::size_t size = std::max(align_up(entry.size, alignment), min_size);
+        const double weight = static_cast<double>(entry.get_weight());
+
+        // sizes below the aligned size are wasted whatever the classes, only the rounding between classes counts
+        if (_sizes.empty() || _sizes.back() != size)
+        {
+            _sizes.push_back(size);
+            _weights.push_back(_weights.back());
+            _bytes.push_back(_bytes.back());
+        }
+
+        _weights.back() += weight;
+        _bytes.back() += weight * static_cast<double>(size);
+    }
+
+    // the largest class is the threshold so the slab allocator serves every size the segregator hands it
+    if (_sizes.empty() || _sizes.back() != threshold)
+    {
+        _sizes.push_back(threshold);
+        _weights.push_back(_weights.back());
+        _bytes.push_back(_bytes.back());
+    }
+}
+
+inline std::size_t small_size_table::get_size_count() const
+{
+    return _sizes.size();
+}
+
+inline std::size_t small_size_table::get_size(std::size_t index) const
+{
+    return _sizes[index];
+}
+
+inline double small_size_table::get_rounding_waste(std::size_t first, std::size_t last) const
+{
+    return get_weight(first, last) * static_cast<double>(_sizes[last - 1]) - (_bytes[last] - _bytes[first]);
+}
+
+inline double small_size_table::get_weight(std::size_t first, std::size_t last) const
+{
+    return _weights[last] - _weights[first];
+}
+
+// Classes made of the ends of the ranges [ends[i - 1], ends[i]), the last range ends at the threshold.
+inline std::vector<std::vector<std::size_t>> partition_sizes(const small_size_table& table, std::size_t max_classes)
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    const std::size_t size_count = table.get_size_count();
+    const std::size_t class_count = std::min(max_classes, size_count);
+
+    // waste[k][j] is the lowest rounding waste of the first j sizes with k classes, the last class ending at j
+    std::vector<std::vector<double>> waste(class_count + 1, std::vector<double>(size_count + 1, infinity));
+    std::vector<std::vector<std::size_t>> split(class_count + 1, std::vector<std::size_t>(size_count + 1, 0));
+
+    waste[0][0] = 0.0;
+
+    for (std::size_t k = 1; k <= class_count; ++k)
+    {
+        for (std::size_t j = k; j <= size_count; ++j)
+        {
+            for (std::size_t i = k - 1; i < j; ++i)
+            {
+                const double candidate = waste[k - 1][i] + table.get_rounding_waste(i, j);
+
+                if (candidate < waste[k][j])
+                {
+                    waste[k][j] = candidate;
+                    split[k][j] = i;
+                }
+            }
+        }
+    }
+
+    // the best partition for each class count
+    std::vector<std::vector<std::size_t>> partitions;
+
+    for (std::size_t k = 1; k <= class_count; ++k)
+    {
+        std::vector<std::size_t> ends(k);
+
+        for (std::size_t j = size_count, c = k; c > 0; j = split[c][j], --c)
+        {
+            ends[c - 1] = j;
+        }
+
+        partitions.push_back(std::move(ends));
+    }
+
+    return partitions;
+}
+
+} // namespace details
+
+// Tries every threshold, class count and slab capacity and keeps the configuration of lowest cost, that is the
+// wasted bytes plus the refills priced by refill_cost.
+inline size_class_configuration search_size_classes(const size_profile& profile, const search_options& options)
+{
+    const std::vector<size_profile_entry> entries = profile.get_entries();
+    size_class_configuration best;
+
+    for (std::size_t threshold : options.thresholds)
+    {
+        if (threshold == 0 || align_up(threshold, options.alignment) != threshold)
+        {
+            continue;
+        }
+
+        // the large side: a size prefix and the leaf overhead per object, one refill per object alive at peak
+        double large_waste = 0.0;
+        double large_objects = 0.0;
+
+        for (const size_profile_entry& entry : entries)
+        {
+            if (entry.size > threshold)
+            {
+                const double weight = static_cast<double>(entry.get_weight());
+
+                large_waste += weight * static_cast<double>(align_up(sizeof(std::size_t), options.alignment) + options.leaf_overhead);
+                large_objects += weight;
+            }
+        }
+
+        const details::small_size_table table{entries, threshold, options.alignment};
+
+        for (const std::vector<std::size_t>& ends : details::partition_sizes(table, options.max_classes))
+        {
+            for (std::size_t capacity : options.slab_capacities)
+            {
+                if (capacity < threshold || align_up(capacity, options.alignment) != capacity)
+                {
+                    continue;
+                }
+
+                double small_waste = 0.0;
+                double small_refills = 0.0;
+
+                for (std::size_t c = 0, first = 0; c < ends.size(); first = ends[c++])
+                {
+                    const std::size_t size = table.get_size(ends[c] - 1);
+                    const double objects = table.get_weight(first, ends[c]);
+                    const double per_slab = static_cast<double>(capacity / size);
+
+                    // the last slab of a class is partly empty at peak, a class never used costs nothing
+                    const double slabs = std::ceil(objects / per_slab);
+
+                    small_waste += table.get_rounding_waste(first, ends[c]) + slabs * static_cast<double>(capacity) - objects * static_cast<double>(size);
+                    small_refills += slabs;
+                }
+
+                size_class_configuration candidate;
+                candidate.slab_capacity = capacity;
+                candidate.threshold = threshold;
+                candidate.large_cache_size = std::min(std::bit_ceil(std::max<std::size_t>(static_cast<std::size_t>(large_objects), 1)), options.max_large_cache_size);
+                candidate.wasted_bytes = small_waste + large_waste;
+                candidate.refills = small_refills + large_objects;
+                candidate.cost = candidate.wasted_bytes + options.refill_cost * candidate.refills;
+
+                if (candidate.cost < best.cost)
+                {
+                    for (std::size_t end : ends)
+                    {
+                        candidate.size_classes.push_back(table.get_size(end - 1));
+                    }
+
+                    best = std::move(candidate);
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+} // namespace coal::tools
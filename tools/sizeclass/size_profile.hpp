@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <coal/trace/trace_replayer.hpp>
+
+namespace coal::tools {
+
+struct size_profile_entry
+{
+    std::size_t size{0};
+    std::uint64_t count{0};
+
+    // highest number of objects of this size alive at the same time, 0 when unknown
+    std::uint64_t peak_live{0};
+
+    // weight used when counting wasted bytes: the objects held at peak when known, the allocations otherwise
+    [[nodiscard]] std::uint64_t get_weight() const;
+};
+
+inline std::uint64_t size_profile_entry::get_weight() const
+{
+    return peak_live ? peak_live : count;
+}
+
+// Allocation sizes with their count and peak live objects, built from a trace or from a histogram dump.
+class size_profile
+{
+public:
+    void add(std::size_t size, std::uint64_t count, std::uint64_t peak_live);
+
+    // binary trace written by coal::trace_recorder
+    bool load_trace(std::FILE* file);
+
+    // text lines "size count [peak_live]", lines starting with # are ignored
+    bool load_histogram(std::FILE* file);
+
+    [[nodiscard]] std::vector<size_profile_entry> get_entries() const;
+    [[nodiscard]] std::uint64_t get_allocation_count() const;
+
+private:
+    std::map<std::size_t, size_profile_entry> _entries;
+};
+
+inline void size_profile::add(std::size_t size, std::uint64_t count, std::uint64_t peak_live)
+{
+    if (size == 0 || count == 0)
+    {
+        return;
+    }
+
+    size_profile_entry& entry = _entries[size];
+    entry.size = size;
+    entry.count += count;
+    entry.peak_live = std::max(entry.peak_live, peak_live);
+}
+
+inline bool size_profile::load_trace(std::FILE* file)
+{
+    std::vector<trace_event> events;
+
+    if (!read_trace(file, events))
+    {
+        return false;
+    }
+
+    struct size_state
+    {
+        std::uint64_t count{0};
+        std::uint64_t live{0};
+        std::uint64_t peak_live{0};
+    };
+
+    std::unordered_map<std::size_t, size_state> states;
+    std::vector<std::size_t> object_sizes;
+
+    const auto allocate = [&](std::uint64_t object_id, std::size_t size) {
+        if (object_id >= object_sizes.size())
+        {
+            object_sizes.resize(object_id + 1);
+        }
+
+        object_sizes[object_id] = size;
+
+        size_state& state = states[size];
+        ++state.count;
+        state.peak_live = std::max(state.peak_live, ++state.live);
+    };
+
+    const auto deallocate = [&](std::uint64_t object_id) {
+        if (object_id < object_sizes.size() && object_sizes[object_id] != 0)
+        {
+            --states[object_sizes[object_id]].live;
+            object_sizes[object_id] = 0;
+        }
+    };
+
+    for (const trace_event& event : events)
+    {
+        switch (event.type)
+        {
+        case trace_event_type::allocate:
+            if (event.success && event.size)
+            {
+                allocate(event.object_id, event.size);
+            }
+            break;
+
+        case trace_event_type::deallocate:
+            deallocate(event.object_id);
+            break;
+
+        case trace_event_type::reallocate:
+        case trace_event_type::expand:
+            if (event.success)
+            {
+                // a resize is profiled as a new object of the new size
+                const std::uint64_t new_size = event.type == trace_event_type::reallocate ? event.argument : event.size + event.argument;
+
+                deallocate(event.object_id);
+
+                if (new_size)
+                {
+                    allocate(event.object_id, new_size);
+                }
+            }
+            break;
+
+        case trace_event_type::deallocate_all:
+            object_sizes.clear();
+
+            for (auto& [size, state] : states)
+            {
+                state.live = 0;
+            }
+            break;
+        }
+    }
+
+    for (const auto& [size, state] : states)
+    {
+        add(size, state.count, state.peak_live);
+    }
+
+    return true;
+}
+
+inline bool size_profile::load_histogram(std::FILE* file)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    char line[256];
+
+    while (std::fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+
+        unsigned long long size = 0;
+        unsigned long long count = 0;
+        unsigned long long peak_live = 0;
+
+        if (std::sscanf(line, "%llu %llu %llu", &size, &count, &peak_live) < 2)
+        {
+            return false;
+        }
+
+        add(size, count, peak_live);
+    }
+
+    return std::feof(file) != 0;
+}
+
+inline std::vector<size_profile_entry> size_profile::get_entries() const
+{
+    std::vector<size_profile_entry> entries;
+    entries.reserve(_entries.size());
+
+    for (const auto& [size, entry] : _entries)
+    {
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+inline std::uint64_t size_profile::get_allocation_count() const
+{
+    std::uint64_t count = 0;
+
+    for (const auto& [size, entry] : _entries)
+    {
+        count += entry.count;
+    }
+
+    return count;
+}
+
+} // namespace coal::tools
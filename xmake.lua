@@ -19,5 +19,34 @@ target("test")
 
     add_packages("catch2")
 
-    add_includedirs("include", "tests")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+    add_includedirs("include", "tests", "tools")
     add_files("tests/**.cpp")
+
+target("bench")
+    set_default(false)
+    set_kind("binary")
+
+    add_includedirs("include", "bench")
+    add_files("bench/**.cpp")
+
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+target("replay")
+    set_default(false)
+    set_kind("binary")
+
+    add_includedirs("include", "tools")
+    add_files("tools/replay/**.cpp")
+
+target("sizeclass")
+    set_default(false)
+    set_kind("binary")
+
+    add_includedirs("include", "tools")
+    add_files("tools/sizeclass/**.cpp")